@@ -0,0 +1,5 @@
+# PlatformIO pre-script for [env:bench]: adds the benchmark firmware in
+# bench/firmware in place of main.cpp.
+Import("env")
+
+env.BuildSources("$BUILD_DIR/bench", "$PROJECT_DIR/bench/firmware")
@@ -0,0 +1,32 @@
+#!/usr/bin/env python3
+"""Compares two benchmark reports marker by marker.
+
+Usage: bench/compare.py bench/reports/<old>.json bench/reports/<new>.json
+"""
+
+import json
+import sys
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit(__doc__.strip())
+    with open(sys.argv[1]) as f:
+        old = json.load(f)
+    with open(sys.argv[2]) as f:
+        new = json.load(f)
+
+    print("%-16s %12s %12s %8s %12s %12s" % ("marker", old["label"] or "old",
+          new["label"] or "new", "mean", "old self", "new self"))
+    for name, after in new["markers"].items():
+        before = old["markers"].get(name)
+        if not before or not before["count"] or not after["count"]:
+            continue
+        change = 100.0 * (after["mean"] - before["mean"]) / before["mean"] if before["mean"] else 0.0
+        print("%-16s %12d %12d %+7.1f%% %12d %12d" % (
+            name, before["mean"], after["mean"], change,
+            before["self"] // before["count"], after["self"] // after["count"]))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,252 @@
+// Benchmark firmware: the full system plus a few serial commands that drive
+// the instrumented paths, for cycle counting under simavr (see ../README).
+//
+//   fs <n>        n rounds of create, append, write, read, open and delete
+//   flush <n>     n full redraws of the system info screen
+//   sh <line>     runs one shell command line
+//   hog <ms>      starts a task that busy-waits ms per run, and a thread
+//                 that takes over reading the input queue
+//   latency       events read by that thread and the worst edge-to-read
+//                 wait in ms; "ok" while it is within a scheduler tick
+//   i2c           bus scan; with ENABLE_ASYNC_TWI it runs from the interrupt
+//   twi           async driver bytes, transfers, errors and utilization
+//
+// Built by [env:bench] with ENABLE_BENCH so the markers in minux_bench.h are
+// live. Serial is not echoed, so shell output goes to the display only.
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "minux_config.h"
+#include "minux_kernel.h"
+#include "minux_display.h"
+#include "minux_input.h"
+#include "minux_scheduler.h"
+#include "minux_fs.h"
+#include "minux_shell.h"
+#include "minux_timer.h"
+#include "minux_sound.h"
+#include "minux_line.h"
+#include "minux_command.h"
+#include "minux_syscmd.h"
+#include "minux_bench.h"
+
+#if !ENABLE_BENCH
+#error "bench firmware needs ENABLE_BENCH"
+#endif
+
+// MightyCore standard pinout: buttons on PB0-PB3, buzzer on PD4. The Nano's
+// D8 and D9 would land on UART0 here.
+#define BENCH_BTN_A      0
+#define BENCH_BTN_UP     1
+#define BENCH_BTN_DOWN   2
+#define BENCH_BTN_RIGHT  3
+#define BENCH_BUZZER     12
+
+#if DISPLAY_PAGE_MODE
+DisplayList display;
+#else
+Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET);
+#endif
+MinuxTimers timers;
+MinuxKernel kernel;
+MinuxInput input;
+MinuxSound sound;
+MinuxDisplay ui(&display);
+MinuxScheduler scheduler;
+MinuxFS filesystem;
+MinuxShell shell;
+
+MinuxLine benchLine;
+
+// Stand-ins for the system processes, so dispatch has a realistic mix
+static void uiTask() {
+  ui.update();
+}
+
+static void inputTask() {
+  InputRecord events[INPUT_QUEUE_SIZE];
+  input.read(events, INPUT_QUEUE_SIZE);
+}
+
+static void idleTask() {
+}
+
+// Input latency under load. The hog never yields; without preemption the
+// wait for an input edge would be as long as the hog's run.
+#define LATENCY_BOUND_MS (SCHEDULER_TICK_MS + 2)    // Plus millis() granularity
+
+static uint16_t hogMs;
+static volatile uint16_t latencyEvents;
+static volatile unsigned long latencyWorst;
+
+static void hogTask() {
+  unsigned long start = millis();
+  while (millis() - start < hogMs) {
+  }
+}
+
+static void latencyThread() {
+  InputRecord events[INPUT_QUEUE_SIZE];
+  uint8_t n = input.read(events, INPUT_QUEUE_SIZE);
+  unsigned long now = millis();
+  for (uint8_t i = 0; i < n; i++) {
+    unsigned long waited = now - events[i].timestamp;
+    if (waited > latencyWorst) latencyWorst = waited;
+    latencyEvents++;
+  }
+}
+
+static void benchFlush(uint8_t argc, char** argv) {
+  uint16_t rounds = argc > 1 ? atoi(argv[1]) : 1;
+  for (uint16_t i = 0; i < rounds; i++) {
+    ui.showSystemInfo();
+    ui.flush();
+  }
+  ui.setTerminalMode();
+  Serial.println("ok");
+}
+
+static void benchFs(uint8_t argc, char** argv) {
+  uint16_t rounds = argc > 1 ? atoi(argv[1]) : 1;
+  uint8_t data[32];
+  for (uint8_t i = 0; i < sizeof(data); i++) data[i] = i;
+  
+  uint16_t failures = 0;
+  for (uint16_t i = 0; i < rounds; i++) {
+    if (!filesystem.createFile("bench.tmp", data, sizeof(data))) failures++;
+    if (!filesystem.appendFile("bench.tmp", data, sizeof(data))) failures++;
+    if (!filesystem.writeFile("bench.tmp", data, sizeof(data))) failures++;
+    if (filesystem.readFile("bench.tmp", data, sizeof(data)) != sizeof(data)) failures++;
+    if (!filesystem.openFile("bench.tmp")) failures++;
+    if (!filesystem.deleteFile("bench.tmp")) failures++;
+  }
+  Serial.print("ok ");
+  Serial.println(failures);
+}
+
+// Name lookups with the table full: every file hit once, then as many misses
+static void benchOpen(uint8_t argc, char** argv) {
+  uint16_t rounds = argc > 1 ? atoi(argv[1]) : 1;
+  char name[MAX_FILENAME];
+  uint8_t created = 0;
+  while (filesystem.getFileCount() < MAX_FILES) {
+    sprintf(name, "f%u.txt", created++);
+    if (!filesystem.createFile(name, nullptr, 0)) break;
+  }
+  
+  uint16_t failures = 0;
+  for (uint16_t i = 0; i < rounds; i++) {
+    for (uint8_t f = 0; f < created; f++) {
+      sprintf(name, "f%u.txt", f);
+      if (!filesystem.openFile(name)) failures++;
+      sprintf(name, "g%u.txt", f);
+      if (filesystem.openFile(name)) failures++;
+    }
+  }
+  
+  for (uint8_t f = 0; f < created; f++) {
+    sprintf(name, "f%u.txt", f);
+    filesystem.deleteFile(name);
+  }
+  Serial.print("ok ");
+  Serial.println(failures);
+}
+
+static void benchShell(uint8_t argc, char** argv) {
+  if (argc > 1) shell.executeCommand(argv[1]);
+  Serial.println("ok");
+}
+
+static void benchHog(uint8_t argc, char** argv) {
+  static bool started = false;
+  hogMs = argc > 1 ? atoi(argv[1]) : 50;
+  if (!started) {
+    // The queue has a single consumer, so the input task has to go
+    scheduler.stopProcess("input");
+    started = scheduler.startProcess("hog", hogTask, 0, 1) &&
+              scheduler.startThread("latency", latencyThread, 0, 1);
+  }
+  Serial.println(started ? "ok" : "failed");
+}
+
+static void benchLatency(uint8_t, char**) {
+  noInterrupts();
+  uint16_t events = latencyEvents;
+  unsigned long worst = latencyWorst;
+  interrupts();
+  
+  Serial.print(events && worst <= LATENCY_BOUND_MS ? "ok " : "slow ");
+  Serial.print(events);
+  Serial.print(' ');
+  Serial.println(worst);
+}
+
+static void benchTwi(uint8_t, char**) {
+#if ENABLE_ASYNC_TWI
+  Serial.print("ok ");
+  Serial.print(twi.getByteCount());
+  Serial.print(' ');
+  Serial.print(twi.getTransferCount());
+  Serial.print(' ');
+  Serial.print(twi.getErrorCount());
+  Serial.print(' ');
+  Serial.println(twi.getUtilization());
+  twi.resetStats();
+#else
+  Serial.println("needs ENABLE_ASYNC_TWI");
+#endif
+}
+
+static constexpr Command benchCommands[] PROGMEM = {
+  { "flush",   "Redraw and flush n times",    benchFlush },
+  { "fs",      "n rounds of file ops",        benchFs },
+  { "hog",     "Busy task plus input thread", benchHog },
+  COMMAND_I2C,
+  { "latency", "Worst input wait in ms",      benchLatency },
+  { "open",    "n rounds of name lookups",    benchOpen },
+  { "sh",      "Run a shell command",         benchShell },
+  { "twi",     "Async TWI statistics",        benchTwi },
+};
+COMMAND_TABLE_CHECK(benchCommands);
+
+void setup() {
+  Serial.begin(115200);
+  
+  timers.init();
+  kernel.init();
+#if DISPLAY_PAGE_MODE
+  display.begin(SCREEN_ADDRESS);
+#else
+  display.begin(SSD1306_SWITCHCAPVCC, SCREEN_ADDRESS);
+#endif
+  ui.init();
+  ui.setTerminalMode();
+  
+  input.init(BENCH_BTN_A, BENCH_BTN_UP, BENCH_BTN_DOWN, BENCH_BTN_RIGHT, BENCH_BUZZER);
+  sound.init(BENCH_BUZZER);
+  scheduler.init();
+  filesystem.init();
+  shell.activate();
+  
+  scheduler.startProcess("input", inputTask, INPUT_DEBOUNCE_MS, 3);
+  scheduler.startProcess("ui", uiTask, UI_UPDATE_MS, 2);
+  scheduler.startProcess("idle", idleTask, FS_MAINTENANCE_MS, 0);
+  
+  Serial.println("bench ready");
+}
+
+void loop() {
+  while (benchLine.poll(Serial)) {
+    // Two slots: the command word and the untouched rest of the line
+    char* argv[2];
+    uint8_t argc = benchLine.parse(argv, 2);
+    if (argc == 0) continue;
+    if (!runCommand(benchCommands, COMMAND_COUNT(benchCommands), argc, argv)) {
+      Serial.print("unknown ");
+      Serial.println(argv[0]);
+    }
+  }
+  
+  scheduler.tick();
+  kernel.idle();
+}
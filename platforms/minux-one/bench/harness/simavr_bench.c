@@ -0,0 +1,308 @@
+// Runs the benchmark firmware under simavr and reports cycle counts between
+// the GPIOR0 markers of minux_bench.h as JSON.
+//
+//   simavr_bench [-m mcu] [-f hz] [-l label] [-o report.json] [-v] firmware.elf script.txt
+//
+// Script lines (# starts a comment):
+//   wait <ms>               run for ms of simulated time
+//   serial <text>           send text plus newline to UART0, paced by the UART's flow control
+//   expect <text> [ms]      run until UART0 has printed text, default timeout 5000 ms
+//   pin <Pxn> <0|1>         drive a port pin, e.g. pin PD2 0
+//   press <Pxn> [ms]        pull a pin low for ms (default 100), then release it
+//   clear                   drop the samples taken so far, e.g. after boot
+//
+// Every marker gets count, min, max, mean and total inclusive cycles, and
+// self cycles with nested markers subtracted. Exit status is 0 when the
+// script ran through, 1 on a failed expect or a crash, 2 on bad usage.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "sim_avr.h"
+#include "sim_elf.h"
+#include "sim_irq.h"
+#include "avr_ioport.h"
+#include "avr_uart.h"
+#include "avr_twi.h"
+
+#include "minux_bench.h"
+
+#define GPIOR0_ADDR   0x3E     // Data space address, same on the 328P and 1284P
+#define PANEL_ADDR    0x3C     // SSD1306, acknowledged but not modelled
+#define MAX_NESTING   16
+#define INPUT_MAX     4096
+#define OUTPUT_MAX    65536
+
+#define BENCH_NAME(id, name) name,
+static const char* const markerNames[BENCH_COUNT] = { "", BENCH_MARKERS(BENCH_NAME) };
+
+typedef struct {
+  uint64_t count, min, max, total, self;
+} MarkerStats;
+
+typedef struct {
+  uint8_t id;
+  avr_cycle_count_t start;
+  avr_cycle_count_t nested;    // Inclusive cycles of markers closed inside this one
+} OpenMarker;
+
+static avr_t* avr;
+static MarkerStats stats[BENCH_COUNT];
+static OpenMarker openMarkers[MAX_NESTING];
+static uint8_t depth;
+static uint32_t unbalanced;
+
+static char input[INPUT_MAX];
+static size_t inputHead, inputTail;
+static int xon = 1;
+static avr_irq_t* uartIn;
+
+static char output[OUTPUT_MAX];
+static size_t outputLength, expectFrom;
+static int verbose;
+
+static avr_irq_t* twiIn;
+static int panelSelected;
+static uint64_t twiBytes;
+
+static void markerWrite(avr_t* a, avr_io_addr_t addr, uint8_t v, void* param) {
+  uint8_t id = v >> 1;
+  if (id == BENCH_NONE || id >= BENCH_COUNT) return;
+  
+  if ((v & 1) == BENCH_BEGIN_EDGE) {
+    if (depth == MAX_NESTING) {
+      unbalanced++;
+      return;
+    }
+    openMarkers[depth].id = id;
+    openMarkers[depth].start = a->cycle;
+    openMarkers[depth].nested = 0;
+    depth++;
+    return;
+  }
+  
+  // An end without its begin (e.g. sampling cleared mid-call) is counted and skipped
+  if (depth == 0 || openMarkers[depth - 1].id != id) {
+    unbalanced++;
+    return;
+  }
+  depth--;
+  avr_cycle_count_t inclusive = a->cycle - openMarkers[depth].start;
+  MarkerStats* s = &stats[id];
+  if (s->count == 0 || inclusive < s->min) s->min = inclusive;
+  if (inclusive > s->max) s->max = inclusive;
+  s->count++;
+  s->total += inclusive;
+  s->self += inclusive - openMarkers[depth].nested;
+  if (depth > 0) openMarkers[depth - 1].nested += inclusive;
+}
+
+static void uartOutput(avr_irq_t* irq, uint32_t value, void* param) {
+  if (outputLength < OUTPUT_MAX - 1) output[outputLength++] = (char)value;
+  output[outputLength] = '\0';
+  if (verbose) fputc((int)value, stderr);
+}
+
+static void uartXon(avr_irq_t* irq, uint32_t value, void* param) { xon = 1; }
+static void uartXoff(avr_irq_t* irq, uint32_t value, void* param) { xon = 0; }
+
+// Acknowledges everything sent to the panel address so the firmware's
+// transfers take their real time on the bus
+static void twiOutput(avr_irq_t* irq, uint32_t value, void* param) {
+  avr_twi_msg_irq_t v;
+  v.u.v = value;
+  
+  if (v.u.twi.msg & TWI_COND_STOP) panelSelected = 0;
+  if (v.u.twi.msg & TWI_COND_START) {
+    panelSelected = (v.u.twi.addr >> 1) == PANEL_ADDR;
+    if (panelSelected) avr_raise_irq(twiIn, avr_twi_irq_msg(TWI_COND_ACK, v.u.twi.addr, 1));
+  }
+  if (panelSelected && (v.u.twi.msg & TWI_COND_WRITE)) {
+    twiBytes++;
+    avr_raise_irq(twiIn, avr_twi_irq_msg(TWI_COND_ACK, v.u.twi.addr, 1));
+  }
+}
+
+// Runs until the cycle counter reaches until; false if the core stopped
+static int runTo(avr_cycle_count_t until) {
+  while (avr->cycle < until) {
+    if (xon && inputHead != inputTail) {
+      avr_raise_irq(uartIn, (uint8_t)input[inputHead]);
+      inputHead = (inputHead + 1) % INPUT_MAX;
+    }
+    int state = avr_run(avr);
+    if (state == cpu_Done || state == cpu_Crashed) return 0;
+  }
+  return 1;
+}
+
+static avr_cycle_count_t msToCycles(unsigned long ms) {
+  return (avr_cycle_count_t)ms * (avr->frequency / 1000);
+}
+
+static void queueInput(const char* text) {
+  for (; *text; text++) {
+    size_t next = (inputTail + 1) % INPUT_MAX;
+    if (next == inputHead) break;
+    input[inputTail] = *text;
+    inputTail = next;
+  }
+}
+
+static avr_irq_t* pinIrq(const char* name) {
+  if (!name || strlen(name) != 3 || name[0] != 'P' || name[2] < '0' || name[2] > '7') return NULL;
+  return avr_io_getirq(avr, AVR_IOCTL_IOPORT_GETIRQ(name[1]), name[2] - '0');
+}
+
+static int runScript(FILE* script) {
+  char line[256];
+  while (fgets(line, sizeof(line), script)) {
+    line[strcspn(line, "\r\n")] = '\0';
+    char* cmd = strtok(line, " \t");
+    if (!cmd || cmd[0] == '#') continue;
+    char* rest = strtok(NULL, "");
+    if (rest) rest += strspn(rest, " \t");
+    
+    if (!strcmp(cmd, "wait")) {
+      if (!runTo(avr->cycle + msToCycles(rest ? strtoul(rest, NULL, 10) : 0))) return 0;
+    } else if (!strcmp(cmd, "serial")) {
+      queueInput(rest ? rest : "");
+      queueInput("\n");
+    } else if (!strcmp(cmd, "expect")) {
+      // Optional trailing timeout in ms
+      unsigned long timeout = 5000;
+      char* last = rest ? strrchr(rest, ' ') : NULL;
+      if (last && last[1] && strspn(last + 1, "0123456789") == strlen(last + 1)) {
+        timeout = strtoul(last + 1, NULL, 10);
+        *last = '\0';
+      }
+      avr_cycle_count_t deadline = avr->cycle + msToCycles(timeout);
+      const char* hit = NULL;
+      while (!(hit = strstr(output + expectFrom, rest ? rest : ""))) {
+        if (avr->cycle >= deadline || !runTo(avr->cycle + msToCycles(1))) {
+          fprintf(stderr, "bench: expected '%s'\n", rest ? rest : "");
+          return 0;
+        }
+      }
+      expectFrom = hit - output + strlen(rest ? rest : "");
+    } else if (!strcmp(cmd, "pin") || !strcmp(cmd, "press")) {
+      char* name = rest ? strtok(rest, " \t") : NULL;
+      char* arg = strtok(NULL, " \t");
+      avr_irq_t* irq = pinIrq(name);
+      if (!irq) {
+        fprintf(stderr, "bench: bad pin '%s'\n", name ? name : "");
+        return 0;
+      }
+      if (!strcmp(cmd, "pin")) {
+        avr_raise_irq(irq, arg ? atoi(arg) != 0 : 0);
+      } else {
+        avr_raise_irq(irq, 0);
+        if (!runTo(avr->cycle + msToCycles(arg ? strtoul(arg, NULL, 10) : 100))) return 0;
+        avr_raise_irq(irq, 1);
+      }
+    } else if (!strcmp(cmd, "clear")) {
+      memset(stats, 0, sizeof(stats));
+      depth = 0;
+      unbalanced = 0;
+    } else {
+      fprintf(stderr, "bench: unknown command '%s'\n", cmd);
+      return 0;
+    }
+  }
+  return 1;
+}
+
+static void writeReport(FILE* out, const char* mcu, const char* firmware, const char* label) {
+  fprintf(out, "{\n");
+  fprintf(out, "  \"label\": \"%s\",\n", label);
+  fprintf(out, "  \"firmware\": \"%s\",\n", firmware);
+  fprintf(out, "  \"mcu\": \"%s\",\n", mcu);
+  fprintf(out, "  \"f_cpu\": %lu,\n", (unsigned long)avr->frequency);
+  fprintf(out, "  \"cycles\": %llu,\n", (unsigned long long)avr->cycle);
+  fprintf(out, "  \"twi_bytes\": %llu,\n", (unsigned long long)twiBytes);
+  fprintf(out, "  \"unbalanced\": %lu,\n", (unsigned long)unbalanced);
+  fprintf(out, "  \"markers\": {\n");
+  for (int id = 1; id < BENCH_COUNT; id++) {
+    MarkerStats* s = &stats[id];
+    fprintf(out, "    \"%s\": { \"count\": %llu, \"min\": %llu, \"max\": %llu, "
+                 "\"mean\": %llu, \"total\": %llu, \"self\": %llu }%s\n",
+            markerNames[id], (unsigned long long)s->count, (unsigned long long)s->min,
+            (unsigned long long)s->max, (unsigned long long)(s->count ? s->total / s->count : 0),
+            (unsigned long long)s->total, (unsigned long long)s->self,
+            id + 1 < BENCH_COUNT ? "," : "");
+  }
+  fprintf(out, "  }\n}\n");
+}
+
+int main(int argc, char** argv) {
+  const char* mcu = "atmega1284p";
+  const char* label = "";
+  const char* reportPath = NULL;
+  unsigned long frequency = 16000000;
+  int opt;
+  
+  while ((opt = getopt(argc, argv, "m:f:l:o:v")) != -1) {
+    switch (opt) {
+      case 'm': mcu = optarg; break;
+      case 'f': frequency = strtoul(optarg, NULL, 10); break;
+      case 'l': label = optarg; break;
+      case 'o': reportPath = optarg; break;
+      case 'v': verbose = 1; break;
+      default: return 2;
+    }
+  }
+  if (argc - optind != 2) {
+    fprintf(stderr, "usage: %s [-m mcu] [-f hz] [-l label] [-o report.json] [-v] firmware.elf script.txt\n", argv[0]);
+    return 2;
+  }
+  
+  elf_firmware_t firmware;
+  memset(&firmware, 0, sizeof(firmware));
+  if (elf_read_firmware(argv[optind], &firmware) != 0) {
+    fprintf(stderr, "bench: cannot load %s\n", argv[optind]);
+    return 2;
+  }
+  FILE* script = fopen(argv[optind + 1], "r");
+  if (!script) {
+    fprintf(stderr, "bench: cannot open %s\n", argv[optind + 1]);
+    return 2;
+  }
+  
+  avr = avr_make_mcu_by_name(mcu);
+  if (!avr) {
+    fprintf(stderr, "bench: unknown mcu %s\n", mcu);
+    return 2;
+  }
+  avr_init(avr);
+  firmware.frequency = frequency;
+  avr_load_firmware(avr, &firmware);
+  
+  avr_register_io_write(avr, GPIOR0_ADDR, markerWrite, NULL);
+  
+  // UART0: keep output off stdout, pace input by XON/XOFF
+  uint32_t flags = 0;
+  avr_ioctl(avr, AVR_IOCTL_UART_GET_FLAGS('0'), &flags);
+  flags &= ~AVR_UART_FLAG_STDIO;
+  avr_ioctl(avr, AVR_IOCTL_UART_SET_FLAGS('0'), &flags);
+  uartIn = avr_io_getirq(avr, AVR_IOCTL_UART_GETIRQ('0'), UART_IRQ_INPUT);
+  avr_irq_register_notify(avr_io_getirq(avr, AVR_IOCTL_UART_GETIRQ('0'), UART_IRQ_OUTPUT), uartOutput, NULL);
+  avr_irq_register_notify(avr_io_getirq(avr, AVR_IOCTL_UART_GETIRQ('0'), UART_IRQ_OUT_XON), uartXon, NULL);
+  avr_irq_register_notify(avr_io_getirq(avr, AVR_IOCTL_UART_GETIRQ('0'), UART_IRQ_OUT_XOFF), uartXoff, NULL);
+  
+  twiIn = avr_io_getirq(avr, AVR_IOCTL_TWI_GETIRQ(0), TWI_IRQ_INPUT);
+  avr_irq_register_notify(avr_io_getirq(avr, AVR_IOCTL_TWI_GETIRQ(0), TWI_IRQ_OUTPUT), twiOutput, NULL);
+  
+  int ok = runScript(script);
+  fclose(script);
+  
+  FILE* out = reportPath ? fopen(reportPath, "w") : stdout;
+  if (!out) {
+    fprintf(stderr, "bench: cannot write %s\n", reportPath);
+    return 2;
+  }
+  writeReport(out, mcu, argv[optind], label);
+  if (out != stdout) fclose(out);
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,109 @@
+// Host benchmark for command lookup: binary search of a sorted Command table
+// against the strcmp if/else chains it replaced, for the shell's and the
+// serial console's command sets as they were before the tables. Every name
+// is looked up once per round, plus as many misses.
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <chrono>
+#include "minux_command.h"
+
+static void handler(uint8_t, char**) {}
+
+// The old chains, in the order they compared
+static const char* const shellChain[] = {
+  "help", "ls", "ps", "clear", "uptime", "mem", "reboot", "version", "cat", "echo"
+};
+static const char* const serialChain[] = {
+  "help", "status", "ps", "top", "sched", "mem", "uptime", "desktop", "terminal",
+  "sysinfo", "files", "clear", "reboot", "version"
+};
+
+static constexpr Command shellTable[] PROGMEM = {
+  { "cat", "", handler }, { "clear", "", handler }, { "echo", "", handler },
+  { "help", "", handler }, { "ls", "", handler }, { "mem", "", handler },
+  { "ps", "", handler }, { "reboot", "", handler }, { "uptime", "", handler },
+  { "version", "", handler },
+};
+COMMAND_TABLE_CHECK(shellTable);
+
+static constexpr Command serialTable[] PROGMEM = {
+  { "clear", "", handler }, { "desktop", "", handler }, { "files", "", handler },
+  { "help", "", handler }, { "mem", "", handler }, { "ps", "", handler },
+  { "reboot", "", handler }, { "sched", "", handler }, { "status", "", handler },
+  { "sysinfo", "", handler }, { "terminal", "", handler }, { "top", "", handler },
+  { "uptime", "", handler }, { "version", "", handler },
+};
+COMMAND_TABLE_CHECK(serialTable);
+
+static int chainLookup(const char* const* chain, unsigned count, const char* name) {
+  for (unsigned i = 0; i < count; i++) {
+    if (strcmp(name, chain[i]) == 0) return i;
+  }
+  return -1;
+}
+
+static unsigned failures = 0;
+
+static double elapsedUs(std::chrono::steady_clock::time_point since) {
+  return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - since).count();
+}
+
+// Names are copied into writable buffers first, as the parser hands them out.
+// Misses differ from a real name in the last letter only.
+static void compare(const char* label, const char* const* chain, const Command* table,
+                    unsigned count, unsigned rounds) {
+  char hits[16][CMD_NAME_LEN];
+  char misses[16][CMD_NAME_LEN];
+  for (unsigned i = 0; i < count; i++) {
+    strcpy(hits[i], chain[i]);
+    strcpy(misses[i], chain[i]);
+    misses[i][strlen(misses[i]) - 1] = '~';   // Shares all but the last letter
+  }
+  
+  volatile long sink = 0;
+  auto t = std::chrono::steady_clock::now();
+  for (unsigned r = 0; r < rounds; r++) {
+    for (unsigned i = 0; i < count; i++) sink += chainLookup(chain, count, hits[i]);
+  }
+  double chainHit = elapsedUs(t);
+  t = std::chrono::steady_clock::now();
+  for (unsigned r = 0; r < rounds; r++) {
+    for (unsigned i = 0; i < count; i++) sink += chainLookup(chain, count, misses[i]);
+  }
+  double chainMiss = elapsedUs(t);
+  
+  t = std::chrono::steady_clock::now();
+  for (unsigned r = 0; r < rounds; r++) {
+    for (unsigned i = 0; i < count; i++) sink += (long)findCommand(table, count, hits[i]);
+  }
+  double tableHit = elapsedUs(t);
+  t = std::chrono::steady_clock::now();
+  for (unsigned r = 0; r < rounds; r++) {
+    for (unsigned i = 0; i < count; i++) sink += (long)findCommand(table, count, misses[i]);
+  }
+  double tableMiss = elapsedUs(t);
+  
+  for (unsigned i = 0; i < count; i++) {
+    const Command* cmd = findCommand(table, count, hits[i]);
+    if (!cmd || strcmp(cmd->name, hits[i]) != 0) failures++;
+    if (findCommand(table, count, misses[i])) failures++;
+  }
+  
+  double n = (double)rounds * count;
+  printf("  %-7s %2u commands   chain %5.1f ns hit, %5.1f ns miss   table %5.1f ns hit, %5.1f ns miss\n",
+         label, count, chainHit * 1000 / n, chainMiss * 1000 / n, tableHit * 1000 / n, tableMiss * 1000 / n);
+}
+
+int main(int argc, char** argv) {
+  unsigned rounds = argc > 1 ? atoi(argv[1]) : 200000;
+  
+  printf("Command lookup, %u rounds\n", rounds);
+  compare("shell", shellChain, shellTable, COMMAND_COUNT(shellTable), rounds);
+  compare("serial", serialChain, serialTable, COMMAND_COUNT(serialTable), rounds);
+  printf("  rows are %u bytes here, CMD_NAME_LEN + CMD_HELP_LEN + 2 = %u on AVR, all in flash\n",
+         (unsigned)sizeof(Command), CMD_NAME_LEN + CMD_HELP_LEN + 2);
+  
+  printf("%s\n", failures ? "FAILED" : "ok");
+  return failures ? 1 : 0;
+}
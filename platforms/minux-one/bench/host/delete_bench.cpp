@@ -0,0 +1,122 @@
+// Host benchmark for MinuxFS deletes: cost of deleting from the front,
+// middle and back of a full table, a delete-heavy churn, and checks that
+// handles and entry pointers behave across deletes and slot reuse.
+// Built against the fake HAL by bench/run_delete_bench.sh.
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <chrono>
+#include "minux_fs.h"
+
+MinuxFS filesystem;
+MinuxTimers timers;
+
+// On-target inode size before generations (see fs_bench.cpp), for the
+// copying the old shift-down delete would have done
+static const unsigned inodeBytes = MAX_FILENAME + 2 + 1 + 1 + 1 + 2 + 4 + 4;
+
+static unsigned failures = 0;
+
+static void check(bool ok, const char* what) {
+  if (!ok) {
+    printf("  FAILED: %s\n", what);
+    failures++;
+  }
+}
+
+static double elapsedUs(std::chrono::steady_clock::time_point since) {
+  return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - since).count();
+}
+
+static void fill(char names[][MAX_FILENAME], const uint8_t* data, uint16_t size) {
+  for (unsigned i = 0; i < MAX_FILES; i++) {
+    snprintf(names[i], MAX_FILENAME, "file%u", i);
+    filesystem.createFile(names[i], data, size);
+  }
+}
+
+static void handleChecks(char names[][MAX_FILENAME]) {
+  printf("Handles\n");
+  FileEntry* keep = filesystem.openFile(names[MAX_FILES - 1]);
+  FileHandle keepHandle = filesystem.getHandle(keep);
+  FileHandle handles[MAX_FILES];
+  for (unsigned i = 0; i < MAX_FILES; i++) handles[i] = filesystem.getHandle(filesystem.openFile(names[i]));
+  
+  // Deleting others moves nothing
+  for (unsigned i = 0; i < MAX_FILES - 1; i += 2) filesystem.deleteFile(names[i]);
+  check(filesystem.openFile(names[MAX_FILES - 1]) == keep, "entry moved after deletes");
+  check(filesystem.resolve(keepHandle) == keep, "live handle lost after deletes");
+  for (unsigned i = 0; i < MAX_FILES - 1; i += 2) check(!filesystem.resolve(handles[i]), "deleted handle resolves");
+  
+  // Reused slots hand out new generations
+  for (unsigned i = 0; i < MAX_FILES - 1; i += 2) {
+    char name[MAX_FILENAME];
+    snprintf(name, MAX_FILENAME, "new%u", i);
+    check(filesystem.createFile(name, nullptr, 0), "create into a free slot");
+    FileEntry* file = filesystem.openFile(name);
+    check(filesystem.getSlotCount() == MAX_FILES, "free slot not reused");
+    check(filesystem.resolve(filesystem.getHandle(file)) == file, "new handle does not resolve");
+  }
+  for (unsigned i = 0; i < MAX_FILES - 1; i += 2) check(!filesystem.resolve(handles[i]), "stale handle resolves after reuse");
+  check(!filesystem.resolve(FS_NO_HANDLE), "FS_NO_HANDLE resolves");
+  
+  // One slot recycled until just before its generation comes round
+  FileEntry* victim = filesystem.openFile(names[1]);
+  FileHandle old = filesystem.getHandle(victim);
+  bool stale = true;
+  for (unsigned i = 0; i < 255; i++) {
+    filesystem.deleteFile(names[1]);
+    filesystem.createFile(names[1], nullptr, 0);
+    stale = stale && filesystem.openFile(names[1]) == victim && !filesystem.resolve(old);
+  }
+  check(stale, "handle resolved within 255 reuses of its slot");
+  printf("  stale handles rejected, %s\n\n", failures ? "FAILED" : "ok");
+}
+
+int main(int argc, char** argv) {
+  unsigned rounds = argc > 1 ? atoi(argv[1]) : 20000;
+  char names[MAX_FILES][MAX_FILENAME];
+  uint8_t data[FS_BLOCK_SIZE];
+  for (unsigned i = 0; i < sizeof(data); i++) data[i] = i;
+  
+  // Every file gets one block so deletes also hand blocks back
+  uint16_t size = MAX_FILES <= FS_BLOCKS ? FS_BLOCK_SIZE : 0;
+  fill(names, data, size);
+  check(filesystem.getFileCount() == MAX_FILES, "table not full");
+  
+  printf("Delete from a full table of %u, %u rounds (ns per delete)\n", MAX_FILES, rounds);
+  const unsigned positions[] = { 0, MAX_FILES / 2, MAX_FILES - 1 };
+  const char* labels[] = { "first", "middle", "last" };
+  for (unsigned p = 0; p < 3; p++) {
+    const char* name = names[positions[p]];
+    double us = 0;
+    for (unsigned r = 0; r < rounds; r++) {
+      auto t = std::chrono::steady_clock::now();
+      if (!filesystem.deleteFile(name)) failures++;
+      us += elapsedUs(t);
+      if (!filesystem.createFile(name, data, size)) failures++;
+    }
+    printf("  %-7s %7.1f ns, old layout would copy %u bytes\n",
+           labels[p], us * 1000 / rounds, (MAX_FILES - 1 - positions[p]) * inodeBytes);
+  }
+  
+  // Churn: delete a random file and create another in its place
+  double deleteUs = 0, createUs = 0;
+  for (unsigned r = 0; r < rounds; r++) {
+    unsigned victim = random(MAX_FILES);
+    auto t = std::chrono::steady_clock::now();
+    if (!filesystem.deleteFile(names[victim])) failures++;
+    deleteUs += elapsedUs(t);
+    snprintf(names[victim], MAX_FILENAME, "c%u", r);
+    t = std::chrono::steady_clock::now();
+    if (!filesystem.createFile(names[victim], data, size)) failures++;
+    createUs += elapsedUs(t);
+  }
+  printf("  churn   %7.1f ns per delete, %.1f ns per create\n", deleteUs * 1000 / rounds, createUs * 1000 / rounds);
+  check(filesystem.getSlotCount() == MAX_FILES, "slots leaked during churn");
+  printf("\n");
+  
+  handleChecks(names);
+  printf("%s\n", failures ? "FAILED" : "ok");
+  return failures ? 1 : 0;
+}
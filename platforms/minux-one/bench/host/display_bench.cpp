@@ -0,0 +1,249 @@
+// Host benchmark for the display path, on the fake Wire bus with SimPanel
+// decoding what arrives. Counts the I2C bytes and bus time the shell's `help`
+// output costs with dirty-region flushes, against the old MinuxDisplay that
+// pushed the whole framebuffer after every print call, then measures terminal
+// throughput for a long `cat`. Built by bench/run_display_bench.sh.
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <stdio.h>
+#include <chrono>
+#include "minux_config.h"
+#include "minux_kernel.h"
+#include "minux_display.h"
+#include "minux_input.h"
+#include "minux_scheduler.h"
+#include "minux_fs.h"
+#include "minux_shell.h"
+#include "minux_timer.h"
+#include "minux_sound.h"
+#include "minux_command.h"
+#include "minux_syscmd.h"
+#include "sim_panel.h"
+
+#if DISPLAY_PAGE_MODE
+#error "display bench needs the framebuffer build"
+#endif
+
+Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET);
+MinuxTimers timers;
+MinuxKernel kernel;
+MinuxInput input;
+MinuxSound sound;
+MinuxDisplay ui(&display);
+MinuxScheduler scheduler;
+MinuxFS filesystem;
+MinuxShell shell;
+
+SimPanel panel;
+
+static void handler(uint8_t, char**) {}
+
+// The rows `help` prints, as in minux_shell.cpp
+static constexpr Command helpRows[] PROGMEM = {
+  { "cat",     "Display file",      handler },
+  { "cd",      "Change directory",  handler },
+  { "clear",   "Clear screen",      handler },
+  { "echo",    "Print text",        handler },
+  COMMAND_HELP,
+  { "ls",      "List files",        handler },
+  COMMAND_MEM,
+  { "mkdir",   "Make directory",    handler },
+  { "ps",      "List processes",    handler },
+  { "pwd",     "Show directory",    handler },
+  COMMAND_REBOOT,
+  { "rmdir",   "Remove directory",  handler },
+  { "sched",   "stats | reset",     handler },
+  { "top",     "CPU use per task",  handler },
+  { "uptime",  "Show uptime",       handler },
+  { "version", "Show version",      handler },
+};
+COMMAND_TABLE_CHECK(helpRows);
+
+// The display before dirty tracking: every print went straight to the
+// framebuffer and then out over the bus, all 1 KB of it
+class FullFrameDisplay {
+public:
+  unsigned calls = 0;
+  void print(const char* text) { display.print(text); push(); }
+  void println(const char* text) { display.println(text); push(); }
+  
+private:
+  void push() {
+    calls++;
+    display.display();
+  }
+};
+
+static unsigned failures = 0;
+
+static void check(bool ok, const char* what) {
+  if (!ok) {
+    printf("  FAILED: %s\n", what);
+    failures++;
+  }
+}
+
+static double elapsedUs(std::chrono::steady_clock::time_point since) {
+  return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - since).count();
+}
+
+struct BusCost {
+  uint32_t bytes;
+  uint32_t transactions;
+  uint64_t micros;
+};
+
+static BusCost takeBus() {
+  BusCost cost = { Wire.getBytes(), Wire.getTransactions(), Wire.getBusMicros() };
+  Wire.resetStats();
+  return cost;
+}
+
+static void report(const char* label, const BusCost& cost, unsigned flushes) {
+  printf("  %-12s %6lu bytes in %4lu transactions, %3u frames, %7.1f ms at %lu kHz, %7.1f ms at 100 kHz\n",
+         label, (unsigned long)cost.bytes, (unsigned long)cost.transactions, flushes,
+         cost.micros / 1000.0, (unsigned long)(TWI_CLOCK_HZ / 1000),
+         cost.bytes * 9 * 1000.0 / 100000);
+}
+
+// Runs the timer wheel for whole UI frames of virtual time, so flushes go
+// out when the frame timer fires, as they do on the board
+static void runFrames(uint8_t frames) {
+  for (unsigned long ms = 0; ms < frames * (unsigned long)UI_UPDATE_MS; ms++) {
+    simAdvance(1000);
+    timers.update();
+  }
+}
+
+template <typename Out>
+static void printHelp(Out& out) {
+  out.println("Available commands:");
+  printCommandHelp(out, helpRows, COMMAND_COUNT(helpRows));
+}
+
+template <typename Out>
+static void printOneLine(Out& out) {
+  out.println("Uptime: 42 s");
+}
+
+// The same output both ways, each starting from a flushed terminal
+static void compare(const char* label, void (*oldPath)(FullFrameDisplay&), void (*newPath)(MinuxDisplay&)) {
+  printf("%s\n", label);
+  
+  // Old path: one full frame per print call
+  display.clearDisplay();
+  display.setCursor(0, 0);
+  Wire.resetStats();
+  FullFrameDisplay old;
+  oldPath(old);
+  BusCost before = takeBus();
+  report("full frame", before, old.calls);
+  
+  // Dirty regions, flushed by the frame timer
+  ui.setTerminalMode();
+  ui.flush();
+  takeBus();
+  uint16_t flushes = ui.getFlushCount();
+  newPath(ui);
+  runFrames(2);
+  BusCost after = takeBus();
+  report("dirty pages", after, ui.getFlushCount() - flushes);
+  
+  check(after.bytes > 0 && after.bytes < before.bytes, "dirty flush sent no bytes or no fewer bytes");
+  check(ui.getFlushCount() - flushes == 1, "output was not coalesced into one flush");
+  printf("  %.1fx fewer bytes\n\n", (double)before.bytes / after.bytes);
+}
+
+static void type(const char* line) {
+  while (*line) shell.processInput(*line++);
+  shell.processInput('\n');
+}
+
+// The longest file of numbered lines the block heap still has room for,
+// each line shorter than a terminal row
+static uint16_t makeLongFile(const char* path) {
+  static char text[FS_BLOCKS * FS_BLOCK_SIZE];
+  uint16_t length = 0;
+  for (uint8_t i = 0; length + 20u < sizeof(text); i++) {
+    length += snprintf(text + length, sizeof(text) - length, "line %2u of the file\n", i);
+  }
+  for (; length >= 20; length -= 20) {
+    if (filesystem.createFile(path, (const uint8_t*)text, length)) return length;
+  }
+  return 0;
+}
+
+// Characters per second through the terminal: host CPU for printing into
+// the grid and rendering the changed cells, and the bus time the flushes
+// take, which bounds the rate on the board
+static void catThroughput(unsigned rounds) {
+  uint16_t length = makeLongFile("long.txt");
+  check(length > 0, "could not create the test file");
+  printf("`cat` of a %u byte file, %u times\n", length, rounds);
+  
+  ui.setTerminalMode();
+  shell.activate();
+  ui.flush();
+  takeBus();
+  uint32_t cells = ui.getCharsRendered();
+  uint16_t flushes = ui.getFlushCount();
+  double hostUs = 0;
+  
+  for (unsigned r = 0; r < rounds; r++) {
+    auto t = std::chrono::steady_clock::now();
+    type("cat long.txt");
+    ui.flush();
+    hostUs += elapsedUs(t);
+  }
+  BusCost bus = takeBus();
+  cells = ui.getCharsRendered() - cells;
+  flushes = ui.getFlushCount() - flushes;
+  unsigned long printed = (unsigned long)length * rounds;
+  
+  printf("  %lu characters printed, %lu cells rendered, %u flushes\n",
+         printed, (unsigned long)cells, flushes);
+  printf("  host: %.0f chars/s printed and flushed\n", printed / hostUs * 1e6);
+  printf("  bus:  %lu bytes, %.1f ms at %lu kHz, %.0f chars/s\n",
+         (unsigned long)bus.bytes, bus.micros / 1000.0, (unsigned long)(TWI_CLOCK_HZ / 1000),
+         printed / (bus.micros / 1e6));
+  check(cells > 0 && cells < printed, "every printed character was rendered");
+  
+  // One line per UI frame, as slow output arrives: each scroll redraws only
+  // the row just written and the recycled row that becomes the bottom line
+  takeBus();
+  cells = ui.getCharsRendered();
+  char line[TERM_COLS];
+  const unsigned lines = 64;
+  for (unsigned i = 0; i < lines; i++) {
+    snprintf(line, sizeof(line), "scrolled line %u", i);
+    ui.println(line);
+    runFrames(1);
+  }
+  bus = takeBus();
+  cells = ui.getCharsRendered() - cells;
+  printf("  one line per frame: %.0f bytes and %.1f cells per line on the bus\n\n",
+         (double)bus.bytes / lines, (double)cells / lines);
+  check(bus.bytes / lines < 3 * (SCREEN_WIDTH + 8), "a scroll redrew more than two rows");
+  
+  filesystem.deleteFile("long.txt");
+}
+
+int main(int argc, char** argv) {
+  unsigned rounds = argc > 1 ? atoi(argv[1]) : 200;
+  
+  Wire.attach(SCREEN_ADDRESS, &panel);
+  Wire.setClock(TWI_CLOCK_HZ);
+  timers.init();
+  kernel.init();
+  display.begin(SSD1306_SWITCHCAPVCC, SCREEN_ADDRESS);
+  ui.init();
+  filesystem.init();
+  
+  compare("`help`, 17 lines", printHelp<FullFrameDisplay>, printHelp<MinuxDisplay>);
+  compare("One line", printOneLine<FullFrameDisplay>, printOneLine<MinuxDisplay>);
+  catThroughput(rounds);
+  
+  printf("%s\n", failures ? "FAILED" : "ok");
+  return failures ? 1 : 0;
+}
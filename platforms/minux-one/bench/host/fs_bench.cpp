@@ -0,0 +1,130 @@
+// Host benchmark for MinuxFS: memory footprint of the block heap layout and
+// throughput of create, append, read and delete. Built against the fake HAL
+// by bench/run_fs_bench.sh. Every read is checked against what was written.
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <chrono>
+#include "minux_fs.h"
+
+MinuxFS filesystem;
+MinuxTimers timers;
+
+// On-target sizes: AVR packs structs and longs are 4 bytes
+static const unsigned inodeBytes = MAX_FILENAME + 2 + 1 + 1 + 1 + 1 + 1 + 1 + 1 + 2 + 4 + 4;
+static const unsigned extentBytes = 3;
+static const unsigned slotLayoutBytes = MAX_FILES * (MAX_FILENAME + 256 + 2 + 1 + 4 + 4);
+
+static const char* const names[] = { "a", "b", "c", "d", "e", "f", "g", "h" };
+#define FILES 8
+#define CHUNK 16
+
+static uint8_t pattern(unsigned file, unsigned offset) {
+  return (uint8_t)(file * 31 + offset * 7);
+}
+
+static double elapsedUs(std::chrono::steady_clock::time_point since) {
+  return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - since).count();
+}
+
+static void report(const char* op, unsigned long ops, unsigned long bytes, double us) {
+  printf("  %-8s %8lu ops %9.1f ns/op", op, ops, us * 1000.0 / ops);
+  if (bytes) printf(" %8.1f MB/s", bytes / us);
+  printf("\n");
+}
+
+int main(int argc, char** argv) {
+  unsigned rounds = argc > 1 ? atoi(argv[1]) : 20000;
+  
+  unsigned heap = FS_BLOCKS * FS_BLOCK_SIZE + (FS_BLOCKS + 7) / 8 + FS_EXTENTS * extentBytes;
+  printf("Footprint (AVR layout)\n");
+  printf("  inodes    %5u bytes (%u x %u)\n", MAX_FILES * inodeBytes, MAX_FILES, inodeBytes);
+  printf("  heap      %5u bytes (%u blocks of %u, bitmap, %u extents)\n",
+         heap, FS_BLOCKS, FS_BLOCK_SIZE, FS_EXTENTS);
+  printf("  total     %5u bytes, was %u with 256-byte slots\n", MAX_FILES * inodeBytes + heap, slotLayoutBytes);
+  printf("  host sizeof(MinuxFS) %u\n\n", (unsigned)sizeof(MinuxFS));
+  
+  // Mixed sizes: what is actually held versus the blocks it occupies
+  uint8_t buf[FS_BLOCKS * FS_BLOCK_SIZE];
+  for (unsigned i = 0; i < sizeof(buf); i++) buf[i] = pattern(9, i);
+  const uint16_t sizes[] = { 3, 20, 47, 100, 9 };
+  unsigned stored = 0;
+  for (unsigned i = 0; i < 5; i++) {
+    filesystem.createFile(names[i], buf, sizes[i]);
+    stored += sizes[i];
+  }
+  unsigned used = FS_BLOCKS * FS_BLOCK_SIZE - filesystem.getFreeBytes();
+  printf("Utilisation: %u bytes in 5 files occupy %u heap bytes\n", stored, used);
+  for (unsigned i = 0; i < 5; i++) filesystem.deleteFile(names[i]);
+  
+  // One file past the old 256-byte limit
+  uint16_t big = FS_BLOCKS * FS_BLOCK_SIZE - FS_BLOCK_SIZE;
+  bool ok = filesystem.createFile("big", buf, big);
+  uint8_t check[sizeof(buf)];
+  ok = ok && filesystem.readFile("big", check, sizeof(check)) == big && !memcmp(buf, check, big);
+  printf("Large file: %u bytes %s\n\n", big, ok ? "ok" : "FAILED");
+  filesystem.deleteFile("big");
+  
+  // Throughput: files grown by appends, read back whole, then deleted. Eight
+  // files interleave their appends so extents get split.
+  unsigned perFile = (FS_BLOCKS * FS_BLOCK_SIZE / FILES) / CHUNK * CHUNK;
+  unsigned long creates = 0, appends = 0, reads = 0, deletes = 0;
+  unsigned long appendBytes = 0, readBytes = 0;
+  double createUs = 0, appendUs = 0, readUs = 0, deleteUs = 0;
+  unsigned failures = 0, maxExtents = 0;
+  uint8_t chunk[CHUNK];
+  
+  for (unsigned r = 0; r < rounds; r++) {
+    auto t = std::chrono::steady_clock::now();
+    for (unsigned f = 0; f < FILES; f++) {
+      if (!filesystem.createFile(names[f], nullptr, 0)) failures++;
+    }
+    createUs += elapsedUs(t);
+    creates += FILES;
+    
+    for (unsigned offset = 0; offset < perFile; offset += CHUNK) {
+      for (unsigned f = 0; f < FILES; f++) {
+        for (unsigned i = 0; i < CHUNK; i++) chunk[i] = pattern(f + r, offset + i);
+        t = std::chrono::steady_clock::now();
+        if (!filesystem.appendFile(names[f], chunk, CHUNK)) failures++;
+        appendUs += elapsedUs(t);
+        appends++;
+        appendBytes += CHUNK;
+      }
+    }
+    
+    for (unsigned f = 0; f < FILES; f++) {
+      FileEntry* file = filesystem.openFile(names[f]);
+      if (file && filesystem.getExtentCount(file) > maxExtents) maxExtents = filesystem.getExtentCount(file);
+      t = std::chrono::steady_clock::now();
+      uint16_t n = filesystem.readFile(names[f], check, sizeof(check));
+      readUs += elapsedUs(t);
+      reads++;
+      readBytes += n;
+      if (n != perFile) failures++;
+      for (unsigned i = 0; i < n; i++) {
+        if (check[i] != pattern(f + r, i)) {
+          failures++;
+          break;
+        }
+      }
+    }
+    
+    t = std::chrono::steady_clock::now();
+    for (unsigned f = 0; f < FILES; f++) {
+      if (!filesystem.deleteFile(names[f])) failures++;
+    }
+    deleteUs += elapsedUs(t);
+    deletes += FILES;
+  }
+  
+  printf("Throughput, %u rounds of %u files x %u bytes in %u-byte appends\n", rounds, FILES, perFile, CHUNK);
+  report("create", creates, 0, createUs);
+  report("append", appends, appendBytes, appendUs);
+  report("read", reads, readBytes, readUs);
+  report("delete", deletes, 0, deleteUs);
+  printf("  most extents per file: %u\n", maxExtents);
+  printf("  heap free after run: %u of %u bytes\n", filesystem.getFreeBytes(), FS_BLOCKS * FS_BLOCK_SIZE);
+  printf("%s\n", failures ? "FAILED" : "ok");
+  return failures ? 1 : 0;
+}
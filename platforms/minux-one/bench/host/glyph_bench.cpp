@@ -0,0 +1,114 @@
+// Host test and benchmark for the text blitter: random glyphs, positions and
+// colours drawn both by GlyphBlitter and by Adafruit_GFX::drawChar, which
+// sets one pixel at a time, must leave identical framebuffers. Then full
+// screens of text are timed both ways, on and off page boundaries and
+// inverted. Built by bench/run_glyph_bench.sh.
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <stdio.h>
+#include <chrono>
+#include "minux_config.h"
+#include "minux_glyph.h"
+#include <Adafruit_SSD1306.h>
+
+#define FRAME_BYTES (SCREEN_WIDTH * SCREEN_HEIGHT / 8)
+
+static Adafruit_SSD1306 gfx(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, -1);
+static uint8_t blitBuffer[FRAME_BYTES];
+static GlyphBlitter blitter;
+
+static unsigned failures = 0;
+
+static void check(bool ok, const char* what) {
+  if (!ok) {
+    printf("  FAILED: %s\n", what);
+    failures++;
+  }
+}
+
+static double elapsedUs(std::chrono::steady_clock::time_point since) {
+  return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - since).count();
+}
+
+// Colour and background pairs MinuxDisplay draws with: transparent, opaque,
+// inverted (the taskbar) and XOR
+static const uint8_t colors[][2] = {
+  { SSD1306_WHITE, SSD1306_WHITE },
+  { SSD1306_WHITE, SSD1306_BLACK },
+  { SSD1306_BLACK, SSD1306_WHITE },
+  { SSD1306_INVERSE, SSD1306_INVERSE },
+};
+
+static void matchChecks(unsigned count) {
+  uint8_t* reference = gfx.getBuffer();
+  unsigned mismatches = 0;
+  
+  for (unsigned n = 0; n < count; n++) {
+    // Same random background under both
+    for (unsigned i = 0; i < FRAME_BYTES; i++) reference[i] = blitBuffer[i] = random(256);
+    
+    int16_t x = random(-GLYPH_WIDTH, SCREEN_WIDTH);
+    int16_t y = random(-GLYPH_HEIGHT, SCREEN_HEIGHT);
+    uint8_t c = random(256);
+    const uint8_t* pair = colors[random(4)];
+    
+    gfx.drawChar(x, y, c, pair[0], pair[1], 1);
+    blitter.setTextColor(pair[0], pair[1]);
+    blitter.drawGlyph(x, y, c);
+    if (memcmp(reference, blitBuffer, FRAME_BYTES)) mismatches++;
+  }
+  
+  printf("Blitter against drawChar, %u random glyphs: %u mismatches\n\n", count, mismatches);
+  check(mismatches == 0, "blitter output differs from drawChar");
+}
+
+// One screen of text: rows of 21 glyphs starting at yOffset
+static const char sample[] = "The quick brown fox j";
+
+template <typename Out>
+static unsigned fillScreen(Out& out, uint8_t yOffset) {
+  unsigned glyphs = 0;
+  for (int16_t y = yOffset; y + GLYPH_HEIGHT <= SCREEN_HEIGHT; y += GLYPH_HEIGHT) {
+    out.setCursor(0, y);
+    glyphs += out.print(sample);
+  }
+  return glyphs;
+}
+
+static void timeCase(const char* label, uint8_t yOffset, uint8_t color, uint8_t background, unsigned rounds) {
+  gfx.setTextWrap(false);
+  gfx.setTextColor(color, background);
+  blitter.setTextColor(color, background);
+  
+  unsigned glyphs = 0;
+  auto t = std::chrono::steady_clock::now();
+  for (unsigned r = 0; r < rounds; r++) glyphs += fillScreen(gfx, yOffset);
+  double gfxUs = elapsedUs(t);
+  
+  t = std::chrono::steady_clock::now();
+  for (unsigned r = 0; r < rounds; r++) fillScreen(blitter, yOffset);
+  double blitUs = elapsedUs(t);
+  
+  printf("  %-22s drawChar %7.0f, blitter %7.0f glyphs/ms, %4.1fx\n",
+         label, glyphs / (gfxUs / 1000), glyphs / (blitUs / 1000), gfxUs / blitUs);
+  check(!memcmp(gfx.getBuffer(), blitBuffer, FRAME_BYTES), "timed screens differ");
+}
+
+int main(int argc, char** argv) {
+  unsigned rounds = argc > 1 ? atoi(argv[1]) : 5000;
+  
+  gfx.begin(SSD1306_SWITCHCAPVCC, 0x3C);   // Allocates the buffer; no panel attached
+  blitter.begin(blitBuffer);
+  
+  matchChecks(20000);
+  
+  printf("Full screens of text, %u rounds (host)\n", rounds);
+  timeCase("page aligned", 0, SSD1306_WHITE, SSD1306_WHITE, rounds);
+  timeCase("3 pixels off a page", 3, SSD1306_WHITE, SSD1306_WHITE, rounds);
+  timeCase("inverted, opaque", 0, SSD1306_BLACK, SSD1306_WHITE, rounds);
+  timeCase("terminal cells, opaque", 0, SSD1306_WHITE, SSD1306_BLACK, rounds);
+  
+  printf("%s\n", failures ? "FAILED" : "ok");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,198 @@
+// Host test and benchmark for button capture: edge sequences are injected on
+// the fake pins, each followed by the pin-change handler as the ISR would call
+// it, under virtual time. Checks debounce rejection, short taps, chords and
+// the combo event, queue overflow, ordering and the time from edge to event,
+// then times the handler itself.
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <chrono>
+#include "minux_config.h"
+#include "minux_input.h"
+#include "minux_sound.h"
+
+MinuxInput input;
+MinuxSound sound;
+
+static const uint8_t buttonPins[4] = { PIN_BUTTON_A, PIN_BUTTON_UP, PIN_BUTTON_DOWN, PIN_BUTTON_RIGHT };
+
+static unsigned failures = 0;
+
+static void check(bool ok, const char* what) {
+  if (!ok) {
+    printf("  FAILED: %s\n", what);
+    failures++;
+  }
+}
+
+static double elapsedUs(std::chrono::steady_clock::time_point since) {
+  return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - since).count();
+}
+
+// Worst gap between an edge and the timestamp of the event it produced
+static unsigned long worstLatency = 0;
+
+// Moves virtual time forward, then drives one button and takes the interrupt
+static void edge(unsigned long afterMs, uint8_t button, bool down) {
+  simAdvance(afterMs * 1000);
+  simSetPin(buttonPins[button], down ? LOW : HIGH);
+  input.onPinChange();
+}
+
+static uint8_t drain(InputRecord* out) {
+  return input.read(out, INPUT_QUEUE_SIZE);
+}
+
+static void expectEvent(const InputRecord& r, InputEvent event, unsigned long edgeMs, const char* what) {
+  check(r.event == event, what);
+  check(r.timestamp >= edgeMs, "event stamped before its edge");
+  if (r.timestamp >= edgeMs && r.timestamp - edgeMs > worstLatency) worstLatency = r.timestamp - edgeMs;
+}
+
+// Leaves every button up and the debounce windows expired
+static void settle() {
+  InputRecord out[INPUT_QUEUE_SIZE];
+  for (uint8_t i = 0; i < 4; i++) simSetPin(buttonPins[i], HIGH);
+  simAdvance((INPUT_DEBOUNCE_MS + 1) * 1000UL);
+  input.onPinChange();
+  simAdvance((INPUT_DEBOUNCE_MS + 1) * 1000UL);
+  drain(out);
+}
+
+static void edgeChecks() {
+  InputRecord out[INPUT_QUEUE_SIZE];
+  
+  // A clean press is stamped with the time of its edge
+  edge(100, 0, true);
+  unsigned long pressed = millis();
+  check(drain(out) == 1, "clean press not queued once");
+  expectEvent(out[0], EVENT_BTN_A, pressed, "clean press reported as the wrong button");
+  check(input.getButtonState(0) == BTN_PRESSED, "button state not pressed");
+  settle();
+  
+  // Contact bounce: the first edge counts, the chatter inside the window
+  // does not, and the release after the window is a release, not a press
+  edge(0, 1, true);
+  pressed = millis();
+  for (uint8_t i = 0; i < 6; i++) edge(2, 1, i & 1);
+  check(drain(out) == 1, "bounce produced extra presses");
+  expectEvent(out[0], EVENT_BTN_UP, pressed, "bounced press reported as the wrong button");
+  edge(INPUT_DEBOUNCE_MS, 1, false);
+  check(drain(out) == 0 && input.getButtonState(1) == BTN_RELEASED, "release queued or not recorded");
+  settle();
+  
+  // A tap far shorter than the old 10 ms poll is still caught
+  edge(0, 2, true);
+  pressed = millis();
+  edge(1, 2, false);
+  check(drain(out) == 1, "short tap missed");
+  expectEvent(out[0], EVENT_BTN_DOWN, pressed, "short tap reported as the wrong button");
+  settle();
+  
+  // A change inside the debounce window with no later edge is settled by
+  // read(), late by at most the window: first a release, then a re-press
+  edge(0, 3, true);
+  edge(1, 3, false);
+  simAdvance(INPUT_DEBOUNCE_MS * 1000UL);
+  uint8_t n = drain(out);
+  check(n == 1 && out[0].event == EVENT_BTN_RIGHT, "tap inside the window lost");
+  check(input.getButtonState(3) == BTN_RELEASED, "release inside the window not settled");
+  edge(1, 3, true);
+  pressed = millis();
+  simAdvance(INPUT_DEBOUNCE_MS * 1000UL);
+  n = drain(out);
+  check(n == 1, "re-press inside the window not settled");
+  if (n == 1) expectEvent(out[0], EVENT_BTN_RIGHT, pressed, "settled re-press reported as the wrong button");
+  settle();
+  
+  // Two buttons on the same interrupt: both presses, then one combo per chord
+  simSetPin(buttonPins[0], LOW);
+  edge(0, 2, true);
+  pressed = millis();
+  n = drain(out);
+  check(n == 3, "simultaneous presses not all queued");
+  if (n == 3) {
+    expectEvent(out[0], EVENT_BTN_A, pressed, "chord: A not first");
+    expectEvent(out[1], EVENT_BTN_DOWN, pressed, "chord: DOWN not second");
+    expectEvent(out[2], EVENT_BTN_COMBO, pressed, "chord: no combo event");
+  }
+  check(input.isComboPressed(), "combo not reported while held");
+  // A third button joins the same chord: no second combo
+  edge(5, 1, true);
+  check(drain(out) == 1 && out[0].event == EVENT_BTN_UP, "third button re-fired the combo");
+  // Letting go of one still leaves a chord; all up re-arms it
+  edge(INPUT_DEBOUNCE_MS, 0, false);
+  check(drain(out) == 0, "partial release queued an event");
+  settle();
+  edge(0, 0, true);
+  edge(3, 3, true);
+  pressed = millis();
+  n = drain(out);
+  check(n == 3 && out[2].event == EVENT_BTN_COMBO, "combo not re-armed after release");
+  if (n == 3) expectEvent(out[2], EVENT_BTN_COMBO, pressed, "second chord combo");
+  settle();
+  
+  // Overflow: the ring holds INPUT_QUEUE_SIZE - 1, the rest are counted as
+  // dropped, and the survivors come out in edge order
+  uint8_t droppedBefore = input.getDropped();
+  unsigned long stamps[INPUT_QUEUE_SIZE + 2];
+  for (uint8_t i = 0; i < INPUT_QUEUE_SIZE + 2; i++) {
+    edge(INPUT_DEBOUNCE_MS, i & 3, true);
+    stamps[i] = millis();
+    edge(INPUT_DEBOUNCE_MS, i & 3, false);
+  }
+  n = drain(out);
+  check(n == INPUT_QUEUE_SIZE - 1, "ring did not fill to capacity");
+  check((uint8_t)(input.getDropped() - droppedBefore) == 3, "overflow not counted");
+  for (uint8_t i = 0; i < n; i++) {
+    expectEvent(out[i], (InputEvent)(EVENT_BTN_A + (i & 3)), stamps[i], "events out of order");
+    check(out[i].timestamp == stamps[i], "event not stamped with its own edge");
+  }
+  settle();
+  
+  // Batches: a small max leaves the rest for the next read
+  for (uint8_t i = 0; i < 3; i++) {
+    edge(INPUT_DEBOUNCE_MS, i, true);
+    edge(INPUT_DEBOUNCE_MS, i, false);
+  }
+  check(input.read(out, 2) == 2 && input.read(out + 2, 2) == 1 && out[2].event == EVENT_BTN_DOWN,
+        "batched read lost or repeated events");
+  settle();
+  
+  printf("Edges: bounce, short tap, late settle, chords, overflow, order and batches %s\n",
+         failures ? "FAILED" : "ok");
+  printf("  worst edge to event latency %lu ms (virtual time, debounce %u ms)\n\n",
+         worstLatency, INPUT_DEBOUNCE_MS);
+  check(worstLatency <= INPUT_DEBOUNCE_MS, "an event came later than the debounce window");
+}
+
+int main(int argc, char** argv) {
+  unsigned rounds = argc > 1 ? atoi(argv[1]) : 200000;
+  
+  input.init(PIN_BUTTON_A, PIN_BUTTON_UP, PIN_BUTTON_DOWN, PIN_BUTTON_RIGHT, PIN_BUZZER);
+  input.enableBuzzer(false);
+  settle();
+  
+  edgeChecks();
+  
+  // Handler cost per edge: a press and release of each button in turn, with
+  // the queue drained as the main loop would
+  InputRecord out[INPUT_QUEUE_SIZE];
+  unsigned long events = 0;
+  auto t = std::chrono::steady_clock::now();
+  for (unsigned r = 0; r < rounds; r++) {
+    uint8_t b = r & 3;
+    edge(INPUT_DEBOUNCE_MS, b, true);
+    edge(INPUT_DEBOUNCE_MS, b, false);
+    if ((r & 3) == 3) events += drain(out);
+  }
+  double us = elapsedUs(t);
+  events += drain(out);
+  
+  printf("Pin-change handler, %u presses\n", rounds);
+  printf("  %.1f ns per edge on the host, %lu events\n", us * 1000 / (rounds * 2.0), events);
+  check(events == rounds, "presses lost while draining in batches");
+  
+  printf("%s\n", failures ? "FAILED" : "ok");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,181 @@
+// Host test and benchmark for the serial line discipline: editing and
+// splitting checks, then command lines fed byte by byte through poll(),
+// parse() and runCommand(), counting heap calls on the way. Anything the
+// line path allocates fails the run. Built by bench/run_line_bench.sh, which
+// wraps malloc, calloc and realloc.
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <new>
+#include <chrono>
+#include "minux_line.h"
+#include "minux_command.h"
+
+static unsigned long heapCalls = 0;
+
+extern "C" {
+  void* __real_malloc(size_t size);
+  void* __real_calloc(size_t n, size_t size);
+  void* __real_realloc(void* p, size_t size);
+  void* __wrap_malloc(size_t size) { heapCalls++; return __real_malloc(size); }
+  void* __wrap_calloc(size_t n, size_t size) { heapCalls++; return __real_calloc(n, size); }
+  void* __wrap_realloc(void* p, size_t size) { heapCalls++; return __real_realloc(p, size); }
+}
+
+void* operator new(size_t size) { heapCalls++; return __real_malloc(size); }
+void* operator new[](size_t size) { heapCalls++; return __real_malloc(size); }
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+
+// Serial stand-in over a fixed buffer, so feeding input allocates nothing
+class BufferStream : public Stream {
+private:
+  const char* data;
+  size_t length;
+  size_t pos;
+  
+public:
+  BufferStream() : data(""), length(0), pos(0) {}
+  void load(const char* text, size_t n) { data = text; length = n; pos = 0; }
+  int available() override { return length - pos; }
+  int read() override { return pos < length ? (uint8_t)data[pos++] : -1; }
+  int peek() override { return pos < length ? (uint8_t)data[pos] : -1; }
+  size_t write(uint8_t) override { return 1; }
+};
+
+// Echo sink that only counts
+class CountingPrint : public Print {
+public:
+  unsigned long bytes = 0;
+  size_t write(uint8_t) override { bytes++; return 1; }
+};
+
+static unsigned long dispatched = 0;
+static void handler(uint8_t, char**) { dispatched++; }
+
+static constexpr Command benchCommands[] PROGMEM = {
+  { "cat",     "", handler },
+  { "echo",    "", handler },
+  { "help",    "", handler },
+  { "ls",      "", handler },
+  { "mem",     "", handler },
+  { "ps",      "", handler },
+  { "sched",   "", handler },
+  { "top",     "", handler },
+  { "uptime",  "", handler },
+  { "version", "", handler },
+};
+COMMAND_TABLE_CHECK(benchCommands);
+
+static unsigned failures = 0;
+
+static void check(bool ok, const char* what) {
+  if (!ok) {
+    printf("  FAILED: %s\n", what);
+    failures++;
+  }
+}
+
+static double elapsedUs(std::chrono::steady_clock::time_point since) {
+  return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - since).count();
+}
+
+// Feeds text and parses the first completed line
+static uint8_t lineOf(MinuxLine& line, const char* text, char** argv, uint8_t maxArgs) {
+  BufferStream in;
+  in.load(text, strlen(text));
+  if (!line.poll(in)) return 0xFF;
+  return line.parse(argv, maxArgs);
+}
+
+static void editChecks() {
+  MinuxLine line;
+  char* argv[LINE_MAX_ARGS];
+  
+  check(lineOf(line, "LS  /etc\r\n", argv, 2) == 2 && !strcmp(argv[0], "ls") && !strcmp(argv[1], "/etc"),
+        "command word not lowercased or argument lost");
+  check(lineOf(line, "echo  hello   world  \n", argv, 2) == 2 && !strcmp(argv[1], "hello   world"),
+        "remainder not kept whole and trimmed");
+  check(lineOf(line, "pz\bs\n", argv, 2) == 1 && !strcmp(argv[0], "ps"), "backspace not applied");
+  check(lineOf(line, "\b\bmem\r", argv, 2) == 1 && !strcmp(argv[0], "mem"), "backspace on empty line");
+  
+  // CR LF ends one line, not two
+  BufferStream in;
+  const char* crlf = "help\r\nps\r\n";
+  in.load(crlf, strlen(crlf));
+  check(line.poll(in) && line.parse(argv, 2) == 1 && !strcmp(argv[0], "help"), "CR LF first line");
+  check(line.poll(in) && line.parse(argv, 2) == 1 && !strcmp(argv[0], "ps"), "CR LF counted twice");
+  
+  // Overlong input is cut at the buffer, not written past it
+  char longLine[MAX_CMD_LENGTH * 2 + 2];
+  memset(longLine, 'x', MAX_CMD_LENGTH * 2);
+  strcpy(longLine + MAX_CMD_LENGTH * 2, "\n");
+  check(lineOf(line, longLine, argv, 2) == 1 && strlen(argv[0]) == MAX_CMD_LENGTH - 1, "overlong line not truncated");
+  
+  // Echo: printable bytes, "\b \b" per backspace, CR LF per line
+  CountingPrint echo;
+  MinuxLine echoed(&echo);
+  lineOf(echoed, "ab\bc\n", argv, 2);
+  check(echo.bytes == 3 + 3 + 2, "echo byte count");
+  
+  printf("Editing: case, remainder, backspace, CR LF, overflow and echo %s\n\n", failures ? "FAILED" : "ok");
+}
+
+int main(int argc, char** argv) {
+  unsigned rounds = argc > 1 ? atoi(argv[1]) : 20000;
+  
+  editChecks();
+  
+  // A mix of line endings, arguments, edits and unknown commands
+  static const char script[] =
+    "help\r\n"
+    "ls /etc\n"
+    "cat sysinfo\r"
+    "ECHO some text to print\n"
+    "pss\b\r\n"
+    "uptime\n"
+    "sched stats\n"
+    "nosuch command\n"
+    "  top  \n"
+    "version\r\n";
+  const unsigned linesPerRound = 10;
+  
+  BufferStream in;
+  CountingPrint echo;
+  MinuxLine line(&echo);
+  char* args[2];
+  unsigned long unknown = 0;
+  
+  heapCalls = 0;
+  auto t = std::chrono::steady_clock::now();
+  for (unsigned r = 0; r < rounds; r++) {
+    in.load(script, sizeof(script) - 1);
+    while (line.poll(in)) {
+      uint8_t n = line.parse(args, 2);
+      if (n && !runCommand(benchCommands, COMMAND_COUNT(benchCommands), n, args)) unknown++;
+    }
+  }
+  double us = elapsedUs(t);
+  unsigned long lines = (unsigned long)rounds * linesPerRound;
+  
+  printf("Line discipline, %lu lines (%lu bytes each round, echo on)\n", lines, (unsigned long)sizeof(script) - 1);
+  printf("  %.0f lines per second, %.1f ns per line, %.1f ns per byte\n",
+         lines / us * 1e6, us * 1000 / lines, us * 1000 / (rounds * (sizeof(script) - 1)));
+  printf("  heap calls on the line path: %lu\n", heapCalls);
+  check(heapCalls == 0, "the line path allocated");
+  check(dispatched + unknown == lines && unknown == rounds, "lines lost or misrouted");
+  
+  // The counters must see allocations, or the zero above proves nothing.
+  // Volatile so the compiler cannot drop the pairs.
+  unsigned long before = heapCalls;
+  void* volatile block = malloc(16);
+  free(block);
+  int* volatile value = new int;
+  delete value;
+  check(heapCalls == before + 2, "heap calls not counted");
+  
+  printf("%s\n", failures ? "FAILED" : "ok");
+  return failures ? 1 : 0;
+}
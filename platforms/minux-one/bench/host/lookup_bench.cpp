@@ -0,0 +1,87 @@
+// Host benchmark for MinuxFS name lookup: the hashed index against the old
+// linear strcmp scan, for hits and misses at the MAX_FILES the binary was
+// built with. bench/run_lookup_bench.sh builds it for 16, 64 and 254 entries.
+// Random creates and deletes in between check the index stays consistent.
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <chrono>
+#include "minux_fs.h"
+
+MinuxFS filesystem;
+MinuxTimers timers;
+
+static const char* const stems[] = { "log", "cfg", "data", "tmp", "note", "img", "a", "sensor" };
+static const char* const exts[] = { "", ".txt", ".bin", ".csv" };
+
+static void makeName(char* name, unsigned n) {
+  snprintf(name, MAX_FILENAME, "%s%u%s", stems[n % 8], n / 8, exts[(n / 3) % 4]);
+}
+
+// What openFile did before the index
+static FileEntry* scan(const char* name) {
+  for (uint8_t i = 0; i < filesystem.getSlotCount(); i++) {
+    FileEntry* file = filesystem.getFile(i);
+    if (file && strcmp(file->name, name) == 0) return file;
+  }
+  return nullptr;
+}
+
+static double elapsedUs(std::chrono::steady_clock::time_point since) {
+  return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - since).count();
+}
+
+int main(int argc, char** argv) {
+  unsigned rounds = argc > 1 ? atoi(argv[1]) : 2000;
+  char names[MAX_FILES * 2][MAX_FILENAME];
+  for (unsigned i = 0; i < MAX_FILES * 2; i++) makeName(names[i], i);
+  
+  // Even names are present, odd ones are the misses
+  for (unsigned i = 0; i < MAX_FILES; i++) filesystem.createFile(names[i * 2], nullptr, 0);
+  unsigned failures = filesystem.getFileCount() == MAX_FILES ? 0 : 1;
+  
+  volatile uintptr_t sink = 0;
+  double us[4];
+  for (int variant = 0; variant < 4; variant++) {
+    bool indexed = variant < 2;
+    unsigned first = variant & 1;
+    auto t = std::chrono::steady_clock::now();
+    for (unsigned r = 0; r < rounds; r++) {
+      for (unsigned i = 0; i < MAX_FILES; i++) {
+        const char* name = names[i * 2 + first];
+        sink += (uintptr_t)(indexed ? filesystem.openFile(name) : scan(name));
+      }
+    }
+    us[variant] = elapsedUs(t);
+  }
+  
+  double ops = (double)rounds * MAX_FILES;
+  printf("%3u entries, %u index slots: ns per lookup\n", MAX_FILES, FS_HASH_SLOTS);
+  printf("  indexed  hit %7.1f  miss %7.1f\n", us[0] * 1000 / ops, us[1] * 1000 / ops);
+  printf("  scan     hit %7.1f  miss %7.1f\n", us[2] * 1000 / ops, us[3] * 1000 / ops);
+  
+  // Churn: random deletes, renames and creates, then every name must be
+  // found exactly when the reference says it exists
+  bool present[MAX_FILES * 2];
+  for (unsigned i = 0; i < MAX_FILES * 2; i++) present[i] = (i & 1) == 0;
+  for (unsigned r = 0; r < rounds * 10; r++) {
+    unsigned a = random(MAX_FILES * 2), b = random(MAX_FILES * 2);
+    if (present[a] && !present[b] && random(2)) {
+      if (!filesystem.renameFile(names[a], names[b])) failures++;
+      present[a] = false;
+      present[b] = true;
+    } else if (present[a]) {
+      if (!filesystem.deleteFile(names[a])) failures++;
+      present[a] = false;
+    } else if (filesystem.getFileCount() < MAX_FILES) {
+      if (!filesystem.createFile(names[a], nullptr, 0)) failures++;
+      present[a] = true;
+    }
+  }
+  for (unsigned i = 0; i < MAX_FILES * 2; i++) {
+    FileEntry* file = filesystem.openFile(names[i]);
+    if ((file != nullptr) != present[i] || (file && strcmp(file->name, names[i]))) failures++;
+  }
+  printf("  churn    %u ops, %s\n", rounds * 10, failures ? "FAILED" : "ok");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,193 @@
+// Host benchmark for the display backends, on the fake Wire bus with SimPanel
+// decoding what arrives. Built once per backend by bench/run_page_bench.sh,
+// framebuffer, display list and display list on the async TWI driver:
+// each build draws the same screens, flushes them, and reports the display's
+// own RAM, the I2C bytes and bus time per flush and the host time to draw and
+// flush a screen, then the bus load of a scrolling terminal. The panel
+// checksum must match between builds, since every backend has to put the same
+// pixels on the glass.
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <stdio.h>
+#include <chrono>
+#include "minux_config.h"
+#include "minux_kernel.h"
+#include "minux_display.h"
+#include "minux_input.h"
+#include "minux_scheduler.h"
+#include "minux_fs.h"
+#include "minux_shell.h"
+#include "minux_timer.h"
+#include "minux_sound.h"
+#include "sim_panel.h"
+
+#if DISPLAY_PAGE_MODE
+DisplayList display;
+#else
+Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET);
+#endif
+MinuxTimers timers;
+MinuxKernel kernel;
+MinuxInput input;
+MinuxSound sound;
+MinuxDisplay ui(&display);
+MinuxScheduler scheduler;
+MinuxFS filesystem;
+MinuxShell shell;
+
+SimPanel panel;
+
+static unsigned failures = 0;
+
+static void check(bool ok, const char* what) {
+  if (!ok) {
+    printf("  FAILED: %s\n", what);
+    failures++;
+  }
+}
+
+static double elapsedUs(std::chrono::steady_clock::time_point since) {
+  return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - since).count();
+}
+
+static void noop() {}
+
+static void drawBoot() { ui.showBootScreen(); }
+static void drawDesktop() { ui.showDesktop(); }
+static void drawSysInfo() { ui.showSystemInfo(); }
+static void drawProcesses() { ui.showProcessList(); }
+
+static void drawHelp() {
+  ui.setTerminalMode();
+  shell.executeCommand("help");
+}
+
+struct Screen {
+  const char* label;
+  void (*draw)();
+};
+
+static const Screen screens[] = {
+  { "boot",      drawBoot },
+  { "desktop",   drawDesktop },
+  { "sysinfo",   drawSysInfo },
+  { "processes", drawProcesses },
+  { "help",      drawHelp },
+};
+
+// FNV-1a over every pixel as seen on the glass
+static uint32_t panelChecksum() {
+  uint32_t hash = 2166136261UL;
+  for (uint8_t y = 0; y < SCREEN_HEIGHT; y++) {
+    for (uint8_t x = 0; x < SCREEN_WIDTH; x++) hash = (hash ^ panel.pixel(x, y)) * 16777619UL;
+  }
+  return hash;
+}
+
+// Runs the timer wheel for whole UI frames of virtual time, so flushes go
+// out when the frame timer fires, as they do on the board
+static void runFrames(uint8_t frames) {
+  for (unsigned long ms = 0; ms < frames * (unsigned long)UI_UPDATE_MS; ms++) {
+    simAdvance(1000);
+    timers.update();
+  }
+}
+
+// Sends whatever the screen left dirty, waiting out async pages
+static void flushAll() {
+  ui.flush();
+  while (ui.isFlushing()) simAdvance(10);
+}
+
+static void screenCost(const Screen& screen, unsigned rounds, uint32_t* checksum) {
+  // One flush from a clean screen, for the bus figures and the pixels
+  screen.draw();
+  flushAll();
+  Wire.resetStats();
+  screen.draw();
+  flushAll();
+  uint32_t bytes = Wire.getBytes();
+  uint64_t busUs = Wire.getBusMicros();
+  check(bytes > 0, "screen sent nothing");
+  *checksum = *checksum * 31 + panelChecksum();
+  
+  auto t = std::chrono::steady_clock::now();
+  for (unsigned r = 0; r < rounds; r++) {
+    screen.draw();
+    flushAll();
+  }
+  double hostUs = elapsedUs(t) / rounds;
+  
+  printf("  %-10s %5lu bytes, %6.2f ms on the bus, %6.1f us host per frame\n",
+         screen.label, (unsigned long)bytes, busUs / 1000.0, hostUs);
+}
+
+// Bus load of a terminal taking one line per UI frame, each scroll moving
+// two rows of the panel
+static void scrollLoad() {
+  ui.setTerminalMode();
+  flushAll();
+  Wire.resetStats();
+#if ENABLE_ASYNC_TWI
+  twi.resetStats();
+#endif
+  unsigned long start = millis();
+  char line[TERM_COLS];
+  const uint8_t lines = 64;
+  for (uint8_t i = 0; i < lines; i++) {
+    snprintf(line, sizeof(line), "scrolled line %u", i);
+    ui.println(line);
+    runFrames(1);
+  }
+  unsigned long window = millis() - start;
+  
+  printf("  scrolling  %5lu bytes per line, %6.2f ms on the bus per line, %lu%% of %lu ms busy\n",
+         (unsigned long)Wire.getBytes() / lines, Wire.getBusMicros() / 1000.0 / lines,
+         (unsigned long)(Wire.getBusMicros() / 10 / window), window);
+#if ENABLE_ASYNC_TWI
+  printf("  MinuxTWI   %lu bytes in %u transfers, %u errors, %u%% utilization\n",
+         (unsigned long)twi.getByteCount(), twi.getTransferCount(), twi.getErrorCount(),
+         twi.getUtilization());
+  check(twi.getErrorCount() == 0, "transfers failed");
+  check(twi.getUtilization() == Wire.getBusMicros() / 10 / window, "utilization disagrees with the bus");
+#endif
+}
+
+int main(int argc, char** argv) {
+  unsigned rounds = argc > 1 ? atoi(argv[1]) : 2000;
+  
+  Wire.attach(SCREEN_ADDRESS, &panel);
+  Wire.setClock(TWI_CLOCK_HZ);
+  timers.init();
+  kernel.init();
+#if DISPLAY_PAGE_MODE
+  display.begin(SCREEN_ADDRESS);
+#else
+  display.begin(SSD1306_SWITCHCAPVCC, SCREEN_ADDRESS);
+#endif
+  ui.init();
+  scheduler.init();
+  filesystem.init();
+  scheduler.startProcess("shell", noop, 100, 2);
+  scheduler.startProcess("status", noop, 1000, 1);
+  
+#if DISPLAY_PAGE_MODE
+  printf("Display list: %u ops, %u text bytes, one %u byte page; object %lu bytes on this host\n",
+         DISPLAY_LIST_OPS, DISPLAY_TEXT_POOL, SCREEN_WIDTH, (unsigned long)sizeof(display));
+#else
+  printf("Framebuffer: %u bytes from begin(); object %lu bytes on this host\n",
+         SCREEN_WIDTH * SCREEN_HEIGHT / 8, (unsigned long)sizeof(display));
+#endif
+  printf("Screens at %lu kHz, %u rounds%s\n", (unsigned long)(TWI_CLOCK_HZ / 1000), rounds,
+         ENABLE_ASYNC_TWI ? ", async TWI" : "");
+  
+  uint32_t checksum = 0;
+  for (const Screen& screen : screens) screenCost(screen, rounds, &checksum);
+  scrollLoad();
+  checksum = checksum * 31 + panelChecksum();
+  printf("  panel checksum %08lx\n", (unsigned long)checksum);
+  
+  printf("%s\n", failures ? "FAILED" : "ok");
+  return failures ? 1 : 0;
+}
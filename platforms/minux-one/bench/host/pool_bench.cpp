@@ -0,0 +1,157 @@
+// Host test and benchmark for the kernel's block pools: class selection,
+// spilling into larger classes, exhaustion and the statistics, then a random
+// alloc/free stress against malloc with the same request stream.
+// Built with ENABLE_POOL by bench/run_pool_bench.sh.
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <chrono>
+#include "minux_kernel.h"
+#include "minux_scheduler.h"
+#include "minux_input.h"
+#include "minux_sound.h"
+
+#if !ENABLE_POOL
+#error "pool bench needs ENABLE_POOL"
+#endif
+
+MinuxKernel kernel;
+MinuxScheduler scheduler;
+MinuxTimers timers;
+MinuxInput input;
+MinuxSound sound;
+
+#define POOL_BLOCKS (POOL_SMALL_COUNT + POOL_MEDIUM_COUNT + POOL_LARGE_COUNT)
+
+static unsigned failures = 0;
+
+static void check(bool ok, const char* what) {
+  if (!ok) {
+    printf("  FAILED: %s\n", what);
+    failures++;
+  }
+}
+
+static double elapsedUs(std::chrono::steady_clock::time_point since) {
+  return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - since).count();
+}
+
+static PoolInfo pool(uint8_t c) {
+  return kernel.getMemoryInfo().pools[c];
+}
+
+static void unitChecks() {
+  printf("Pools of %u, %u and %u bytes, %u blocks in %u bytes\n",
+         POOL_SMALL_SIZE, POOL_MEDIUM_SIZE, POOL_LARGE_SIZE, POOL_BLOCKS, POOL_ARENA_SIZE);
+  
+  // Smallest class that fits
+  void* a = kernel.poolAlloc(1);
+  void* b = kernel.poolAlloc(POOL_SMALL_SIZE + 1);
+  void* c = kernel.poolAlloc(POOL_LARGE_SIZE);
+  check(a && b && c, "fitting requests refused");
+  check(pool(0).used == 1 && pool(1).used == 1 && pool(2).used == 1, "request served by the wrong class");
+  kernel.poolFree(a);
+  kernel.poolFree(b);
+  kernel.poolFree(c);
+  check(pool(0).used == 0 && pool(1).used == 0 && pool(2).used == 0, "free did not return blocks");
+  
+  // Nothing for empty or oversized requests; the oversized one is charged
+  check(!kernel.poolAlloc(0), "zero-size request served");
+  check(!kernel.poolAlloc(POOL_LARGE_SIZE + 1), "oversized request served");
+  check(pool(POOL_CLASSES - 1).failures == 1, "oversized request not counted");
+  kernel.poolFree(nullptr);
+  
+  // Small requests spill up once their class is dry, then fail
+  void* blocks[POOL_BLOCKS];
+  for (unsigned i = 0; i < POOL_BLOCKS; i++) {
+    blocks[i] = kernel.poolAlloc(1);
+    check(blocks[i] != nullptr, "small request did not spill into a larger class");
+    memset(blocks[i], i, POOL_SMALL_SIZE);
+  }
+  check(!kernel.poolAlloc(1), "served more blocks than the arena holds");
+  check(pool(0).failures == 1, "exhausted request not counted");
+  for (uint8_t k = 0; k < POOL_CLASSES; k++) check(pool(k).used == pool(k).blocks, "class not full");
+  
+  // Blocks must not overlap
+  bool intact = true;
+  for (unsigned i = 0; i < POOL_BLOCKS; i++) {
+    for (unsigned j = 0; j < POOL_SMALL_SIZE; j++) intact = intact && ((uint8_t*)blocks[i])[j] == (uint8_t)i;
+  }
+  check(intact, "blocks overlap");
+  
+  for (unsigned i = 0; i < POOL_BLOCKS; i++) kernel.poolFree(blocks[i]);
+  for (uint8_t k = 0; k < POOL_CLASSES; k++) {
+    check(pool(k).used == 0, "blocks leaked");
+    check(pool(k).peak == pool(k).blocks, "peak not recorded");
+  }
+  printf("  classes, spill, exhaustion and stats %s\n\n", failures ? "FAILED" : "ok");
+}
+
+// Random allocs and frees over a live set of up to `live` blocks, sizes up
+// to the largest class. Both allocators see the same sequence.
+struct Op {
+  uint16_t size;    // 0 for a free
+  uint8_t slot;
+};
+
+static double run(const Op* ops, unsigned count, unsigned live, bool pooled, unsigned& refused) {
+  void* held[POOL_BLOCKS] = {};
+  refused = 0;
+  auto t = std::chrono::steady_clock::now();
+  for (unsigned i = 0; i < count; i++) {
+    const Op& op = ops[i];
+    if (op.size) {
+      held[op.slot] = pooled ? kernel.poolAlloc(op.size) : malloc(op.size);
+      if (held[op.slot]) ((uint8_t*)held[op.slot])[0] = op.slot;
+      else refused++;
+    } else {
+      if (pooled) kernel.poolFree(held[op.slot]);
+      else free(held[op.slot]);
+      held[op.slot] = nullptr;
+    }
+  }
+  double us = elapsedUs(t);
+  for (unsigned s = 0; s < live; s++) {
+    if (pooled) kernel.poolFree(held[s]);
+    else free(held[s]);
+  }
+  return us;
+}
+
+// Returns the requests the pool refused
+static unsigned stress(unsigned count, unsigned live, uint16_t maxSize) {
+  Op* ops = new Op[count];
+  bool used[POOL_BLOCKS] = {};
+  for (unsigned i = 0; i < count; i++) {
+    uint8_t slot = random(live);
+    ops[i].slot = slot;
+    ops[i].size = used[slot] ? 0 : 1 + random(maxSize);
+    used[slot] = !used[slot];
+  }
+  
+  unsigned poolRefused, mallocRefused;
+  double poolUs = run(ops, count, live, true, poolRefused);
+  double mallocUs = run(ops, count, live, false, mallocRefused);
+  printf("  live %2u, up to %2u B   pool %5.1f ns, malloc %5.1f ns per op, pool refused %u\n",
+         live, maxSize, poolUs * 1000 / count, mallocUs * 1000 / count, poolRefused);
+  check(mallocRefused == 0, "malloc refused a request");
+  for (uint8_t k = 0; k < POOL_CLASSES; k++) check(pool(k).used == 0, "blocks leaked under stress");
+  delete[] ops;
+  return poolRefused;
+}
+
+int main(int argc, char** argv) {
+  unsigned count = argc > 1 ? atoi(argv[1]) : 200000;
+  
+  unitChecks();
+  
+  printf("Random alloc/free, %u ops\n", count);
+  // Fits the smallest class, so the pool must never refuse
+  check(stress(count, POOL_SMALL_COUNT, POOL_SMALL_SIZE) == 0, "refused while the pool had room");
+  // As many live blocks as the arena holds, any size: large requests are
+  // refused once the large class is taken, where malloc would carry on
+  stress(count, POOL_BLOCKS, POOL_LARGE_SIZE);
+  
+  printf("%s\n", failures ? "FAILED" : "ok");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,132 @@
+// Host benchmark for scheduler dispatch: tick() with the priority-bitmap
+// ready queue against the old linear PCB scan, with MAX_PROCESSES entries
+// at mixed intervals and priorities. bench/run_sched_bench.sh builds it for
+// 8 and 32 entries. Both sides must run the entries the same number of times.
+// The scan never traced, so the queue is compared with tracing off and its
+// traced cost is printed on its own line.
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <chrono>
+#include "minux_scheduler.h"
+#include "minux_input.h"
+#include "minux_sound.h"
+#include "minux_trace.h"
+
+MinuxScheduler scheduler;
+MinuxTimers timers;
+MinuxKernel kernel;
+MinuxInput input;
+MinuxSound sound;
+
+static unsigned long runs = 0;
+
+static void task() {
+  runs++;
+}
+
+// Entry i runs every 10, 20, 40, 80 or 160 ms, so a few are due per tick
+static unsigned long intervalOf(unsigned i) {
+  return TIMER_TICK_MS << (i % 5);
+}
+
+// What tick() did before the ready queue: every entry checked every tick
+struct ScanEntry {
+  void (*function)();
+  unsigned long interval;
+  unsigned long lastRun;
+  bool active;
+  bool preemptive;
+  ProcessState state;
+};
+
+static ScanEntry scanTable[MAX_PROCESSES];
+
+static void scanTick() {
+  unsigned long now = millis();
+  for (int i = 0; i < MAX_PROCESSES; i++) {
+    ScanEntry* pcb = &scanTable[i];
+    if (pcb->preemptive) continue;
+    if (pcb->active && pcb->state == PROC_READY) {
+      if (now - pcb->lastRun >= pcb->interval) {
+        pcb->state = PROC_RUNNING;
+        pcb->function();
+        pcb->lastRun = now;
+        pcb->state = PROC_READY;
+      }
+    }
+  }
+}
+
+static double elapsedUs(std::chrono::steady_clock::time_point since) {
+  return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - since).count();
+}
+
+// Runs one side for the given number of ticks, advancing virtual time a
+// tick between calls; returns wall time spent inside the tick function
+static double drive(void (*tickFn)(), unsigned ticks) {
+  double us = 0;
+  for (unsigned t = 0; t < ticks; t++) {
+    simAdvance(TIMER_TICK_MS * 1000UL);
+    auto start = std::chrono::steady_clock::now();
+    tickFn();
+    us += elapsedUs(start);
+  }
+  return us;
+}
+
+static void queueTick() {
+  scheduler.tick();
+}
+
+int main(int argc, char** argv) {
+  unsigned ticks = argc > 1 ? atoi(argv[1]) : 20000;
+  unsigned failures = 0;
+  
+  timers.init();
+  scheduler.init();
+  for (unsigned i = 0; i < MAX_PROCESSES; i++) {
+    char name[8];
+    snprintf(name, sizeof(name), "t%u", i);
+    if (!scheduler.startProcess(name, task, intervalOf(i), i % NUM_PRIORITIES)) failures++;
+    scanTable[i] = { task, intervalOf(i), millis(), true, false, PROC_READY };
+  }
+  
+  printf("Dispatch with %u entries, %u ticks of %u ms\n", MAX_PROCESSES, ticks, TIMER_TICK_MS);
+  
+#if ENABLE_DEBUG
+  trace.setEnabled(false);
+#endif
+  runs = 0;
+  double queueUs = drive(queueTick, ticks);
+  unsigned long queueRuns = runs;
+  
+#if ENABLE_DEBUG
+  trace.setEnabled(true);
+  runs = 0;
+  double tracedUs = drive(queueTick, ticks);
+  unsigned long tracedRuns = runs;
+#endif
+  
+  runs = 0;
+  double scanUs = drive(scanTick, ticks);
+  unsigned long scanRuns = runs;
+  
+  printf("  ready queue %7.1f ns per tick, %5.1f ns per dispatch, %lu runs\n",
+         queueUs * 1000 / ticks, queueUs * 1000 / queueRuns, queueRuns);
+#if ENABLE_DEBUG
+  printf("  traced      %7.1f ns per tick, %5.1f ns per dispatch, %lu runs\n",
+         tracedUs * 1000 / ticks, tracedUs * 1000 / tracedRuns, tracedRuns);
+#endif
+  printf("  linear scan %7.1f ns per tick, %5.1f ns per dispatch, %lu runs\n",
+         scanUs * 1000 / ticks, scanUs * 1000 / scanRuns, scanRuns);
+  
+  // The first run of each queued entry is one tick later than the scan's
+  unsigned long diff = queueRuns > scanRuns ? queueRuns - scanRuns : scanRuns - queueRuns;
+  if (diff > MAX_PROCESSES) {
+    printf("  FAILED: run counts differ by %lu\n", diff);
+    failures++;
+  }
+  printf("%s\n\n", failures ? "FAILED" : "ok");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,142 @@
+// Host test for tickless idle: the fold of a Timer1 count back into millis()
+// and the overflow count behind micros(), the simulated sleep's uptime
+// accounting, and an early wake on a button edge, which must leave the press
+// to the main loop rather than sleep on it. Idle current and the board's
+// wake-up latency need hardware and are not measured here. Built by
+// bench/run_sleep_bench.sh.
+
+#include <Arduino.h>
+#include <stdio.h>
+#include "minux_config.h"
+#include "minux_kernel.h"
+#include "minux_input.h"
+#include "minux_scheduler.h"
+#include "minux_sound.h"
+#include "minux_timer.h"
+
+MinuxTimers timers;
+MinuxKernel kernel;
+MinuxInput input;
+MinuxSound sound;
+MinuxScheduler scheduler;
+
+// Timer1 at clk/1024 and Timer0 overflows, as on the board
+#define TIMER1_PER_SECOND   (F_CPU / 1024)
+#define OVERFLOW_US         (64UL * 256 * 1000000 / F_CPU)
+
+static unsigned failures = 0;
+
+static void check(bool ok, const char* what) {
+  if (!ok) {
+    printf("  FAILED: %s\n", what);
+    failures++;
+  }
+}
+
+static SoftTimer alarm;
+static unsigned fired = 0;
+
+static void onAlarm(void*) {
+  fired++;
+}
+
+// Random sleeps of up to MAX_SLEEP_MS: whatever the split, the folded totals
+// must equal the exact conversion of the summed count, and millis() and
+// micros() must never drift apart by more than one overflow
+static void foldChecks(unsigned count) {
+  uint64_t total = 0, ms = 0, overflows = 0;
+  uint64_t worstSkew = 0;
+  
+  for (unsigned n = 0; n < count; n++) {
+    uint16_t elapsed = random(1, MAX_SLEEP_MS * TIMER1_PER_SECOND / 1000 + 1);
+    uint16_t ov;
+    total += elapsed;
+    ms += kernel.foldSleep(elapsed, &ov);
+    overflows += ov;
+    
+    uint64_t millisUs = ms * 1000, microsUs = overflows * OVERFLOW_US;
+    uint64_t skew = millisUs > microsUs ? millisUs - microsUs : microsUs - millisUs;
+    if (skew > worstSkew) worstSkew = skew;
+  }
+  
+  printf("Sleep fold, %u random sleeps, %.1f s of Timer1 counts\n", count, (double)total / TIMER1_PER_SECOND);
+  printf("  millis() %s, micros() overflows %s, worst skew between them %lu us\n\n",
+         ms == total * 1000 / TIMER1_PER_SECOND ? "exact" : "drifted",
+         overflows == total / (OVERFLOW_US * TIMER1_PER_SECOND / 1000000) ? "exact" : "drifted",
+         (unsigned long)worstSkew);
+  check(ms == total * 1000 / TIMER1_PER_SECOND, "millis() drifted across sleeps");
+  check(overflows == total / (OVERFLOW_US * TIMER1_PER_SECOND / 1000000), "overflow count drifted across sleeps");
+  check(worstSkew < OVERFLOW_US, "millis() and micros() drifted apart");
+}
+
+static void sleepChecks() {
+  InputRecord out[INPUT_QUEUE_SIZE];
+  
+  // Sleeps run to the next deadline and land in uptime once. Past the first
+  // wheel level nextExpiry() is only a lower bound, so the loop may wake
+  // early and sleep again, as the main loop would.
+  unsigned long up = kernel.getUptime();
+  unsigned long us = micros();
+  unsigned long asleep = kernel.getSleepTime();
+  unsigned long wakes = kernel.getWakeCount();
+  timers.arm(&alarm, 500, onAlarm);
+  while (!fired && millis() < 1000) {
+    kernel.idle();
+    timers.update();
+  }
+  unsigned long slept = kernel.getUptime() - up;
+  check(fired == 1, "alarm did not fire after the sleep");
+  check(slept >= 500 && slept <= 500 + TIMER_TICK_MS, "sleep did not run to the deadline");
+  check(micros() - us == slept * 1000, "micros() and uptime disagree across the sleep");
+  check(kernel.getSleepTime() - asleep == slept, "slept time not accounted");
+  check(kernel.getWakeCount() - wakes <= 2, "woke more than the wheel's bound needs");
+  
+  // An edge 200 ms into a 1 s sleep ends it there; the runner's horizon
+  // stands in for the pin-change interrupt
+  timers.arm(&alarm, 1000, onAlarm);
+  unsigned long start = millis();
+  asleep = kernel.getSleepTime();
+  simSetHorizon(start + 200);
+  kernel.idle();
+  simSetHorizon(~0UL);
+  unsigned long edgeAt = millis();
+  check(edgeAt - start == 200, "early wake did not end the sleep at the edge");
+  check(kernel.getSleepTime() - asleep == 200, "early wake accounted the whole planned sleep");
+  simSetPin(PIN_BUTTON_A, LOW);
+  input.onPinChange();
+  
+  // The queued press keeps idle() awake until the loop has read it
+  kernel.idle();
+  check(millis() == edgeAt, "idle slept on a queued press");
+  uint8_t n = input.read(out, INPUT_QUEUE_SIZE);
+  check(n == 1 && out[0].event == EVENT_BTN_A, "press lost");
+  unsigned long handled = millis();
+  if (n == 1) check(out[0].timestamp == edgeAt, "press stamped late");
+  
+  // Drained, it sleeps on to the alarm
+  while (fired < 2 && millis() < start + 2000) {
+    kernel.idle();
+    timers.update();
+  }
+  check(fired == 2 && millis() - start >= 1000, "sleep after the press did not reach the alarm");
+  simSetPin(PIN_BUTTON_A, HIGH);
+  
+  printf("Simulated sleep: deadline, uptime, micros(), early wake and queued press %s\n",
+         failures ? "FAILED" : "ok");
+  printf("  press read %lu ms after the edge that woke the sleep (virtual time)\n\n", handled - edgeAt);
+}
+
+int main(int argc, char** argv) {
+  unsigned count = argc > 1 ? atoi(argv[1]) : 100000;
+  
+  timers.init();
+  kernel.init();
+  input.init(PIN_BUTTON_A, PIN_BUTTON_UP, PIN_BUTTON_DOWN, PIN_BUTTON_RIGHT, PIN_BUZZER);
+  input.enableBuzzer(false);
+  
+  foldChecks(count);
+  sleepChecks();
+  
+  printf("%s\n", failures ? "FAILED" : "ok");
+  return failures ? 1 : 0;
+}
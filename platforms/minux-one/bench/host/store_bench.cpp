@@ -0,0 +1,250 @@
+// Host benchmark for the EEPROM log behind MinuxFS: wear spread and
+// projected lifetime under a mixed workload, mount cost, and recovery from
+// power cuts at random points. Runs on the simulated EEPROM of the fake HAL;
+// built by bench/run_store_bench.sh.
+
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <stdio.h>
+#include <new>
+#include <map>
+#include <string>
+#include <chrono>
+#include "minux_fs.h"
+
+MinuxFS filesystem;
+MinuxTimers timers;
+
+#define ENDURANCE       100000UL  // Rated write cycles per cell (ATmega328P datasheet)
+#define LOG_LIMIT       160       // The log file starts over past this size
+
+typedef std::map<std::string, std::string> Model;
+
+static const char* const temps[] = { "t0", "t1", "t2", "t3" };
+
+// Fixed per-file slots for the in-place comparison: size word then data
+struct Slot {
+  const char* name;
+  uint16_t offset;
+  uint16_t capacity;
+};
+
+static const Slot slots[] = {
+  { "config", 0, 48 }, { "log", 50, LOG_LIMIT + 16 },
+  { "t0", 228, 64 }, { "t1", 294, 64 }, { "t2", 360, 64 }, { "t3", 426, 64 }
+};
+
+static uint32_t rng = 12345;
+static uint32_t nextRandom() {
+  rng ^= rng << 13;
+  rng ^= rng >> 17;
+  rng ^= rng << 5;
+  return rng;
+}
+
+static std::string randomBytes(unsigned length) {
+  std::string s;
+  for (unsigned i = 0; i < length; i++) s += (char)nextRandom();
+  return s;
+}
+
+static double elapsedUs(std::chrono::steady_clock::time_point since) {
+  return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - since).count();
+}
+
+// Power cycle: fresh objects over the same EEPROM
+static void reboot() {
+  new (&timers) MinuxTimers();
+  new (&filesystem) MinuxFS();
+  timers.init();
+  filesystem.init();
+}
+
+// One workload operation, applied to the model only when the filesystem
+// accepted it. Returns the payload bytes the caller asked to store.
+static unsigned step(Model& model) {
+  uint32_t pick = nextRandom() % 100;
+  const uint8_t* data;
+  
+  if (pick < 40) {
+    // Settings rewritten with small changes
+    std::string value = randomBytes(16 + nextRandom() % 17);
+    data = (const uint8_t*)value.data();
+    bool ok = model.count("config") ? filesystem.writeFile("config", data, value.size())
+                                    : filesystem.createFile("config", data, value.size());
+    if (ok) model["config"] = value;
+    return value.size();
+  }
+  
+  if (pick < 80) {
+    // Event log grown by appends
+    std::string entry = randomBytes(8 + nextRandom() % 9);
+    data = (const uint8_t*)entry.data();
+    if (!model.count("log")) {
+      if (filesystem.createFile("log", data, entry.size())) model["log"] = entry;
+    } else if (model["log"].size() + entry.size() > LOG_LIMIT) {
+      if (filesystem.writeFile("log", data, entry.size())) model["log"] = entry;
+    } else if (filesystem.appendFile("log", data, entry.size())) {
+      model["log"] += entry;
+    }
+    return entry.size();
+  }
+  
+  // Scratch files come and go
+  const char* name = temps[nextRandom() % 4];
+  if (model.count(name)) {
+    if (filesystem.deleteFile(name)) model.erase(name);
+    return 0;
+  }
+  std::string value = randomBytes(nextRandom() % 61);
+  if (filesystem.createFile(name, (const uint8_t*)value.data(), value.size())) model[name] = value;
+  return value.size();
+}
+
+// Same workload written in place into fixed slots
+static unsigned stepInPlace(Model& model) {
+  Model before = model;
+  unsigned payload = step(model);
+  for (const Slot& slot : slots) {
+    auto it = model.find(slot.name);
+    auto was = before.find(slot.name);
+    if (it == model.end()) {
+      if (was != before.end()) {
+        EEPROM.update(slot.offset, 0xFF);
+        EEPROM.update(slot.offset + 1, 0xFF);
+      }
+      continue;
+    }
+    if (was != before.end() && was->second == it->second) continue;
+    const std::string& value = it->second;
+    EEPROM.update(slot.offset, value.size() & 0xFF);
+    EEPROM.update(slot.offset + 1, value.size() >> 8);
+    for (unsigned i = 0; i < value.size() && i < slot.capacity; i++) {
+      EEPROM.update(slot.offset + 2 + i, value[i]);
+    }
+  }
+  return payload;
+}
+
+static bool matches(const Model& model) {
+  unsigned seen = 0;
+  uint8_t buffer[FS_STORE_MAX_RECORD];
+  for (uint8_t i = 0; i < filesystem.getSlotCount(); i++) {
+    FileEntry* file = filesystem.getFile(i);
+    if (!file || file->isVolatile) continue;
+    auto it = model.find(file->name);
+    if (it == model.end() || it->second.size() != file->size) return false;
+    uint16_t n = filesystem.read(file, 0, buffer, sizeof(buffer));
+    if (n != file->size || memcmp(buffer, it->second.data(), n)) return false;
+    seen++;
+  }
+  return seen == model.size();
+}
+
+static void wearReport(const char* label, unsigned long ops) {
+  uint32_t most = 0, least = 0xFFFFFFFF;
+  uint64_t total = 0;
+  for (int i = 0; i < SIM_EEPROM_SIZE; i++) {
+    uint32_t w = EEPROM.getWear(i);
+    if (w > most) most = w;
+    if (w < least) least = w;
+    total += w;
+  }
+  double mean = (double)total / SIM_EEPROM_SIZE;
+  printf("  %-9s %6.1f bytes/op, cell wear min %lu mean %.0f max %lu (max/mean %.2f)\n",
+         label, (double)total / ops, (unsigned long)least, mean, (unsigned long)most,
+         mean > 0 ? most / mean : 0.0);
+  printf("  %-9s first cell worn out after ~%.0f ops\n", "", most ? (double)ENDURANCE * ops / most : 0.0);
+}
+
+int main(int argc, char** argv) {
+  unsigned long ops = argc > 1 ? strtoul(argv[1], nullptr, 10) : 20000;
+  unsigned cuts = argc > 2 ? atoi(argv[2]) : 500;
+  unsigned failures = 0;
+  
+  printf("Layout: %u byte log at EEPROM %u, records up to %u bytes (%u overhead)\n\n",
+         FS_STORE_SIZE, FS_STORE_BASE, FS_STORE_MAX_RECORD, STORE_OVERHEAD);
+  
+  // Endurance: the same operation stream in place and through the log
+  Model model;
+  unsigned long payload = 0;
+  EEPROM.erase();
+  EEPROM.resetWear();
+  for (unsigned long i = 0; i < ops; i++) payload += stepInPlace(model);
+  printf("Endurance, %lu ops (%.1f payload bytes/op)\n", ops, (double)payload / ops);
+  wearReport("in place", ops);
+  
+  rng = 12345;
+  model.clear();
+  EEPROM.erase();
+  EEPROM.resetWear();
+  reboot();
+  uint32_t worstStep = 0;
+  for (unsigned long i = 0; i < ops; i++) {
+    step(model);
+    uint32_t writes = EEPROM.getWrites();
+    filesystem.compact();
+    writes = EEPROM.getWrites() - writes;
+    if (writes > worstStep) worstStep = writes;
+  }
+  wearReport("log", ops);
+  MinuxStore& store = filesystem.getStore();
+  printf("  log holds %u records, %u of %u bytes used, %u live\n",
+         store.getRecords(), store.getUsed(), FS_STORE_SIZE, store.getLive());
+  // The copy plus retiring the head record
+  bool bounded = worstStep <= FS_STORE_STEP + 1;
+  printf("  idle compaction step writes at most %lu bytes, %.1f ms at 3.3 ms a byte %s\n\n",
+         (unsigned long)worstStep, worstStep * 3.3, bounded ? "ok" : "FAILED");
+  if (!bounded) failures++;
+  
+  // Mount: the log the endurance run left behind, then a blank EEPROM
+  printf("Mount\n");
+  for (int pass = 0; pass < 2; pass++) {
+    if (pass == 1) EEPROM.erase();
+    EEPROM.resetStats();
+    auto t = std::chrono::steady_clock::now();
+    reboot();
+    double us = elapsedUs(t);
+    bool ok = pass == 0 ? matches(model) : matches(Model());
+    printf("  %-9s %5lu EEPROM reads, %lu writes, %u records, host %.1f us %s\n",
+           pass == 0 ? "in use" : "blank", (unsigned long)EEPROM.getReads(),
+           (unsigned long)EEPROM.getWrites(), filesystem.getStore().getRecords(), us, ok ? "ok" : "FAILED");
+    if (!ok) failures++;
+  }
+  
+  // Power cuts: lose power after a random number of byte writes, reboot,
+  // and expect either the old or the new state of every file
+  model.clear();
+  for (unsigned i = 0; i < 2000; i++) {
+    step(model);
+    filesystem.compact();
+  }
+  unsigned landed = 0, rolledBack = 0, committed = 0, torn = 0;
+  for (unsigned c = 0; c < cuts; c++) {
+    Model before = model;
+    EEPROM.cutPowerAfter(nextRandom() % 256);
+    step(model);
+    filesystem.compact();
+    bool cut = EEPROM.isPowerCut();
+    EEPROM.restorePower();
+    reboot();
+    if (cut) landed++;
+    
+    if (matches(model)) {
+      if (cut) committed++;
+    } else if (matches(before)) {
+      rolledBack++;
+      model = before;
+    } else {
+      torn++;
+      fprintf(stderr, "state lost after cut %u\n", c);
+      break;
+    }
+  }
+  printf("\nPower cuts: %u of %u runs lost power mid-operation; %u kept the old state, %u the new, %u neither\n",
+         landed, cuts, rolledBack, committed, torn);
+  if (torn) failures++;
+  
+  printf("%s\n", failures ? "FAILED" : "ok");
+  return failures ? 1 : 0;
+}
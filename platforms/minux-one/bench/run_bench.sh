@@ -0,0 +1,25 @@
+#!/bin/bash
+
+# Builds the benchmark firmware and the simavr harness, runs a script and
+# writes bench/reports/<commit>.json. BENCH_ENV picks another firmware
+# environment, e.g. bench_async.
+# Usage: [BENCH_ENV=env] bench/run_bench.sh [script]
+
+cd "$(dirname "$0")/.." || exit 1
+
+SCRIPT="${1:-bench/scripts/default.txt}"
+ENV="${BENCH_ENV:-bench}"
+LABEL="$(git rev-parse --short HEAD 2>/dev/null || echo local)"
+git diff --quiet HEAD -- . 2>/dev/null || LABEL="$LABEL-dirty"
+
+pio run -e "$ENV" || exit 1
+
+SIMAVR_CFLAGS="$(pkg-config --cflags simavr 2>/dev/null || echo -I/usr/include/simavr)"
+SIMAVR_LIBS="$(pkg-config --libs simavr 2>/dev/null || echo -lsimavr)"
+mkdir -p .pio/bench bench/reports
+cc -O2 -std=gnu99 $SIMAVR_CFLAGS -Iinclude bench/harness/simavr_bench.c \
+    -o .pio/bench/simavr_bench $SIMAVR_LIBS -lelf || exit 1
+
+.pio/bench/simavr_bench -l "$LABEL" -o "bench/reports/$LABEL.json" \
+    ".pio/build/$ENV/firmware.elf" "$SCRIPT" || exit 1
+echo "Report: bench/reports/$LABEL.json"
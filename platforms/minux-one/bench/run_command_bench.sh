@@ -0,0 +1,12 @@
+#!/bin/bash
+
+# Builds and runs the command lookup benchmark against the fake HAL
+# Usage: bench/run_command_bench.sh [rounds]
+
+cd "$(dirname "$0")/.." || exit 1
+
+mkdir -p .pio/bench
+c++ -O2 -std=gnu++11 -I sim/hal -I include \
+    bench/host/command_bench.cpp src/minux_command.cpp \
+    sim/hal/Arduino.cpp -o .pio/bench/command_bench || exit 1
+.pio/bench/command_bench "$@"
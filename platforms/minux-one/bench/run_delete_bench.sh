@@ -0,0 +1,12 @@
+#!/bin/bash
+
+# Builds and runs the delete and handle benchmark against the fake HAL
+# Usage: bench/run_delete_bench.sh [rounds]
+
+cd "$(dirname "$0")/.." || exit 1
+
+mkdir -p .pio/bench
+c++ -O2 -std=gnu++11 -D ENABLE_FS_STORE=0 -I sim/hal -I include \
+    bench/host/delete_bench.cpp src/minux_fs.cpp src/minux_timer.cpp src/minux_trace.cpp \
+    sim/hal/Arduino.cpp -o .pio/bench/delete_bench || exit 1
+.pio/bench/delete_bench "$@"
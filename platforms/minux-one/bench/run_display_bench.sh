@@ -0,0 +1,17 @@
+#!/bin/bash
+
+# Builds and runs the display benchmark against the fake HAL and SimPanel.
+# The 5x7 font comes from the Adafruit GFX library; point GFX_DIR at it if
+# `pio run -e native` has not fetched it into .pio/libdeps yet.
+# Usage: bench/run_display_bench.sh
+
+cd "$(dirname "$0")/.." || exit 1
+
+GFX_DIR=${GFX_DIR:-".pio/libdeps/native/Adafruit GFX Library"}
+
+mkdir -p .pio/bench
+c++ -O2 -std=gnu++11 -D SCREEN_WIDTH=128 -D SCREEN_HEIGHT=64 -D OLED_RESET=-1 \
+    -I sim/hal -I sim -I include -I "$GFX_DIR" \
+    bench/host/display_bench.cpp $(ls src/*.cpp | grep -v main.cpp) \
+    sim/sim_panel.cpp sim/hal/*.cpp -o .pio/bench/display_bench || exit 1
+.pio/bench/display_bench "$@"
@@ -0,0 +1,13 @@
+#!/bin/bash
+
+# Builds and runs the host filesystem benchmark against the fake HAL
+# Usage: bench/run_fs_bench.sh [rounds]
+
+cd "$(dirname "$0")/.." || exit 1
+
+# RAM heap only; the EEPROM log has its own benchmark in run_store_bench.sh
+mkdir -p .pio/bench
+c++ -O2 -std=gnu++11 -D ENABLE_FS_STORE=0 -I sim/hal -I include \
+    bench/host/fs_bench.cpp src/minux_fs.cpp src/minux_timer.cpp src/minux_trace.cpp \
+    sim/hal/Arduino.cpp -o .pio/bench/fs_bench || exit 1
+.pio/bench/fs_bench "$@"
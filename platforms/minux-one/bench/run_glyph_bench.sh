@@ -0,0 +1,18 @@
+#!/bin/bash
+
+# Builds and runs the text blitter test and benchmark against the fake HAL.
+# The 5x7 font comes from the Adafruit GFX library; point GFX_DIR at it if
+# `pio run -e native` has not fetched it into .pio/libdeps yet.
+# Usage: bench/run_glyph_bench.sh [rounds]
+
+cd "$(dirname "$0")/.." || exit 1
+
+GFX_DIR=${GFX_DIR:-".pio/libdeps/native/Adafruit GFX Library"}
+
+mkdir -p .pio/bench
+c++ -O2 -std=gnu++11 -D SCREEN_WIDTH=128 -D SCREEN_HEIGHT=64 -D OLED_RESET=-1 \
+    -I sim/hal -I include -I "$GFX_DIR" \
+    bench/host/glyph_bench.cpp src/minux_glyph.cpp \
+    sim/hal/Adafruit_GFX.cpp sim/hal/Adafruit_SSD1306.cpp sim/hal/Wire.cpp sim/hal/Arduino.cpp \
+    -o .pio/bench/glyph_bench || exit 1
+.pio/bench/glyph_bench "$@"
@@ -0,0 +1,12 @@
+#!/bin/bash
+
+# Builds and runs the button capture test and benchmark against the fake HAL
+# Usage: bench/run_input_bench.sh [presses]
+
+cd "$(dirname "$0")/.." || exit 1
+
+mkdir -p .pio/bench
+c++ -O2 -std=gnu++11 -I sim/hal -I include \
+    bench/host/input_bench.cpp src/minux_input.cpp src/minux_sound.cpp src/minux_trace.cpp \
+    sim/hal/Arduino.cpp -o .pio/bench/input_bench || exit 1
+.pio/bench/input_bench "$@"
@@ -0,0 +1,15 @@
+#!/bin/bash
+
+# Builds and runs the line discipline test and benchmark against the fake
+# HAL, with the C allocator wrapped (and not a builtin the compiler could
+# elide) so heap use can be counted
+# Usage: bench/run_line_bench.sh [rounds]
+
+cd "$(dirname "$0")/.." || exit 1
+
+mkdir -p .pio/bench
+c++ -O2 -std=gnu++11 -fno-builtin-malloc -fno-builtin-free -I sim/hal -I include \
+    bench/host/line_bench.cpp src/minux_line.cpp src/minux_command.cpp \
+    sim/hal/Arduino.cpp -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc \
+    -o .pio/bench/line_bench || exit 1
+.pio/bench/line_bench "$@"
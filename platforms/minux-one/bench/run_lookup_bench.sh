@@ -0,0 +1,22 @@
+#!/bin/bash
+
+# Builds and runs the name lookup benchmark against the fake HAL for
+# 16, 64 and 254 entries (entry numbers are bytes, so 254 is the ceiling)
+# Usage: bench/run_lookup_bench.sh [rounds]
+
+cd "$(dirname "$0")/.." || exit 1
+
+mkdir -p .pio/bench
+rc=0
+for config in "16 32" "64 128" "254 512"; do
+  set -- $config "$@"
+  files=$1
+  slots=$2
+  shift 2
+  c++ -O2 -std=gnu++11 -D ENABLE_FS_STORE=0 -D MAX_FILES=$files -D FS_HASH_SLOTS=$slots \
+      -I sim/hal -I include \
+      bench/host/lookup_bench.cpp src/minux_fs.cpp src/minux_timer.cpp src/minux_trace.cpp \
+      sim/hal/Arduino.cpp -o .pio/bench/lookup_bench_$files || exit 1
+  .pio/bench/lookup_bench_$files "$@" || rc=1
+done
+exit $rc
@@ -0,0 +1,32 @@
+#!/bin/bash
+
+# Builds the page bench once per display backend: framebuffer, display list,
+# and display list on the async TWI driver. Runs all three and checks they
+# put the same pixels on the panel. The 5x7 font comes from the Adafruit GFX
+# library; point GFX_DIR at it if `pio run -e native` has not fetched it into
+# .pio/libdeps yet.
+# Usage: bench/run_page_bench.sh [rounds]
+
+cd "$(dirname "$0")/.." || exit 1
+
+GFX_DIR=${GFX_DIR:-".pio/libdeps/native/Adafruit GFX Library"}
+
+mkdir -p .pio/bench
+status=0
+for backend in "0 0" "1 0" "1 1"; do
+  read -r page async <<< "$backend"
+  name=page_bench_$page$async
+  c++ -O2 -std=gnu++11 -D SCREEN_WIDTH=128 -D SCREEN_HEIGHT=64 -D OLED_RESET=-1 \
+      -D DISPLAY_PAGE_MODE=$page -D ENABLE_ASYNC_TWI=$async -I sim/hal -I sim -I include -I "$GFX_DIR" \
+      bench/host/page_bench.cpp $(ls src/*.cpp | grep -v main.cpp) \
+      sim/sim_panel.cpp sim/hal/*.cpp -o .pio/bench/$name || exit 1
+  .pio/bench/$name "$@" | tee .pio/bench/$name.txt
+  [ "${PIPESTATUS[0]}" = 0 ] || status=1
+  echo
+done
+
+if [ "$(grep -h checksum .pio/bench/page_bench_*.txt | sort -u | wc -l)" != 1 ]; then
+  echo "FAILED: the backends put different pixels on the panel"
+  status=1
+fi
+exit $status
@@ -0,0 +1,13 @@
+#!/bin/bash
+
+# Builds and runs the block pool test and benchmark against the fake HAL
+# Usage: bench/run_pool_bench.sh [ops]
+
+cd "$(dirname "$0")/.." || exit 1
+
+mkdir -p .pio/bench
+c++ -O2 -std=gnu++11 -D ENABLE_POOL=1 -I sim/hal -I include \
+    bench/host/pool_bench.cpp src/minux_kernel.cpp src/minux_scheduler.cpp src/minux_timer.cpp \
+    src/minux_input.cpp src/minux_sound.cpp src/minux_trace.cpp \
+    sim/hal/Arduino.cpp -o .pio/bench/pool_bench || exit 1
+.pio/bench/pool_bench "$@"
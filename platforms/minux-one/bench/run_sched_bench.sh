@@ -0,0 +1,18 @@
+#!/bin/bash
+
+# Builds and runs the scheduler dispatch benchmark against the fake HAL for
+# 8 and 32 entries
+# Usage: bench/run_sched_bench.sh [ticks]
+
+cd "$(dirname "$0")/.." || exit 1
+
+mkdir -p .pio/bench
+rc=0
+for processes in 8 32; do
+  c++ -O2 -std=gnu++11 -D MAX_PROCESSES=$processes -I sim/hal -I include \
+      bench/host/sched_bench.cpp src/minux_scheduler.cpp src/minux_timer.cpp src/minux_kernel.cpp \
+      src/minux_input.cpp src/minux_sound.cpp src/minux_trace.cpp \
+      sim/hal/Arduino.cpp -o .pio/bench/sched_bench_$processes || exit 1
+  .pio/bench/sched_bench_$processes "$@" || rc=1
+done
+exit $rc
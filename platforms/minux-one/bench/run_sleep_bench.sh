@@ -0,0 +1,13 @@
+#!/bin/bash
+
+# Builds and runs the tickless idle test against the fake HAL
+# Usage: bench/run_sleep_bench.sh [sleeps]
+
+cd "$(dirname "$0")/.." || exit 1
+
+mkdir -p .pio/bench
+c++ -O2 -std=gnu++11 -I sim/hal -I include \
+    bench/host/sleep_bench.cpp src/minux_kernel.cpp src/minux_timer.cpp src/minux_scheduler.cpp \
+    src/minux_input.cpp src/minux_sound.cpp src/minux_trace.cpp \
+    sim/hal/Arduino.cpp -o .pio/bench/sleep_bench || exit 1
+.pio/bench/sleep_bench "$@"
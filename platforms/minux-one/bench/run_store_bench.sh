@@ -0,0 +1,12 @@
+#!/bin/bash
+
+# Builds and runs the EEPROM log benchmark against the fake HAL
+# Usage: bench/run_store_bench.sh [ops] [power cuts]
+
+cd "$(dirname "$0")/.." || exit 1
+
+mkdir -p .pio/bench
+c++ -O2 -std=gnu++11 -I sim/hal -I include \
+    bench/host/store_bench.cpp src/minux_fs.cpp src/minux_store.cpp src/minux_timer.cpp src/minux_trace.cpp \
+    sim/hal/Arduino.cpp sim/hal/EEPROM.cpp -o .pio/bench/store_bench || exit 1
+.pio/bench/store_bench "$@"
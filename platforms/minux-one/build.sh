@@ -1,7 +1,7 @@
 #!/bin/bash
 
 # Minux RTOS Build Script
-# Usage: ./build.sh [clean|build|upload|monitor|all]
+# Usage: ./build.sh [clean|build|upload|monitor|all|bench]
 
 PROJECT_DIR="$(dirname "$0")"
 cd "$PROJECT_DIR"
@@ -30,9 +30,13 @@ case "$1" in
         sleep 2
         pio device monitor --baud 115200
         ;;
+    "bench")
+        echo "Running cycle benchmark under simavr..."
+        ./bench/run_bench.sh "${@:2}"
+        ;;
     *)
         echo "Minux RTOS Build Script"
-        echo "Usage: $0 [clean|build|upload|monitor|all]"
+        echo "Usage: $0 [clean|build|upload|monitor|all|bench]"
         echo ""
         echo "Commands:"
         echo "  clean   - Clean build files"
@@ -40,5 +44,6 @@ case "$1" in
         echo "  upload  - Upload to Arduino"
         echo "  monitor - Start serial monitor"
         echo "  all     - Build, upload, and monitor"
+        echo "  bench   - Cycle benchmark under simavr [script]"
         ;;
 esac
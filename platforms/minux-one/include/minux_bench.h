@@ -0,0 +1,58 @@
+#ifndef MINUX_BENCH_H
+#define MINUX_BENCH_H
+
+// Cycle markers for the simavr benchmark (bench/). A marker is one write of
+// (id << 1) | edge to GPIOR0, which nothing else uses; the harness timestamps
+// every write with the simulator's cycle counter. Plain C so the harness can
+// share the marker list.
+
+#include <stdint.h>
+#include "minux_config.h"
+
+// id, report name
+#define BENCH_MARKERS(X) \
+  X(SCHED_TICK,    "sched.tick")    \
+  X(SCHED_TASK,    "sched.task")    \
+  X(SHELL_COMMAND, "shell.command") \
+  X(FS_OPEN,       "fs.open")       \
+  X(FS_CREATE,     "fs.create")     \
+  X(FS_WRITE,      "fs.write")      \
+  X(FS_READ,       "fs.read")       \
+  X(FS_DELETE,     "fs.delete")     \
+  X(FS_APPEND,     "fs.append")     \
+  X(DISPLAY_FLUSH, "display.flush")
+  
+#define BENCH_ENUM(id, name) BENCH_##id,
+enum BenchMarker {
+  BENCH_NONE,               // 0 is never written, so a cleared GPIOR0 means nothing
+  BENCH_MARKERS(BENCH_ENUM)
+  BENCH_COUNT
+};
+#undef BENCH_ENUM
+
+#define BENCH_BEGIN_EDGE 0
+#define BENCH_END_EDGE   1
+
+#if ENABLE_BENCH && defined(__AVR__)
+#include <avr/io.h>
+#define BENCH_MARK(id, edge) (GPIOR0 = (uint8_t)(((id) << 1) | (edge)))
+#else
+#define BENCH_MARK(id, edge) ((void)0)
+#endif
+
+#define BENCH_BEGIN(id) BENCH_MARK(BENCH_##id, BENCH_BEGIN_EDGE)
+#define BENCH_END(id)   BENCH_MARK(BENCH_##id, BENCH_END_EDGE)
+
+// Marks the rest of the enclosing block, every return path included
+#if defined(__cplusplus) && ENABLE_BENCH
+struct BenchScope {
+  uint8_t id;
+  BenchScope(uint8_t marker) : id(marker) { BENCH_MARK(id, BENCH_BEGIN_EDGE); }
+  ~BenchScope() { BENCH_MARK(id, BENCH_END_EDGE); }
+};
+#define BENCH_SCOPE(id) BenchScope benchScope(BENCH_##id)
+#else
+#define BENCH_SCOPE(id) ((void)0)
+#endif
+
+#endif
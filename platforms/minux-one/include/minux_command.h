@@ -0,0 +1,65 @@
+#ifndef MINUX_COMMAND_H
+#define MINUX_COMMAND_H
+
+#include <Arduino.h>
+#include "minux_config.h"
+
+#define CMD_NAME_LEN   10   // Longest name plus terminator
+#define CMD_HELP_LEN   28
+
+typedef void (*CommandHandler)(uint8_t argc, char** argv);
+
+// One row of a command table. Names and help text are stored inline so a
+// whole table is a single PROGMEM object; only the row being run is copied
+// into SRAM.
+struct Command {
+  char name[CMD_NAME_LEN];
+  char help[CMD_HELP_LEN];
+  CommandHandler handler;
+};
+
+// Compile-time order check, so lookups can binary search
+constexpr int commandCompare(const char* a, const char* b) {
+  return (*a != *b || !*a) ? *a - *b : commandCompare(a + 1, b + 1);
+}
+
+template <uint8_t N>
+constexpr bool commandsSorted(const Command (&table)[N], uint8_t i = 1) {
+  return i >= N || (commandCompare(table[i - 1].name, table[i].name) < 0 && commandsSorted(table, i + 1));
+}
+
+#define COMMAND_TABLE_CHECK(table) \
+  static_assert(commandsSorted(table), #table " must be sorted by name")
+  
+#define COMMAND_COUNT(table) (sizeof(table) / sizeof(Command))
+
+// Binary search of a sorted PROGMEM table, nullptr when unknown
+const Command* findCommand(const Command* table, uint8_t count, const char* name);
+
+// Looks the command up and runs it with out as its console; false if there
+// is no such command
+bool runCommand(const Command* table, uint8_t count, uint8_t argc, char** argv, Print& out = Serial);
+
+// Console of the command being run, for rows shared between tables
+Print& commandOut();
+
+// Lists the table the running command came from
+void commandHelp(uint8_t, char**);
+
+#define COMMAND_HELP { "help", "Show this help", commandHelp }
+
+// Prints "name - help" for every row, works with Serial or the display
+template <typename Out>
+void printCommandHelp(Out& out, const Command* table, uint8_t count) {
+  char buf[CMD_HELP_LEN];
+  for (uint8_t i = 0; i < count; i++) {
+    strcpy_P(buf, table[i].name);
+    out.print(buf);
+    for (uint8_t n = strlen(buf); n < CMD_NAME_LEN; n++) out.print(" ");
+    out.print("- ");
+    strcpy_P(buf, table[i].help);
+    out.println(buf);
+  }
+}
+
+#endif
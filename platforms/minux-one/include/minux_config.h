@@ -24,23 +24,89 @@
 #define PIN_BUTTON_RIGHT    7
 
 // System Limits
-#define MAX_PROCESSES       8
+#ifndef MAX_PROCESSES
+#define MAX_PROCESSES       8       // At most 127, entries are indexed by int8_t
+#endif
+#define NUM_PRIORITIES      8       // 0 = lowest, 7 = highest
+#define JITTER_BUCKETS      8       // log2 buckets: 0, 1, 2-3, ... 64+ ms
 #define MAX_PROCESS_NAME    16
-#define MAX_FILES           16
-#define MAX_FILENAME        12
-#define MAX_FILESIZE        256
+#ifndef MAX_FILES
+#define MAX_FILES           16      // At most 254, entries are indexed by a byte
+#endif
+#define MAX_FILENAME        12      // One path component, with its terminator
+#define FS_MAX_PATH         32      // Whole absolute path, with its terminator
 #define MAX_CMD_LENGTH      32
 
+// Filesystem Storage (file contents live in a shared block heap)
+#define FS_BLOCK_SIZE       16      // Bytes per data block
+#define FS_BLOCKS           32      // Blocks in the heap, at most 255
+#define FS_EXTENTS          FS_BLOCKS // Runs of contiguous blocks; one per block never runs out
+#ifndef FS_HASH_SLOTS
+#define FS_HASH_SLOTS       32      // Name index; a power of two, twice MAX_FILES keeps probes short
+#endif
+
+// Persistent Storage (files are logged to EEPROM, see minux_store.h)
+#ifndef ENABLE_FS_STORE
+#define ENABLE_FS_STORE     1
+#endif
+#define FS_STORE_BASE       0       // First EEPROM byte of the log
+#define FS_STORE_SIZE       1024    // Log length; all of the ATmega328P EEPROM
+#define FS_STORE_MAX_RECORD 256     // Largest record, also the room kept free for compaction
+#define FS_STORE_COMPACT    (FS_STORE_SIZE / 2) // Idle compaction starts below this much free space
+#define FS_STORE_STEP       32      // Bytes one idle compaction step copies, ~110 ms of EEPROM writes
+
 // Memory Configuration
 #define TOTAL_MEMORY        2048    // Arduino Nano SRAM
 #define STACK_SIZE          512
 #define HEAP_SIZE           768
+#define STACK_PAINT         0xC5    // Boot-time fill for watermarking
+#define STACK_GUARD_BYTES   8       // Painted margin that must stay untouched
+#define STACK_SCAN_CHUNK    32      // Bytes checked per idle pass
+
+// Pool Allocator Configuration (block size must be a power of two >= 2).
+// Off by default: the arena is POOL_ARENA_SIZE bytes of static SRAM.
+#ifndef ENABLE_POOL
+#define ENABLE_POOL         0
+#endif
+#define POOL_CLASSES        3
+#define POOL_SMALL_SIZE     16
+#define POOL_SMALL_COUNT    4
+#define POOL_MEDIUM_SIZE    32
+#define POOL_MEDIUM_COUNT   4
+#define POOL_LARGE_SIZE     64
+#define POOL_LARGE_COUNT    2
+#define POOL_ARENA_SIZE     (POOL_SMALL_SIZE * POOL_SMALL_COUNT + \
+                             POOL_MEDIUM_SIZE * POOL_MEDIUM_COUNT + \
+                             POOL_LARGE_SIZE * POOL_LARGE_COUNT)
 
 // Timing Configuration
 #define SCHEDULER_TICK_MS   10      // Scheduler time slice
 #define INPUT_DEBOUNCE_MS   50      // Button debounce time
 #define UI_UPDATE_MS        100     // UI refresh rate
 #define FS_MAINTENANCE_MS   1000    // Filesystem maintenance
+#define SYSINFO_REFRESH_MS  5000    // sysinfo file refresh
+
+// Timer Wheel Configuration
+#define TIMER_TICK_MS       SCHEDULER_TICK_MS
+#define TIMER_WHEEL_BITS    4       // 16 slots per level
+#define TIMER_WHEEL_LEVELS  3       // Direct reach of 4096 ticks
+#define MAX_SLEEP_MS        4000    // Longest tickless sleep (Timer1 at clk/1024)
+
+// Terminal Configuration
+#define TERM_SCROLLBACK     8       // Lines kept after scrolling off the top
+#define TERM_TAB_WIDTH      4
+
+// I2C Configuration
+#define TWI_CLOCK_HZ        400000  // Fast mode
+#ifndef ENABLE_ASYNC_TWI
+#define ENABLE_ASYNC_TWI    0       // Interrupt-driven TWI; replaces Wire entirely
+#endif
+
+// Preemption Configuration. The thread stacks are static: with preemption on
+// they take MAX_THREADS * THREAD_STACK_SIZE bytes (512, a quarter of the
+// Nano's SRAM) whether or not a thread is ever started.
+#define MAX_THREADS         2       // Tasks with their own stack
+#define THREAD_STACK_SIZE   (STACK_SIZE / MAX_THREADS)
 
 // Feature Flags
 #define ENABLE_SHELL        1
@@ -48,12 +114,29 @@
 #define ENABLE_SOUND        1
 #define ENABLE_SERIAL       1
 #define ENABLE_DEBUG        1
+#ifndef ENABLE_PREEMPTION
+#define ENABLE_PREEMPTION   0       // Timer1 time slicing; needs a MinuxScheduler, set by [env:bench]
+#endif
+#define ENABLE_TICKLESS     1
+#ifndef DISPLAY_PAGE_MODE
+#define DISPLAY_PAGE_MODE   0       // Render from a display list, no framebuffer
+#endif
+#ifndef ENABLE_BENCH
+#define ENABLE_BENCH        0       // Cycle markers for the simavr benchmark, set by [env:bench]
+#endif
+
+// Adafruit_SSD1306 links Wire, which owns TWI_vect as well
+#if ENABLE_ASYNC_TWI && !DISPLAY_PAGE_MODE
+#error "ENABLE_ASYNC_TWI requires DISPLAY_PAGE_MODE"
+#endif
 
 // Debug Configuration
 #if ENABLE_DEBUG
 #define DEBUG_SERIAL_SPEED  115200
 #define DEBUG_PRINT(x)      Serial.print(x)
 #define DEBUG_PRINTLN(x)    Serial.println(x)
+#define TRACE_RECORDS       32      // Trace ring, power of two, 4 bytes each
+#define TRACE_TICK_SHIFT    2       // Trace time unit: micros() >> 2, i.e. 4 us
 #else
 #define DEBUG_PRINT(x)
 #define DEBUG_PRINTLN(x)
@@ -3,6 +3,38 @@
 
 #include <Arduino.h>
 #include <Adafruit_SSD1306.h>
+#include "minux_config.h"
+#include "minux_timer.h"
+#include "minux_terminal.h"
+#include "minux_widget.h"
+
+#define DISPLAY_PAGES       (SCREEN_HEIGHT / 8)
+#define DISPLAY_I2C_CHUNK   31      // Wire buffer minus the control byte
+#define DISPLAY_STAGING     2       // Pages in flight on the async bus
+
+// Page mode draws from a display list instead of a 1 KB framebuffer
+#if DISPLAY_PAGE_MODE
+#include "minux_displaylist.h"
+typedef DisplayList DisplayTarget;
+typedef DisplayList TextTarget;
+#else
+#include "minux_glyph.h"
+typedef Adafruit_SSD1306 DisplayTarget;
+typedef GlyphBlitter TextTarget;    // Blits text into the framebuffer
+#endif
+
+#if ENABLE_ASYNC_TWI
+#include "minux_twi.h"
+
+// One page on its way to the panel: window commands, then the data
+struct PageSlot {
+  uint8_t commands[6];
+  uint8_t data[SCREEN_WIDTH];
+  TwiTransfer commandXfer;
+  TwiTransfer dataXfer;
+  volatile bool busy;
+};
+#endif
 
 // Display modes
 enum DisplayMode {
@@ -21,19 +53,61 @@ enum WindowType {
   WIN_APP
 };
 
-class MinuxDisplay {
+// Also a Print, so text commands can write to it or to Serial alike
+class MinuxDisplay : public Print {
 private:
-  Adafruit_SSD1306* display;
+  DisplayTarget* display;
+  TextTarget* writer;
+#if !DISPLAY_PAGE_MODE
+  GlyphBlitter glyphs;
+#endif
   DisplayMode currentMode;
   uint8_t cursor_x, cursor_y;
   bool inverted;
   char statusBar[17];  // Reduced from 21 (16 chars + null)
+  uint8_t statusVersion;  // Bumped on every status change
+  
+  // Dirty column range per 8-pixel page, lo > hi when the page is clean
+  uint8_t dirtyLo[DISPLAY_PAGES];
+  uint8_t dirtyHi[DISPLAY_PAGES];
+  SoftTimer frameTimer;
+  uint32_t bytesSent;
+  uint16_t flushCount;
+  
+  // Terminal grid, drawn cell by cell and scrolled by the panel
+  MinuxTerminal term;
+  uint8_t startLine;     // Display start line the panel is using
+  uint32_t charsRendered;
+  
+  void renderTerminal();
+  
+  // Retained desktop and info screens
+  MinuxWidgets widgets;
+  friend class MinuxWidgets;
+  void paintTaskbar(uint8_t y);
+  template <typename T> void emit(T value);
+  
+  void markDirty(int16_t x, int16_t y, int16_t w, int16_t h);
+  void markText(int16_t x, int16_t y);
+  static void frameDue(void* arg);
+  void sendPages(bool block);
+  
+#if ENABLE_ASYNC_TWI
+  PageSlot slots[DISPLAY_STAGING];
+  PageSlot* freeSlot();
+  static void slotDone(TwiTransfer* t);
+#endif
   
 public:
-  MinuxDisplay(Adafruit_SSD1306* disp);
+  MinuxDisplay(DisplayTarget* disp);
   void init();
   void clear();
-  void update();
+  void update();        // Requests a flush at the end of the current UI frame
+  void flush();         // Sends the dirty regions to the panel now
+  bool isFlushing();    // Async pages still on the bus
+  uint32_t getBytesSent() { return bytesSent; }
+  uint16_t getFlushCount() { return flushCount; }
+  uint32_t getCharsRendered() { return charsRendered; }
   
   // Boot sequence
   void showBootScreen();
@@ -47,6 +121,8 @@ public:
   // Terminal
   void setTerminalMode();
   void printChar(char c);
+  size_t write(uint8_t c) override;
+  using Print::write;
   void print(const char* text);
   void print(int value);
   void print(long value);
@@ -55,10 +131,14 @@ public:
   void print(uint8_t value);
   void println(const char* text);
   void setCursor(uint8_t x, uint8_t y);
+  void scrollView(int8_t lines);   // Browse terminal scrollback
+  const char* terminalRow(uint8_t row) { return term.viewRow(row); }   // TERM_COLS cells, unterminated
   
   // System info
   void showSystemInfo();
   void showProcessList();
+  void showFiles();
+  uint8_t getStatusVersion() { return statusVersion; }
   void updateStatusBar(const char* text);
   
   // Utilities
@@ -74,6 +154,8 @@ public:
 #define ICON_FILES 2
 #define ICON_MONITOR 3
 
+extern const uint8_t icons[][8] PROGMEM;
+
 extern MinuxDisplay ui;
 
 #endif
@@ -0,0 +1,92 @@
+#ifndef MINUX_DISPLAYLIST_H
+#define MINUX_DISPLAYLIST_H
+
+#include <Arduino.h>
+#include <Adafruit_GFX.h>
+#include "minux_config.h"
+#include "minux_glyph.h"
+
+#define DISPLAY_LIST_OPS    40      // Drawing operations per screen
+#define DISPLAY_TEXT_POOL   192     // Characters of text per screen
+
+// Recorded drawing operation, 6 bytes
+enum DisplayOpType {
+  OP_TEXT,
+  OP_FILL,
+  OP_RECT,
+  OP_PIXEL,
+  OP_BITMAP,      // 8x8 PROGMEM bitmap
+  OP_GRID         // A dot every w pixels (a multiple of 8), desktop background
+};
+
+struct DisplayOp {
+  uint8_t type;
+  uint8_t style;   // Colour in bits 0-1, text background 2-3, text size 4-7
+  uint8_t x, y;
+  union {
+    struct { uint8_t w, h; } size;
+    struct { uint8_t offset, length; } text;
+    const uint8_t* bitmap;
+  };
+};
+
+// Draws one 8-pixel page of the screen into a 128-byte buffer, dropping
+// everything that falls outside it
+class PageRenderer : public Adafruit_GFX {
+private:
+  uint8_t* buffer;
+  uint8_t page;
+  
+public:
+  PageRenderer();
+  void begin(uint8_t* buf, uint8_t pageIndex);
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+};
+
+// Framebuffer-less SSD1306 target for MinuxDisplay. Drawing calls are
+// recorded into a compact display list instead of a 1 KB framebuffer; the
+// list is replayed once per page when the screen is flushed, in the manner
+// of a picture loop, so only one 128-byte page buffer is ever needed.
+class DisplayList : public Adafruit_GFX {
+private:
+  DisplayOp ops[DISPLAY_LIST_OPS];
+  char textPool[DISPLAY_TEXT_POOL];
+  uint8_t opCount;
+  uint8_t poolUsed;
+  uint8_t dropped;
+  uint8_t address;
+  
+  uint8_t pageBuffer[SCREEN_WIDTH];
+  PageRenderer renderer;
+  GlyphBlitter glyphs;
+  
+  DisplayOp* add(uint8_t type, int16_t x, int16_t y, uint16_t color);
+  uint8_t textStyle();
+  
+public:
+  DisplayList();
+  bool begin(uint8_t i2caddr = SCREEN_ADDRESS);
+  void ssd1306_command(uint8_t c);
+  void invertDisplay(bool invert);
+  
+  // Recording, mirrors the Adafruit_SSD1306 calls MinuxDisplay makes
+  void clearDisplay();
+  size_t write(uint8_t c) override;
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+  void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+  void drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color);
+  void drawGrid(uint8_t spacing, uint16_t color);
+  
+  // Playback
+  const uint8_t* renderPage(uint8_t page);
+  uint8_t getOpCount() { return opCount; }
+  uint8_t getDropped() { return dropped; }
+};
+
+#endif
@@ -3,13 +3,46 @@
 
 #include <Arduino.h>
 #include "minux_config.h"
+#include "minux_timer.h"
+#include "minux_store.h"
 
-// Simple in-memory filesystem
+#define FS_NONE 0xFF
+#define FS_ROOT 0xFE       // The root directory, which has no entry of its own
+#define FS_NO_HANDLE 0xFFFF
+
+// Stable reference to a file: generation << 8 | slot. Deleting the file
+// bumps the slot's generation, so the handle no longer resolves even after
+// the slot is reused (until the 8-bit generation comes round again).
+typedef uint16_t FileHandle;
+
+// Run of contiguous blocks in the heap; a file's runs form a chain
+struct FsExtent {
+  uint8_t start;
+  uint8_t count;     // 0 when the extent is free
+  uint8_t next;      // Next run of the same file, FS_NONE at the end
+};
+
+// Simple in-memory filesystem. Entries are inodes: metadata only, the
+// contents are reached through the extent chain. Entries never move, so a
+// FileEntry* stays put until that file is deleted.
+//
+// Directories are entries too. Each entry sits in a ring with the others
+// of its directory, and a directory points at the first of them, so a
+// listing walks only its own children.
 struct FileEntry {
-  char name[MAX_FILENAME];
-  uint8_t data[MAX_FILESIZE];
+  char name[MAX_FILENAME];   // Last path component; empty while the slot is free
   uint16_t size;
+  union {
+    uint8_t extent;  // File: first run, FS_NONE while empty; links the free list in a free slot
+    uint8_t child;   // Directory: first entry in it, FS_NONE while empty
+  };
+  uint8_t parent;    // Directory holding this entry, FS_ROOT at the top
+  uint8_t next;      // Siblings, a circular list in creation order
+  uint8_t prev;
+  uint8_t generation;
   bool isDirectory;
+  bool isVolatile;   // Rebuilt at boot, never written to EEPROM
+  uint16_t logPos;   // Current record in the EEPROM log, STORE_NONE if none
   unsigned long created;
   unsigned long modified;
 };
@@ -18,24 +51,107 @@ class MinuxFS {
 private:
   FileEntry files[MAX_FILES];
   uint8_t fileCount;
-  char currentPath[64];
+  uint8_t slotCount;       // Slots ever handed out; the rest of files[] is untouched
+  uint8_t freeSlot;        // Free list of deleted slots, FS_NONE when empty
+  uint8_t rootChild;       // First entry of the root directory
+  uint8_t cwd;             // Current directory, where relative paths start
+  
+  // Name index: open addressing with linear probing over entry numbers,
+  // keyed by directory and name, plus an 8-bit fingerprint per entry so
+  // most probes skip the strcmp
+  uint8_t nameIndex[FS_HASH_SLOTS];
+  uint8_t nameTag[MAX_FILES];
+  SoftTimer refreshTimer;
+  
+  // Block heap: data, a used bitmap and the extent table
+  uint8_t blocks[FS_BLOCKS][FS_BLOCK_SIZE];
+  uint8_t blockMap[(FS_BLOCKS + 7) / 8];
+  FsExtent extents[FS_EXTENTS];
+  uint8_t freeBlocks;
+  
+#if ENABLE_FS_STORE
+  MinuxStore store;
+  SoftTimer maintenanceTimer;
+#endif
+  
+  bool isUsed(uint8_t block) { return blockMap[block >> 3] & (1 << (block & 7)); }
+  void setUsed(uint8_t block, bool used);
+  uint8_t placeRun(uint16_t need);
+  uint8_t newExtent(uint8_t start);
+  bool reserve(FileEntry* file, uint16_t size);
+  void release(FileEntry* file, uint16_t size);
+  uint16_t transfer(FileEntry* file, uint16_t offset, uint8_t* buffer, uint16_t length, bool toFile);
+  uint8_t takeSlot();
+  void dropSlot(uint8_t slot);
+  FileEntry* newEntry(uint8_t slot, uint8_t dir, const char* name);
+  void drop(uint8_t entry);
+  uint8_t lookup(uint8_t dir, const char* name);
+  void link(uint8_t entry);
+  void unlink(uint8_t entry);
+  uint8_t& childrenOf(uint8_t dir) { return dir == FS_ROOT ? rootChild : files[dir].child; }
+  
+  // Paths
+  uint8_t walk(const char* path, char* leaf);
+  uint8_t find(const char* path);
+  uint8_t place(const char* path, char* leaf);
+  uint16_t pathLength(uint8_t dir, const char* name);
+  
+  // Persistence hooks, no-ops without the EEPROM store
+  bool canStore(FileEntry* file, uint16_t pathLength, uint16_t size);
+  void stored(FileEntry* file);
+  
+  static void refreshSystemInfo(void* arg);
+#if ENABLE_FS_STORE
+  static void maintainStore(void* arg);
+#endif
   
 public:
   MinuxFS();
   void init();
   
-  // File operations
-  bool createFile(const char* name, const uint8_t* data, uint16_t size);
-  bool deleteFile(const char* name);
-  FileEntry* openFile(const char* name);
-  bool writeFile(const char* name, const uint8_t* data, uint16_t size);
-  uint16_t readFile(const char* name, uint8_t* buffer, uint16_t maxSize);
+  // File operations. Paths are absolute from '/' or relative to the
+  // current directory, and may use '.' and '..'.
+  bool createFile(const char* path, const uint8_t* data, uint16_t size);
+  bool deleteFile(const char* path);
+  FileEntry* openFile(const char* path);
+  bool writeFile(const char* path, const uint8_t* data, uint16_t size);
+  bool appendFile(const char* path, const uint8_t* data, uint16_t size);
+  bool renameFile(const char* path, const char* newPath);
+  uint16_t readFile(const char* path, uint8_t* buffer, uint16_t maxSize);
+  uint16_t read(FileEntry* file, uint16_t offset, uint8_t* buffer, uint16_t length);
   
-  // Directory operations
-  bool createDir(const char* name);
+  // Directory operations. Directories are numbered by slot, FS_ROOT for
+  // the root; children are listed with firstChild() and nextChild().
+  bool createDir(const char* path);
+  bool removeDir(const char* path);
+  bool changeDir(const char* path);
+  uint8_t findDir(const char* path);
+  uint8_t getCwd() { return cwd; }
+  bool getPath(uint8_t dir, char* path, uint8_t size);
+  uint8_t firstChild(uint8_t dir) { return childrenOf(dir); }
+  uint8_t nextChild(uint8_t slot);
   void listFiles();
   uint8_t getFileCount() { return fileCount; }
-  FileEntry* getFile(uint8_t index);
+  
+  // Slots below getSlotCount(); getFile() is null for a free one
+  uint8_t getSlotCount() { return slotCount; }
+  FileEntry* getFile(uint8_t slot);
+  
+  // Handles, checked against the slot's generation
+  uint8_t getSlot(FileEntry* file) { return file - files; }
+  FileHandle getHandle(FileEntry* file) { return (uint16_t)file->generation << 8 | getSlot(file); }
+  FileEntry* resolve(FileHandle handle);
+  
+  // Block heap usage
+  uint16_t getFreeBytes() { return (uint16_t)freeBlocks * FS_BLOCK_SIZE; }
+  uint8_t getFreeBlocks() { return freeBlocks; }
+  uint8_t getExtentCount(FileEntry* file);
+  
+  // EEPROM log, compacted a step at a time every FS_MAINTENANCE_MS
+  bool compact();
+#if ENABLE_FS_STORE
+  MinuxStore& getStore() { return store; }
+#endif
   
   // System files
   void createSystemFiles();
@@ -0,0 +1,45 @@
+#ifndef MINUX_GLYPH_H
+#define MINUX_GLYPH_H
+
+#include <Arduino.h>
+#include "minux_config.h"
+
+#define GLYPH_WIDTH         6       // Five font columns plus spacing
+#define GLYPH_HEIGHT        8
+
+// Text blitter for the built-in 5x7 font. SSD1306 memory is organised as
+// pages of 8 vertical pixels per byte, the same layout as the font's glyph
+// columns, so a glyph on a page boundary is five byte stores; anywhere else
+// each column is shifted and or'ed into the two pages it straddles. Colours
+// follow Adafruit_GFX: a background equal to the colour is transparent,
+// otherwise the whole 6x8 cell is painted (inverted text is BLACK on WHITE).
+class GlyphBlitter : public Print {
+private:
+  uint8_t* buffer;
+  uint8_t firstPage;
+  uint8_t pageCount;
+  int16_t cursorX;
+  int16_t cursorY;
+  uint8_t color;
+  uint8_t background;
+  uint16_t glyphCount;
+  
+  uint8_t blend(uint8_t dst, uint8_t bits, uint8_t mask);
+  
+public:
+  GlyphBlitter();
+  void begin(uint8_t* buf, uint8_t first = 0, uint8_t pages = SCREEN_HEIGHT / 8);
+  void drawGlyph(int16_t x, int16_t y, uint8_t c);
+  size_t write(uint8_t c) override;
+  using Print::write;
+  
+  // Mirrors the Adafruit_GFX text state MinuxDisplay uses
+  void setCursor(int16_t x, int16_t y) { cursorX = x; cursorY = y; }
+  int16_t getCursorX() { return cursorX; }
+  int16_t getCursorY() { return cursorY; }
+  void setTextColor(uint16_t c) { color = background = c; }
+  void setTextColor(uint16_t c, uint16_t bg) { color = c; background = bg; }
+  uint16_t getGlyphCount() { return glyphCount; }
+};
+
+#endif
@@ -20,17 +20,46 @@ enum InputEvent {
   EVENT_BTN_COMBO
 };
 
+// Queued event with the time its edge was seen
+struct InputRecord {
+  InputEvent event;
+  unsigned long timestamp;
+};
+
+#define INPUT_QUEUE_SIZE 8   // Power of two
+
 class MinuxInput {
 private:
-  uint8_t pin_a, pin_up, pin_down, pin_right, pin_buzzer;
-  ButtonState btn_states[4];
-  unsigned long last_press[4];
+  uint8_t pins[4];          // A, UP, DOWN, RIGHT
+  uint8_t pin_buzzer;
+  volatile ButtonState btn_states[4];
+  volatile unsigned long last_press[4];   // Last accepted edge, press or release
   unsigned long debounce_delay;
   bool buzzer_enabled;
   
+  // Pin-change edges are captured straight from the port registers
+  volatile uint8_t* pin_regs[4];
+  uint8_t pin_masks[4];
+  volatile bool combo_latched;
+  
+  // Single producer (pin-change ISR), single consumer (main loop). Each side
+  // only writes its own index, so neither needs to mask interrupts.
+  InputRecord queue[INPUT_QUEUE_SIZE];
+  volatile uint8_t queue_head;
+  volatile uint8_t queue_tail;
+  volatile uint8_t dropped;
+  
+  bool isDown(uint8_t button);
+  void push(InputEvent event, unsigned long now);
+  void sample(unsigned long now);
+  
 public:
   MinuxInput();
   void init(uint8_t a, uint8_t up, uint8_t down, uint8_t right, uint8_t buzzer);
+  void onPinChange();                          // Called from the PCINT ISRs
+  uint8_t read(InputRecord* out, uint8_t max); // Drains up to max queued events
+  uint8_t getDropped() { return dropped; }
+  bool pending() { return queue_head != queue_tail; }  // Events waiting for read()
   InputEvent poll();
   void playTone(uint16_t freq, uint16_t duration);
   void enableBuzzer(bool enable) { buzzer_enabled = enable; }
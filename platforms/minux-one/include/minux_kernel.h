@@ -24,16 +24,34 @@ enum SystemState {
 enum ProcessState {
   PROC_READY,
   PROC_RUNNING,
+  PROC_SLEEPING,
   PROC_BLOCKED,
   PROC_TERMINATED
 };
 
+// Fixed-block pool, one per block class
+struct PoolInfo {
+  uint8_t blockSize;
+  uint8_t blocks;
+  uint8_t used;
+  uint8_t peak;            // Most blocks in use at once
+  uint16_t allocs;
+  uint16_t failures;       // Requests this class could not serve, even by spilling up
+};
+
 // Memory management
 struct MemInfo {
   uint16_t total;
   uint16_t free;
   uint16_t used;
-  uint8_t fragmentation;
+  uint8_t fragmentation;   // Free bytes unusable for the largest request, percent
+  uint16_t largestFree;    // Biggest single allocation the heap could serve
+  uint16_t stackFreeMin;   // Smallest heap-to-stack gap ever seen
+  uint16_t stackPeak;      // Deepest main stack use, ISR frames included
+  uint16_t isrPeak;        // Part of stackPeak below the deepest sampled task SP
+#if ENABLE_POOL
+  PoolInfo pools[POOL_CLASSES];
+#endif
 };
 
 class MinuxKernel {
@@ -42,17 +60,51 @@ private:
   unsigned long bootTime;
   unsigned long uptime;
   MemInfo memory;
+  unsigned long sleepTime;
+  unsigned long wakeCount;
+  uint32_t sleepResidue;   // Sub-ms part of the slept time, in Timer1 ticks * 1000
+  uint8_t overflowResidue; // Timer1 ticks short of a whole Timer0 overflow
+  
+  // Stack watermark scanner
+  uint8_t* scanPtr;
+  uint8_t* heapTop;        // Highest heap end seen, the stack region starts here
+  uint8_t* taskSpMin;      // Deepest SP sampled outside interrupts
+  uint16_t stackFreeMin;
+  
+#if ENABLE_POOL
+  // Pool allocator: free blocks are chained through their first two bytes
+  struct FreeBlock { FreeBlock* next; };
+  FreeBlock* poolFreeList[POOL_CLASSES];
+  uint8_t* poolBase[POOL_CLASSES];
+  PoolInfo poolStats[POOL_CLASSES];
+  void initPools();
+#endif
   
 public:
   MinuxKernel();
   void init();
   void panic(const char* message);
+  void reboot();
   SystemState getState() { return currentState; }
   void setState(SystemState state) { currentState = state; }
   unsigned long getUptime();
   MemInfo getMemoryInfo();
   void updateMemoryInfo();
+  void checkStack();
+  void sampleStack();
   const char* getVersion() { return KERNEL_VERSION; }
+  
+#if ENABLE_POOL
+  // Fixed-block allocation, O(1) and fragmentation free
+  void* poolAlloc(uint16_t size);
+  void poolFree(void* ptr);
+#endif
+  
+  // Power management
+  void idle();
+  unsigned long foldSleep(uint16_t elapsed, uint16_t* overflows);
+  unsigned long getSleepTime() { return sleepTime; }
+  unsigned long getWakeCount() { return wakeCount; }
 };
 
 // Global system calls
@@ -0,0 +1,33 @@
+#ifndef MINUX_LINE_H
+#define MINUX_LINE_H
+
+#include <Arduino.h>
+#include "minux_config.h"
+
+#define LINE_MAX_ARGS 4   // The last argument keeps the rest of the line
+
+// Splits line on spaces in place; the command word is lowercased and the last
+// slot takes the untouched remainder. Returns the argument count.
+uint8_t splitLine(char* line, char** argv, uint8_t maxArgs);
+
+// Line discipline for a byte stream: edits into a fixed buffer, then splits
+// the finished line in place. argv entries point into the buffer and stay
+// valid until the next byte is fed, so nothing is copied or allocated.
+class MinuxLine {
+private:
+  char buffer[MAX_CMD_LENGTH];
+  uint8_t length;
+  bool complete;
+  bool lastWasCR;
+  Print* echo;
+  
+public:
+  MinuxLine(Print* echoTo = nullptr);
+  bool feed(char c);                 // True once a line has been terminated
+  bool poll(Stream& in);             // Feeds buffered input until a line is done
+  uint8_t parse(char** argv, uint8_t maxArgs = LINE_MAX_ARGS);
+  void reset();
+  uint8_t getLength() { return length; }
+};
+
+#endif
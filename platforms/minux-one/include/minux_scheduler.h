@@ -4,6 +4,16 @@
 #include <Arduino.h>
 #include "minux_config.h"
 #include "minux_kernel.h"
+#include "minux_timer.h"
+
+// Preemption needs the AVR context switch; other targets stay cooperative
+#if ENABLE_PREEMPTION && defined(__AVR__)
+#define MINUX_PREEMPTIVE 1
+#else
+#define MINUX_PREEMPTIVE 0
+#endif
+
+#define NO_PROCESS 0xFF
 
 // Process control block
 struct ProcessControlBlock {
@@ -14,6 +24,20 @@ struct ProcessControlBlock {
   bool active;
   uint8_t priority;
   ProcessState state;
+  uint8_t next, prev;      // Ready queue links
+  SoftTimer wakeTimer;     // Periodic, moves the entry back to ready every interval
+  unsigned long dueAt;     // Wheel tick time of the release being served
+  
+  // CPU accounting since the last resetStats()
+  uint32_t runTime;        // Accumulated run time in micros() ticks, dispatch included
+  uint32_t worstTime;      // Longest single run
+  uint16_t runCount;       // Sticks at 0xFFFF, like the jitter buckets
+  uint16_t jitter[JITTER_BUCKETS];  // Release jitter histogram (start - due)
+  
+  // Preemptive context (unused for cooperative entries)
+  bool preemptive;
+  uint8_t* stackPointer;   // Saved SP while switched out
+  uint8_t* stackBase;      // Lowest address of the task's stack
 };
 
 class MinuxScheduler {
@@ -24,10 +48,37 @@ private:
   unsigned long lastSchedule;
   uint16_t scheduleInterval;
   
+  // Preemptive state
+  uint8_t threadCount;
+  int8_t runningThread;    // Index into processes, -1 for the main loop
+  uint8_t* mainStackPointer;
+  
+  // Ready queue: one FIFO per priority plus a bitmap of non-empty levels
+  uint8_t readyBitmap;
+  uint8_t readyHead[NUM_PRIORITIES];
+  uint8_t readyTail[NUM_PRIORITIES];
+  
+  void listAppend(uint8_t& head, uint8_t& tail, uint8_t index);
+  void listRemove(uint8_t& head, uint8_t& tail, uint8_t index);
+  void makeReady(uint8_t index);
+  void armWake(uint8_t index, unsigned long firstMs);
+  void unlink(uint8_t index);
+  uint8_t popHighestReady();
+  int8_t addProcess(const char* name, void (*func)(), unsigned long interval, uint8_t priority);
+  
+  // Accounting
+  unsigned long statsSince;
+  void account(ProcessControlBlock* pcb, unsigned long started, uint32_t runTicks);
+  
+  static void wakeProcess(void* arg);
+  static void threadEntry();
+  bool isRunnable(ProcessControlBlock* pcb, unsigned long now);
+  
 public:
   MinuxScheduler();
   void init();
   bool startProcess(const char* name, void (*func)(), unsigned long interval, uint8_t priority = 1);
+  bool startThread(const char* name, void (*func)(), unsigned long interval, uint8_t priority = 1);
   void stopProcess(const char* name);
   void tick();
   void yield();
@@ -36,6 +87,18 @@ public:
   void listProcesses();
   void suspendProcess(const char* name);
   void resumeProcess(const char* name);
+  
+  // CPU accounting
+  void resetStats();
+  unsigned long getStatsWindow() { return millis() - statsSince; }
+  
+  // Thread stack watermarks
+  uint16_t getStackFree(uint8_t index);
+  void checkStacks();
+  
+  // Context switch support, called with interrupts disabled
+  uint8_t** selectContext();
+  bool inThread() { return runningThread >= 0; }
 };
 
 extern MinuxScheduler scheduler;
@@ -23,18 +23,23 @@ public:
   void executeCommand(const char* cmd);
   void printPrompt();
   void printHelp();
+  void scrollView(int8_t lines);
+  void runSerial(uint8_t argc, char** argv);   // Serial console, outside the terminal
   
   // Built-in commands
-  void cmd_help();
-  void cmd_ls();
+  void cmd_ls(const char* path);
   void cmd_ps();
+  void cmd_top(Print& out, bool wide);
+  void cmd_sched(Print& out, const char* arg, bool wide);
   void cmd_clear();
   void cmd_uptime();
-  void cmd_mem();
-  void cmd_reboot();
   void cmd_version();
   void cmd_cat(const char* filename);
   void cmd_echo(const char* text);
+  void cmd_cd(const char* path);
+  void cmd_pwd();
+  void cmd_mkdir(const char* path);
+  void cmd_rmdir(const char* path);
   
   bool isActive() { return shellActive; }
   void activate() { shellActive = true; }
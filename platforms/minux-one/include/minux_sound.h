@@ -0,0 +1,71 @@
+#ifndef MINUX_SOUND_H
+#define MINUX_SOUND_H
+
+#include <Arduino.h>
+#include "minux_config.h"
+
+#define SOUND_QUEUE_SIZE 4   // Power of two
+#define NOTE_REST 0
+
+// One step of a melody; a zero duration ends it
+struct Note {
+  uint16_t freq;       // Hz, NOTE_REST for silence
+  uint16_t duration;   // ms
+};
+
+// Built-in patterns, stored in PROGMEM
+extern const Note MELODY_BOOT[];
+extern const Note MELODY_ERROR[];
+extern const Note MELODY_OK[];
+
+// Buzzer sequencer. Notes are played back from the Timer2 compare
+// interrupt, so queueing a sound returns immediately and never stalls the
+// caller. Replaces tone(), which claims the same timer.
+class MinuxSound {
+private:
+  struct Entry {
+    const Note* melody;   // PROGMEM melody, or nullptr for a single note
+    uint16_t freq;
+    uint16_t duration;
+  };
+  
+  // Single producer (main loop), single consumer (ISR)
+  Entry queue[SOUND_QUEUE_SIZE];
+  volatile uint8_t queueHead;
+  volatile uint8_t queueTail;
+  
+  // Playback state, owned by the ISR while the timer runs
+  const Note* melody;
+  uint32_t togglesLeft;
+  bool silent;
+  volatile bool playing;
+  volatile uint8_t* pinPort;
+  uint8_t pinMask;
+  uint8_t pin;
+  bool enabled;
+  
+#if !defined(__AVR__)
+  unsigned long noteEnd;
+#endif
+  
+  bool enqueue(const Note* melody, uint16_t freq, uint16_t duration);
+  bool nextNote(uint16_t& freq, uint16_t& duration);
+  void startNote(uint16_t freq, uint16_t duration);
+  void stop();
+  
+public:
+  MinuxSound();
+  void init(uint8_t buzzerPin);
+  bool beep(uint16_t freq, uint16_t duration);
+  bool play(const Note* melody);
+  void silence();
+  void update();              // Off-target playback; no-op on AVR
+  void onTimer();             // Called from the Timer2 compare ISR
+  bool isPlaying() { return playing; }
+  void setEnabled(bool on) { enabled = on; }
+  bool isEnabled() { return enabled; }
+};
+
+extern MinuxSound sound;
+
+#endif
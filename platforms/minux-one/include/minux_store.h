@@ -0,0 +1,92 @@
+#ifndef MINUX_STORE_H
+#define MINUX_STORE_H
+
+#include <Arduino.h>
+#include "minux_config.h"
+
+#define STORE_NONE      0xFFFF
+#define STORE_HEADER    6       // Type, sequence, name length, data length
+#define STORE_OVERHEAD  (STORE_HEADER + 2)
+
+// Record types. Erased cells (0xFF) are not a type. The type byte sits
+// outside the CRC so a record can be retired with a single byte write.
+enum StoreType : uint8_t {
+  STORE_FREE = 0x00,     // Reclaimed by compaction
+  STORE_DIR  = 0x44,
+  STORE_FILE = 0x46,
+  STORE_DEAD = 0x58      // Deleted or superseded, space not reclaimed yet
+};
+
+// Decoded record header. On EEPROM a record is: type, sequence (2),
+// name length, data length (2), name, data, then a CRC-16 over everything
+// after the type byte. The name is the path from the root without the
+// leading '/'. Multi-byte fields are little endian.
+struct StoreHeader {
+  uint8_t type;
+  uint16_t seq;
+  uint8_t nameLength;
+  uint16_t dataLength;
+  uint16_t length;       // Whole record
+};
+
+class MinuxFS;
+struct FileEntry;
+
+// Log-structured persistence for MinuxFS in EEPROM.
+//
+// The log is a ring. Every change appends a full copy of the file at the
+// tail and retires the previous copy in place; compaction takes records off
+// the head, copying the ones still current to the tail. Writes therefore
+// sweep the whole EEPROM instead of hammering the cells of one file.
+// Records are back to back with consecutive sequence numbers, which is how
+// mount finds the live part of the ring again without any fixed header.
+class MinuxStore {
+private:
+  uint16_t head;         // Oldest record
+  uint16_t tail;         // Where the next record goes
+  uint16_t used;         // Bytes from head to tail
+  uint16_t live;         // Bytes in records that hold current files
+  uint16_t seq;          // Sequence number of the next record
+  uint16_t records;      // Records between head and tail
+  uint16_t copied;       // Bytes of the head record copied to the tail so far
+  uint16_t copyCrc;
+  bool mounted;
+  
+  bool parse(uint16_t pos, StoreHeader& header);
+  uint16_t lengthAt(uint16_t pos);
+  void readName(uint16_t pos, uint8_t length, char* name);
+  void retire(uint16_t pos, uint8_t type);
+  uint16_t append(uint8_t type, const char* name, MinuxFS& fs, FileEntry* file);
+  bool copyStep(uint16_t length, uint16_t budget);
+  uint16_t reclaim(MinuxFS& fs, uint16_t budget);
+  void makeRoom(MinuxFS& fs, uint16_t length);
+  void restore(MinuxFS& fs, uint16_t pos, StoreHeader& header);
+  
+public:
+  MinuxStore();
+  
+  // Scans the log and rebuilds the files it holds
+  void mount(MinuxFS& fs);
+  bool isMounted() { return mounted; }
+  
+  // Whether a file of this size can be stored next to its current copy
+  bool fits(uint8_t nameLength, uint16_t size);
+  void save(MinuxFS& fs, FileEntry* file);
+  void remove(FileEntry* file);
+  
+  // One step of background compaction, false when there was nothing to do
+  bool compact(MinuxFS& fs);
+  
+  static uint16_t recordSize(uint8_t nameLength, uint16_t dataLength) {
+    return STORE_OVERHEAD + nameLength + dataLength;
+  }
+  
+  // Usage
+  uint16_t getUsed() { return used; }
+  uint16_t getLive() { return live; }
+  uint16_t getFree() { return FS_STORE_SIZE - used; }
+  uint16_t getRecords() { return records; }
+  uint16_t getSeq() { return seq; }
+};
+
+#endif
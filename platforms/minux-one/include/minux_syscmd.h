@@ -0,0 +1,16 @@
+#ifndef MINUX_SYSCMD_H
+#define MINUX_SYSCMD_H
+
+#include "minux_command.h"
+
+// Kernel commands every console carries. They print to commandOut(), so one
+// row serves the lite console, the terminal and the serial console alike.
+void commandI2C(uint8_t, char**);
+void commandMem(uint8_t, char**);
+void commandReboot(uint8_t, char**);
+
+#define COMMAND_I2C    { "i2c",    "Scan I2C bus",     commandI2C }
+#define COMMAND_MEM    { "mem",    "Show memory info", commandMem }
+#define COMMAND_REBOOT { "reboot", "Restart system",   commandReboot }
+
+#endif
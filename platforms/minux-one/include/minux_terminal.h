@@ -0,0 +1,51 @@
+#ifndef MINUX_TERMINAL_H
+#define MINUX_TERMINAL_H
+
+#include <Arduino.h>
+#include "minux_config.h"
+
+#define TERM_COLS           (SCREEN_WIDTH / 6)    // 21 cells of the 6x8 font
+#define TERM_ROWS           (SCREEN_HEIGHT / 8)   // One row per controller page
+#define TERM_ROW_MASK       ((1UL << TERM_COLS) - 1)
+
+// Character cell model of the terminal. Rows live in a ring indexed from
+// top, so a scroll only recycles the oldest row; the panel follows by moving
+// its display start line to top * 8. Changed cells are tracked as a column
+// mask per physical row, and lines pushed off the top go to a scrollback ring
+// that can be browsed without disturbing the live rows.
+class MinuxTerminal : public Print {
+private:
+  char cells[TERM_ROWS][TERM_COLS];
+  uint32_t dirty[TERM_ROWS];          // Changed columns per physical row
+  uint8_t top;                        // Physical row shown on the first line
+  uint8_t col;
+  uint8_t line;                       // Cursor line, relative to top
+  
+  char history[TERM_SCROLLBACK][TERM_COLS];
+  uint8_t historyHead;                // Next slot to overwrite
+  uint8_t historyCount;
+  uint8_t viewOffset;                 // Lines scrolled back, 0 when live
+  
+  void newLine();
+  void setCell(char c);
+  void markAll();
+  
+public:
+  MinuxTerminal();
+  void reset();
+  size_t write(uint8_t c) override;
+  using Print::write;
+  void setCursor(uint8_t column, uint8_t row);
+  
+  // Scrollback, positive values move back in time
+  void scrollView(int8_t lines);
+  uint8_t getViewOffset() { return viewOffset; }
+  uint8_t getHistoryCount() { return historyCount; }
+  
+  // Rendering
+  uint8_t getTop() { return top; }
+  const char* viewRow(uint8_t row);   // Cells a physical row shows right now
+  uint32_t takeDirty(uint8_t row);
+};
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef MINUX_TIMER_H
+#define MINUX_TIMER_H
+
+#include <Arduino.h>
+#include "minux_config.h"
+
+#define TIMER_SLOTS         (1 << TIMER_WHEEL_BITS)
+#define TIMER_SLOT_MASK     (TIMER_SLOTS - 1)
+#define TIMER_MAX_TICKS     ((1UL << (TIMER_WHEEL_BITS * TIMER_WHEEL_LEVELS)) - 1)
+#define TIMER_NONE          0xFFFFFFFFUL
+
+// Software timer, storage is owned by the caller
+struct SoftTimer {
+  SoftTimer* next = nullptr;
+  SoftTimer** pprev = nullptr;  // Slot or link pointing at us, null when idle
+  uint32_t expires = 0;         // Absolute wheel tick
+  uint16_t period = 0;          // Ticks between runs, 0 for one-shot
+  void (*callback)(void* arg) = nullptr;
+  void* arg = nullptr;
+};
+
+// Hierarchical timing wheel, one tick every TIMER_TICK_MS.
+// Not interrupt safe: arm, cancel and update from the main loop only.
+class MinuxTimers {
+private:
+  SoftTimer* wheel[TIMER_WHEEL_LEVELS][TIMER_SLOTS];
+  uint32_t currentTick;    // Next tick to be processed
+  unsigned long lastUpdate;
+  uint8_t armedCount;
+  
+  void insert(SoftTimer* t);
+  void cascade(uint8_t level, uint8_t slot);
+  void process();
+  
+public:
+  MinuxTimers();
+  void init();
+  void arm(SoftTimer* t, unsigned long delayMs, void (*callback)(void*), void* arg = nullptr);
+  void armPeriodic(SoftTimer* t, unsigned long periodMs, void (*callback)(void*), void* arg = nullptr);
+  void armPeriodic(SoftTimer* t, unsigned long periodMs, void (*callback)(void*), void* arg, unsigned long firstMs);
+  void cancel(SoftTimer* t);
+  bool isArmed(SoftTimer* t) { return t->pprev != nullptr; }
+  void update();
+  unsigned long getTickTime() { return lastUpdate; }  // When the tick being processed was due
+  unsigned long nextExpiry();   // ms until the next timer may fire, TIMER_NONE if idle
+  uint8_t getArmedCount() { return armedCount; }
+};
+
+extern MinuxTimers timers;
+
+#endif
@@ -0,0 +1,100 @@
+#ifndef MINUX_TRACE_H
+#define MINUX_TRACE_H
+
+#include <Arduino.h>
+#include "minux_config.h"
+
+// Kernel event trace: a ring of 4-byte records in RAM, written by the
+// TRACE() macros and read out in binary by `trace dump`. Decode captures
+// with tools/trace_decode.py. Everything compiles out with ENABLE_DEBUG 0.
+
+// id, name, Chrome trace phase: B and E open and close a slice on the
+// name's track, i is an instant, M is bookkeeping for the decoder
+#define TRACE_EVENTS(X) \
+  X(EPOCH,       "epoch", 'M') \
+  X(TASK_BEGIN,  "task",  'B') \
+  X(TASK_END,    "task",  'E') \
+  X(INPUT,       "input", 'i') \
+  X(FLUSH_BEGIN, "flush", 'B') \
+  X(FLUSH_END,   "flush", 'E') \
+  X(FS_BEGIN,    "fs",    'B') \
+  X(FS_END,      "fs",    'E')
+  
+#define TRACE_ENUM(id, name, phase) TRACE_##id,
+enum TraceEvent {
+  TRACE_EVENTS(TRACE_ENUM)
+  TRACE_EVENT_COUNT
+};
+#undef TRACE_ENUM
+
+// Payload of FS_BEGIN and FS_END
+enum TraceFsOp {
+  TRACE_FS_OPEN,
+  TRACE_FS_CREATE,
+  TRACE_FS_WRITE,
+  TRACE_FS_READ,
+  TRACE_FS_DELETE,
+  TRACE_FS_APPEND
+};
+
+// Time is micros() >> TRACE_TICK_SHIFT, low 16 bits. Whenever the upper bits
+// change an EPOCH record goes first: its time field holds the new upper
+// bits and arg how far they moved (clamped to 255).
+struct TraceRecord {
+  uint16_t time;
+  uint8_t event;
+  uint8_t arg;
+};
+
+// Dump layout, little endian: this header, then count records oldest first
+struct TraceHeader {
+  char magic[4];           // "MTRC"
+  uint8_t version;
+  uint8_t tickShift;
+  uint16_t count;
+  uint16_t overwritten;    // Records lost to wrap-around since the last clear
+  uint16_t epoch;          // Upper time bits of the newest record
+};
+
+#define TRACE_VERSION 1
+
+#if ENABLE_DEBUG
+class MinuxTrace {
+private:
+  TraceRecord ring[TRACE_RECORDS];
+  uint8_t head;            // Next slot to write
+  uint8_t count;
+  uint16_t overwritten;
+  uint16_t lastEpoch;
+  bool enabled;
+  
+  void push(uint16_t time, uint8_t event, uint8_t arg);
+  
+public:
+  MinuxTrace();
+  void record(uint8_t event, uint8_t arg);   // Safe from interrupts
+  void clear();
+  void dump(Print& out);
+  void setEnabled(bool on) { enabled = on; }
+  bool isEnabled() { return enabled; }
+  uint8_t getCount() { return count; }
+  uint16_t getOverwritten() { return overwritten; }
+};
+
+extern MinuxTrace trace;
+
+#define TRACE(event, arg) trace.record(TRACE_##event, (arg))
+
+// Brackets the rest of the enclosing block with kind_BEGIN and kind_END
+struct TraceScope {
+  uint8_t endEvent, arg;
+  TraceScope(uint8_t begin, uint8_t end, uint8_t a) : endEvent(end), arg(a) { trace.record(begin, arg); }
+  ~TraceScope() { trace.record(endEvent, arg); }
+};
+#define TRACE_SCOPE(kind, arg) TraceScope traceScope(TRACE_##kind##_BEGIN, TRACE_##kind##_END, (arg))
+#else
+#define TRACE(event, arg) ((void)0)
+#define TRACE_SCOPE(kind, arg) ((void)0)
+#endif
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef MINUX_TWI_H
+#define MINUX_TWI_H
+
+#include <Arduino.h>
+#include "minux_config.h"
+
+#define TWI_QUEUE_SIZE      8       // Power of two
+#define TWI_NO_CONTROL      -1
+
+// Completion status passed to the callback
+enum TwiStatus {
+  TWI_OK,
+  TWI_PENDING,
+  TWI_NACK_ADDRESS,
+  TWI_NACK_DATA,
+  TWI_ARBITRATION,
+  TWI_BUS_ERROR
+};
+
+// One bus transaction: an optional control byte, then txLength bytes, then,
+// after a repeated start, rxLength bytes read back. Storage is owned by the
+// caller and must stay put until the callback has run.
+struct TwiTransfer {
+  uint8_t address;
+  int16_t control = TWI_NO_CONTROL;
+  const uint8_t* txData = nullptr;
+  uint8_t txLength = 0;
+  uint8_t* rxData = nullptr;
+  uint8_t rxLength = 0;
+  void (*done)(TwiTransfer* t) = nullptr;   // Runs in interrupt context
+  void* arg = nullptr;
+  volatile uint8_t status = TWI_OK;
+};
+
+// Interrupt-driven TWI master. Transfers are queued and run back to back
+// from the TWI interrupt, so callers go on with other work while the bus is
+// busy. Claims TWI_vect, so it cannot be linked together with Wire.
+class MinuxTWI {
+private:
+  TwiTransfer* queue[TWI_QUEUE_SIZE];
+  volatile uint8_t queueHead;
+  volatile uint8_t queueTail;
+  
+  // Transfer on the bus
+  TwiTransfer* active;
+  uint8_t txIndex;
+  uint8_t rxIndex;
+  bool controlSent;
+  bool reading;
+  unsigned long startedAt;
+  
+  // Statistics
+  volatile uint32_t busyMicros;
+  volatile uint32_t byteCount;
+  volatile uint16_t transferCount;
+  volatile uint16_t errorCount;
+  unsigned long statsSince;
+  
+  void startNext();
+  void finish(uint8_t status);
+  
+public:
+  MinuxTWI();
+  void init(uint32_t clockHz = TWI_CLOCK_HZ);
+  bool submit(TwiTransfer* t);
+  uint8_t write(uint8_t address, int16_t control, const uint8_t* data, uint8_t length);
+  bool probe(uint8_t address);
+  bool isBusy() { return active != nullptr; }
+  void onInterrupt();
+  
+  // Statistics
+  uint8_t getUtilization();     // Percent of time the bus was busy
+  uint32_t getByteCount() { return byteCount; }
+  uint16_t getTransferCount() { return transferCount; }
+  uint16_t getErrorCount() { return errorCount; }
+  void resetStats();
+};
+
+extern MinuxTWI twi;
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef MINUX_WIDGET_H
+#define MINUX_WIDGET_H
+
+#include <Arduino.h>
+#include "minux_config.h"
+#include "minux_timer.h"
+
+#define WIDGET_MAX          16      // Widgets per screen
+#define WIDGET_REFRESH_MS   1000    // How often bound data is polled
+
+class MinuxDisplay;
+
+enum WidgetType {
+  WIDGET_LABEL,      // Fixed text
+  WIDGET_VALUE,      // source() as a number, padded to width characters
+  WIDGET_LIST,       // width rows drawn by row(), all redrawn when source() changes
+  WIDGET_ICON,       // 8x8 icon number width
+  WIDGET_GRID,       // Background dots every width pixels
+  WIDGET_TASKBAR     // Inverted status bar, redrawn when source() changes
+};
+
+typedef uint32_t (*WidgetSource)();
+typedef void (*WidgetRow)(uint8_t index, Print& out);
+
+// One element of a screen. Screens are PROGMEM tables of these, drawn in
+// order; x and y are pixels, text is the label or nothing.
+struct Widget {
+  uint8_t type;
+  uint8_t x, y;
+  uint8_t width;
+  char text[20];
+  WidgetSource source;    // Bound data, nullptr for static widgets
+  WidgetRow row;
+};
+
+#define WIDGET_COUNT(screen) (sizeof(screen) / sizeof(Widget))
+#define WIDGET_SCREEN_CHECK(screen) \
+  static_assert(WIDGET_COUNT(screen) <= WIDGET_MAX, #screen " has too many widgets")
+  
+// Retained screen: draws a widget table once, then polls the bound sources
+// and redraws only widgets whose value moved. Each redraw marks just its own
+// rectangle dirty, so a changing uptime costs one short span on one page.
+class MinuxWidgets {
+private:
+  MinuxDisplay* ui;
+  const Widget* screen;
+  uint8_t count;
+  uint32_t shown[WIDGET_MAX];   // Value each bound widget was last drawn with
+  SoftTimer refreshTimer;
+  uint16_t redraws;
+  
+  void draw(uint8_t index, const Widget& w, bool mark);
+  static void refreshDue(void* arg);
+  
+public:
+  MinuxWidgets(MinuxDisplay* owner);
+  void show(const Widget* widgets, uint8_t widgetCount);
+  void hide();
+  void refresh();
+  bool isShown() { return screen != nullptr; }
+  uint16_t getRedraws() { return redraws; }
+};
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef SIM_ADAFRUIT_GFX_H
+#define SIM_ADAFRUIT_GFX_H
+
+#include "Arduino.h"
+
+// The subset of Adafruit_GFX that Minux draws with: primitives, 1-bit
+// bitmaps and the classic 5x7 font, with the library's cursor semantics
+class Adafruit_GFX : public Print {
+public:
+  Adafruit_GFX(int16_t w, int16_t h);
+  virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+  virtual void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+  virtual void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+  virtual void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+  virtual void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+  virtual void fillScreen(uint16_t color);
+  void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
+  void drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color);
+  void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size);
+  
+  size_t write(uint8_t c) override;
+  using Print::write;
+  void setCursor(int16_t x, int16_t y) { cursor_x = x; cursor_y = y; }
+  void setTextColor(uint16_t c) { textcolor = textbgcolor = c; }
+  void setTextColor(uint16_t c, uint16_t bg) { textcolor = c; textbgcolor = bg; }
+  void setTextSize(uint8_t s) { textsize_x = textsize_y = s > 0 ? s : 1; }
+  void setTextWrap(bool w) { wrap = w; }
+  void cp437(bool x = true) { _cp437 = x; }
+  int16_t getCursorX() const { return cursor_x; }
+  int16_t getCursorY() const { return cursor_y; }
+  int16_t width() const { return _width; }
+  int16_t height() const { return _height; }
+  
+protected:
+  int16_t WIDTH, HEIGHT;
+  int16_t _width, _height;
+  int16_t cursor_x, cursor_y;
+  uint16_t textcolor, textbgcolor;
+  uint8_t textsize_x, textsize_y;
+  bool wrap;
+  bool _cp437;
+};
+
+#endif
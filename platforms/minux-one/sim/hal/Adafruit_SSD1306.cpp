@@ -0,0 +1,88 @@
+#include "Adafruit_SSD1306.h"
+
+Adafruit_SSD1306::Adafruit_SSD1306(uint8_t w, uint8_t h, TwoWire* twi, int8_t)
+  : Adafruit_GFX(w, h) {
+  wire = twi;
+  buffer = nullptr;
+  address = 0x3C;
+}
+
+Adafruit_SSD1306::~Adafruit_SSD1306() {
+  free(buffer);
+}
+
+bool Adafruit_SSD1306::begin(uint8_t, uint8_t addr, bool, bool periphBegin) {
+  if (!buffer && !(buffer = (uint8_t*)malloc(WIDTH * ((HEIGHT + 7) / 8)))) return false;
+  clearDisplay();
+  address = addr;
+  if (periphBegin) wire->begin();
+  
+  static const uint8_t init[] = {
+    SSD1306_DISPLAYOFF, SSD1306_SETDISPLAYCLOCKDIV, 0x80, SSD1306_SETMULTIPLEX, 0x3F,
+    SSD1306_SETDISPLAYOFFSET, 0x00, SSD1306_SETSTARTLINE, SSD1306_CHARGEPUMP, 0x14,
+    SSD1306_MEMORYMODE, 0x00, SSD1306_SEGREMAP | 0x01, SSD1306_COMSCANDEC,
+    SSD1306_SETCOMPINS, 0x12, SSD1306_SETCONTRAST, 0xCF, SSD1306_SETPRECHARGE, 0xF1,
+    SSD1306_SETVCOMDETECT, 0x40, SSD1306_DISPLAYALLON_RESUME, SSD1306_NORMALDISPLAY,
+    SSD1306_DEACTIVATE_SCROLL, SSD1306_DISPLAYON
+  };
+  for (uint8_t i = 0; i < sizeof(init); i++) ssd1306_command(init[i]);
+  
+  // A missing panel does not acknowledge its address
+  wire->beginTransmission(address);
+  return wire->endTransmission() == 0;
+}
+
+void Adafruit_SSD1306::ssd1306_command(uint8_t c) {
+  wire->beginTransmission(address);
+  wire->write((uint8_t)0x00);
+  wire->write(c);
+  wire->endTransmission();
+}
+
+// Whole buffer, in the same chunking as the library on AVR
+void Adafruit_SSD1306::display() {
+  static const uint8_t window[] = { SSD1306_PAGEADDR, 0, 0xFF, SSD1306_COLUMNADDR, 0 };
+  for (uint8_t i = 0; i < sizeof(window); i++) ssd1306_command(window[i]);
+  ssd1306_command(WIDTH - 1);
+  
+  uint16_t count = WIDTH * ((HEIGHT + 7) / 8);
+  const uint8_t* ptr = buffer;
+  while (count) {
+    uint8_t n = count < WIRE_BUFFER_SIZE - 1 ? count : WIRE_BUFFER_SIZE - 1;
+    wire->beginTransmission(address);
+    wire->write((uint8_t)0x40);
+    wire->write(ptr, n);
+    wire->endTransmission();
+    ptr += n;
+    count -= n;
+  }
+}
+
+void Adafruit_SSD1306::clearDisplay() {
+  if (buffer) memset(buffer, 0, WIDTH * ((HEIGHT + 7) / 8));
+}
+
+void Adafruit_SSD1306::invertDisplay(bool i) {
+  ssd1306_command(i ? SSD1306_INVERTDISPLAY : SSD1306_NORMALDISPLAY);
+}
+
+void Adafruit_SSD1306::dim(bool dim) {
+  ssd1306_command(SSD1306_SETCONTRAST);
+  ssd1306_command(dim ? 0 : 0xCF);
+}
+
+void Adafruit_SSD1306::drawPixel(int16_t x, int16_t y, uint16_t color) {
+  if (!buffer || x < 0 || x >= _width || y < 0 || y >= _height) return;
+  uint8_t& b = buffer[x + (y / 8) * WIDTH];
+  uint8_t bit = 1 << (y & 7);
+  switch (color) {
+    case SSD1306_WHITE: b |= bit; break;
+    case SSD1306_BLACK: b &= ~bit; break;
+    case SSD1306_INVERSE: b ^= bit; break;
+  }
+}
+
+bool Adafruit_SSD1306::getPixel(int16_t x, int16_t y) {
+  if (!buffer || x < 0 || x >= _width || y < 0 || y >= _height) return false;
+  return buffer[x + (y / 8) * WIDTH] & (1 << (y & 7));
+}
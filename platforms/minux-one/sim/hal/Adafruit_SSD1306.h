@@ -0,0 +1,56 @@
+#ifndef SIM_ADAFRUIT_SSD1306_H
+#define SIM_ADAFRUIT_SSD1306_H
+
+#include "Adafruit_GFX.h"
+#include "Wire.h"
+
+#define SSD1306_BLACK               0
+#define SSD1306_WHITE               1
+#define SSD1306_INVERSE             2
+
+#define SSD1306_MEMORYMODE          0x20
+#define SSD1306_COLUMNADDR          0x21
+#define SSD1306_PAGEADDR            0x22
+#define SSD1306_SETCONTRAST         0x81
+#define SSD1306_CHARGEPUMP          0x8D
+#define SSD1306_SEGREMAP            0xA0
+#define SSD1306_DISPLAYALLON_RESUME 0xA4
+#define SSD1306_NORMALDISPLAY       0xA6
+#define SSD1306_INVERTDISPLAY       0xA7
+#define SSD1306_SETMULTIPLEX        0xA8
+#define SSD1306_DISPLAYOFF          0xAE
+#define SSD1306_DISPLAYON           0xAF
+#define SSD1306_COMSCANDEC          0xC8
+#define SSD1306_SETDISPLAYOFFSET    0xD3
+#define SSD1306_SETDISPLAYCLOCKDIV  0xD5
+#define SSD1306_SETPRECHARGE        0xD9
+#define SSD1306_SETCOMPINS          0xDA
+#define SSD1306_SETVCOMDETECT       0xDB
+#define SSD1306_SETSTARTLINE        0x40
+#define SSD1306_DEACTIVATE_SCROLL   0x2E
+#define SSD1306_EXTERNALVCC         0x01
+#define SSD1306_SWITCHCAPVCC        0x02
+
+// Framebuffer driver with the library's interface; everything reaches the
+// panel as I2C traffic, so the simulated controller sees what a real one would
+class Adafruit_SSD1306 : public Adafruit_GFX {
+private:
+  TwoWire* wire;
+  uint8_t* buffer;
+  uint8_t address;
+  
+public:
+  Adafruit_SSD1306(uint8_t w, uint8_t h, TwoWire* twi = &Wire, int8_t rst = -1);
+  ~Adafruit_SSD1306();
+  bool begin(uint8_t vcs = SSD1306_SWITCHCAPVCC, uint8_t addr = 0x3C, bool reset = true, bool periphBegin = true);
+  void display();
+  void clearDisplay();
+  void invertDisplay(bool i);
+  void dim(bool dim);
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+  bool getPixel(int16_t x, int16_t y);
+  uint8_t* getBuffer() { return buffer; }
+  void ssd1306_command(uint8_t c);
+};
+
+#endif
@@ -0,0 +1,123 @@
+#include "Arduino.h"
+#include <stdio.h>
+#include <string>
+
+HardwareSerial Serial;
+
+static unsigned long simNow;              // Microseconds since boot
+static unsigned long simHorizon = ~0UL;   // ms
+static uint8_t pinLevel[SIM_PINS];
+static uint8_t pinModes[SIM_PINS];
+static unsigned int toneFrequency;
+static std::string serialIn;
+static std::string serialOut;
+
+unsigned long millis() { return simNow / 1000; }
+unsigned long micros() { return simNow; }
+
+void simAdvance(unsigned long us) { simNow += us; }
+void simSetHorizon(unsigned long ms) { simHorizon = ms; }
+
+// Waiting is where time passes; a pending script event ends the wait the way
+// a pin-change interrupt ends a sleep on the board
+void delay(unsigned long ms) {
+  unsigned long now = millis();
+  if (now >= simHorizon) return;
+  if (ms > simHorizon - now) ms = simHorizon - now;
+  simNow += ms * 1000;
+}
+
+void delayMicroseconds(unsigned int us) { simNow += us; }
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  if (pin >= SIM_PINS) return;
+  pinModes[pin] = mode;
+  if (mode == INPUT_PULLUP) pinLevel[pin] = HIGH;
+}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+  if (pin < SIM_PINS) pinLevel[pin] = value ? HIGH : LOW;
+}
+
+int digitalRead(uint8_t pin) {
+  return pin < SIM_PINS ? pinLevel[pin] : LOW;
+}
+
+void simSetPin(uint8_t pin, uint8_t level) { digitalWrite(pin, level); }
+uint8_t simPinMode(uint8_t pin) { return pin < SIM_PINS ? pinModes[pin] : INPUT; }
+
+void tone(uint8_t, unsigned int frequency, unsigned long) {
+  toneFrequency = frequency;
+}
+
+void noTone(uint8_t) { toneFrequency = 0; }
+unsigned int simToneFrequency() { return toneFrequency; }
+
+// Fixed LCG so runs repeat exactly
+static unsigned long randomState = 1;
+void randomSeed(unsigned long seed) { if (seed) randomState = seed; }
+
+long random(long howbig) {
+  if (howbig <= 0) return 0;
+  randomState = randomState * 1103515245UL + 12345UL;
+  return (randomState >> 16) % howbig;
+}
+
+long random(long howsmall, long howbig) {
+  return howsmall >= howbig ? howsmall : howsmall + random(howbig - howsmall);
+}
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+  size_t n = 0;
+  while (size--) n += write(*buffer++);
+  return n;
+}
+
+size_t Print::printNumber(unsigned long n, uint8_t base) {
+  char buf[8 * sizeof(long) + 1];
+  char* str = &buf[sizeof(buf) - 1];
+  *str = '\0';
+  if (base < 2) base = 10;
+  do {
+    char c = n % base;
+    n /= base;
+    *--str = c < 10 ? c + '0' : c + 'A' - 10;
+  } while (n);
+  return write(str);
+}
+
+size_t Print::print(long n, int base) {
+  if (base == DEC && n < 0) return print('-') + printNumber(-(unsigned long)n, DEC);
+  return printNumber(n, base);
+}
+
+size_t Print::print(unsigned long n, int base) {
+  return printNumber(n, base);
+}
+
+size_t Print::print(double n, int digits) {
+  char buf[32];
+  snprintf(buf, sizeof(buf), "%.*f", digits, n);
+  return write(buf);
+}
+
+int HardwareSerial::available() { return serialIn.size(); }
+
+int HardwareSerial::read() {
+  if (serialIn.empty()) return -1;
+  int c = (uint8_t)serialIn[0];
+  serialIn.erase(0, 1);
+  return c;
+}
+
+int HardwareSerial::peek() { return serialIn.empty() ? -1 : (uint8_t)serialIn[0]; }
+
+size_t HardwareSerial::write(uint8_t c) {
+  serialOut += (char)c;
+  putchar(c);
+  return 1;
+}
+
+void simSerialInput(const char* text) { serialIn += text; }
+const char* simSerialOutput() { return serialOut.c_str(); }
+void simSerialClear() { serialOut.clear(); }
@@ -0,0 +1,137 @@
+#ifndef SIM_ARDUINO_H
+#define SIM_ARDUINO_H
+
+// Host stand-in for the Arduino core. Time is virtual and only moves when
+// the code under test waits, so runs are deterministic and as fast as the
+// host allows.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include <type_traits>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH            1
+#define LOW             0
+#define INPUT           0
+#define OUTPUT          1
+#define INPUT_PULLUP    2
+#define LED_BUILTIN     13
+#define DEC             10
+#define HEX             16
+#define BIN             2
+
+#define SIM_PINS        32
+#define F_CPU           16000000UL   // The Nano's clock, for code that scales by it
+
+// Flash is ordinary memory here
+#define PROGMEM
+#define PSTR(s)             (s)
+#define pgm_read_byte(p)    (*(const uint8_t*)(p))
+#define pgm_read_word(p)    (*(const uint16_t*)(p))
+#define pgm_read_dword(p)   (*(const uint32_t*)(p))
+#define pgm_read_ptr(p)     (*(void* const*)(p))
+#define memcpy_P            memcpy
+#define strcmp_P            strcmp
+#define strncmp_P           strncmp
+#define strcpy_P            strcpy
+#define strlen_P            strlen
+
+class __FlashStringHelper;
+#define F(s)                ((const __FlashStringHelper*)(s))
+
+// One thread, no interrupts
+#define noInterrupts()
+#define interrupts()
+
+#define _BV(bit)            (1 << (bit))
+#define bitRead(v, bit)     (((v) >> (bit)) & 0x01)
+#define lowByte(w)          ((uint8_t)((w) & 0xFF))
+#define highByte(w)         ((uint8_t)((w) >> 8))
+#define constrain(v, lo, hi) ((v) < (lo) ? (lo) : ((v) > (hi) ? (hi) : (v)))
+
+// Functions rather than the core's macros so the C++ library headers still parse
+template <typename A, typename B>
+static inline typename std::common_type<A, B>::type min(A a, B b) { return a < b ? a : b; }
+template <typename A, typename B>
+static inline typename std::common_type<A, B>::type max(A a, B b) { return a > b ? a : b; }
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+void tone(uint8_t pin, unsigned int frequency, unsigned long duration = 0);
+void noTone(uint8_t pin);
+
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+
+class Print {
+private:
+  size_t printNumber(unsigned long n, uint8_t base);
+  
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t* buffer, size_t size);
+  size_t write(const char* str) { return str ? write((const uint8_t*)str, strlen(str)) : 0; }
+  virtual void flush() {}
+  
+  size_t print(const __FlashStringHelper* s) { return print((const char*)s); }
+  size_t print(const char* s) { return write(s); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(unsigned char n, int base = DEC) { return print((unsigned long)n, base); }
+  size_t print(int n, int base = DEC) { return print((long)n, base); }
+  size_t print(unsigned int n, int base = DEC) { return print((unsigned long)n, base); }
+  size_t print(long n, int base = DEC);
+  size_t print(unsigned long n, int base = DEC);
+  size_t print(double n, int digits = 2);
+  
+  size_t println() { return write("\r\n"); }
+  template <typename T> size_t println(T value) { size_t n = print(value); return n + println(); }
+  template <typename T> size_t println(T value, int format) { size_t n = print(value, format); return n + println(); }
+};
+
+class Stream : public Print {
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+};
+
+// Serial output goes to stdout; input is whatever the script queued
+class HardwareSerial : public Stream {
+public:
+  void begin(unsigned long) {}
+  void end() {}
+  int available() override;
+  int read() override;
+  int peek() override;
+  size_t write(uint8_t c) override;
+  using Print::write;
+  operator bool() { return true; }
+};
+
+extern HardwareSerial Serial;
+
+// Simulation controls used by the runner
+void simAdvance(unsigned long us);
+void simSetHorizon(unsigned long ms);    // delay() returns early at this time
+void simSetPin(uint8_t pin, uint8_t level);
+uint8_t simPinMode(uint8_t pin);
+unsigned int simToneFrequency();
+void simSerialInput(const char* text);
+const char* simSerialOutput();            // Everything printed so far
+void simSerialClear();
+
+#endif
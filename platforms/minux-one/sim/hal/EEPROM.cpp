@@ -0,0 +1,34 @@
+#include "EEPROM.h"
+
+EEPROMClass EEPROM;
+
+EEPROMClass::EEPROMClass() {
+  erase();
+  resetWear();
+  resetStats();
+  cutArmed = false;
+  writesLeft = 0;
+}
+
+void EEPROMClass::erase() {
+  memset(cells, 0xFF, sizeof(cells));
+}
+
+uint8_t EEPROMClass::read(int idx) {
+  if (idx < 0 || idx >= SIM_EEPROM_SIZE) return 0xFF;
+  reads++;
+  return cells[idx];
+}
+
+// Once power is cut, writes are lost, as if the board had died
+void EEPROMClass::write(int idx, uint8_t value) {
+  if (idx < 0 || idx >= SIM_EEPROM_SIZE) return;
+  if (cutArmed) {
+    if (writesLeft == 0) return;
+    writesLeft--;
+  }
+  cells[idx] = value;
+  wear[idx]++;
+  writes++;
+  simAdvance(SIM_EEPROM_WRITE_US);
+}
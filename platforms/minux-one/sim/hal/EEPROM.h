@@ -0,0 +1,42 @@
+#ifndef SIM_EEPROM_H
+#define SIM_EEPROM_H
+
+#include "Arduino.h"
+
+#define SIM_EEPROM_SIZE     1024    // ATmega328P
+#define SIM_EEPROM_WRITE_US 3300    // Erase plus write of one byte
+
+// EEPROM with the AVR core's interface. Every programmed byte costs virtual
+// time and is counted against its cell, so wear can be measured, and power
+// can be cut after a given number of writes to test crash recovery.
+class EEPROMClass {
+private:
+  uint8_t cells[SIM_EEPROM_SIZE];
+  uint32_t wear[SIM_EEPROM_SIZE];
+  uint32_t reads;
+  uint32_t writes;
+  uint32_t writesLeft;      // Until the power cut
+  bool cutArmed;
+  
+public:
+  EEPROMClass();
+  uint8_t read(int idx);
+  void write(int idx, uint8_t value);
+  void update(int idx, uint8_t value) { if (read(idx) != value) write(idx, value); }
+  uint16_t length() { return SIM_EEPROM_SIZE; }
+  
+  // Simulation
+  void erase();                             // Factory state, every cell 0xFF
+  uint32_t getWear(int idx) { return idx >= 0 && idx < SIM_EEPROM_SIZE ? wear[idx] : 0; }
+  uint32_t getReads() { return reads; }
+  uint32_t getWrites() { return writes; }
+  void resetStats() { reads = 0; writes = 0; }
+  void resetWear() { memset(wear, 0, sizeof(wear)); }
+  void cutPowerAfter(uint32_t count) { writesLeft = count; cutArmed = true; }
+  void restorePower() { cutArmed = false; }
+  bool isPowerCut() { return cutArmed && writesLeft == 0; }
+};
+
+extern EEPROMClass EEPROM;
+
+#endif
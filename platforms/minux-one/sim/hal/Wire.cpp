@@ -0,0 +1,54 @@
+#include "Wire.h"
+
+TwoWire Wire;
+
+TwoWire::TwoWire() {
+  memset(devices, 0, sizeof(devices));
+  txAddress = 0;
+  txLength = 0;
+  txOverflow = false;
+  rxLength = 0;
+  rxIndex = 0;
+  clockHz = 100000;
+  resetStats();
+}
+
+void TwoWire::beginTransmission(uint8_t address) {
+  txAddress = address & 0x7F;
+  txLength = 0;
+  txOverflow = false;
+}
+
+size_t TwoWire::write(uint8_t c) {
+  if (txLength >= WIRE_BUFFER_SIZE) {
+    txOverflow = true;
+    return 0;
+  }
+  txBuffer[txLength++] = c;
+  return 1;
+}
+
+// Return codes follow the AVR core: 0 ok, 1 too long, 2 address NACK
+uint8_t TwoWire::endTransmission(bool) {
+  transactions++;
+  bytesOnBus += txLength + 1;
+  busMicros += (uint64_t)(txLength + 1) * 9 * 1000000 / clockHz;
+  if (txOverflow) return 1;
+  
+  WireDevice* device = devices[txAddress];
+  if (!device) return 2;
+  device->receive(txBuffer, txLength);
+  return 0;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity, bool) {
+  if (quantity > WIRE_BUFFER_SIZE) quantity = WIRE_BUFFER_SIZE;
+  transactions++;
+  bytesOnBus += quantity + 1;
+  busMicros += (uint64_t)(quantity + 1) * 9 * 1000000 / clockHz;
+  
+  WireDevice* device = devices[address & 0x7F];
+  rxIndex = 0;
+  rxLength = device ? device->request(rxBuffer, quantity) : 0;
+  return rxLength;
+}
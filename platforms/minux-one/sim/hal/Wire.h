@@ -0,0 +1,57 @@
+#ifndef SIM_WIRE_H
+#define SIM_WIRE_H
+
+#include "Arduino.h"
+
+#define WIRE_BUFFER_SIZE    32      // Same limit as the AVR TwoWire buffer
+
+// A device on the simulated bus. write() receives one whole transaction.
+class WireDevice {
+public:
+  virtual ~WireDevice() {}
+  virtual void receive(const uint8_t* data, uint8_t length) = 0;
+  virtual uint8_t request(uint8_t*, uint8_t) { return 0; }
+};
+
+class TwoWire : public Stream {
+private:
+  WireDevice* devices[128];
+  uint8_t txAddress;
+  uint8_t txBuffer[WIRE_BUFFER_SIZE];
+  uint8_t txLength;
+  bool txOverflow;
+  uint8_t rxBuffer[WIRE_BUFFER_SIZE];
+  uint8_t rxLength;
+  uint8_t rxIndex;
+  uint32_t clockHz;
+  
+  // Statistics
+  uint32_t bytesOnBus;
+  uint32_t transactions;
+  uint64_t busMicros;
+  
+public:
+  TwoWire();
+  void begin() {}
+  void end() {}
+  void setClock(uint32_t hz) { clockHz = hz; }
+  void beginTransmission(uint8_t address);
+  uint8_t endTransmission(bool sendStop = true);
+  uint8_t requestFrom(uint8_t address, uint8_t quantity, bool sendStop = true);
+  size_t write(uint8_t c) override;
+  using Print::write;
+  int available() override { return rxLength - rxIndex; }
+  int read() override { return rxIndex < rxLength ? rxBuffer[rxIndex++] : -1; }
+  int peek() override { return rxIndex < rxLength ? rxBuffer[rxIndex] : -1; }
+  
+  // Simulation
+  void attach(uint8_t address, WireDevice* device) { devices[address & 0x7F] = device; }
+  uint32_t getBytes() { return bytesOnBus; }
+  uint32_t getTransactions() { return transactions; }
+  uint64_t getBusMicros() { return busMicros; }   // At the configured clock
+  void resetStats() { bytesOnBus = 0; transactions = 0; busMicros = 0; }
+};
+
+extern TwoWire Wire;
+
+#endif
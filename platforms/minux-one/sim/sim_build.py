@@ -0,0 +1,6 @@
+# PlatformIO pre-script for [env:native]: compiles the fake HAL and the
+# simulation driver, and points the include path at the GFX font table.
+Import("env")
+
+env.Append(CPPPATH=[env.subst("$PROJECT_LIBDEPS_DIR/$PIOENV/Adafruit GFX Library")])
+env.BuildSources("$BUILD_DIR/sim", "$PROJECT_DIR/sim")
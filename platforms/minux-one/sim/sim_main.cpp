@@ -0,0 +1,278 @@
+// Host build of Minux: the full system on the fake HAL, driven by a script.
+//
+//   program [script]        reads stdin when no script is given
+//
+// Script lines (# starts a comment):
+//   wait <ms>               run the system for ms of virtual time
+//   press <button> [ms]     hold a button (a, up, down, right) for ms, default 100
+//   hold <button>
+//   release <button>
+//   serial <text>           queue text plus newline on Serial input
+//   frame <file.pbm>        dump what the panel shows
+//   expect <text>           fail unless Serial printed text since the last expect
+//   screen <text>           fail unless a terminal row shows text now
+//   stats                   print counters to stderr
+//
+// Exit status is 0 when every expect matched, 1 otherwise.
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <EEPROM.h>
+#include <stdio.h>
+#include <chrono>
+#include "minux_config.h"
+#include "minux_kernel.h"
+#include "minux_display.h"
+#include "minux_input.h"
+#include "minux_scheduler.h"
+#include "minux_fs.h"
+#include "minux_shell.h"
+#include "minux_timer.h"
+#include "minux_sound.h"
+#include "minux_line.h"
+#include "sim_panel.h"
+
+#ifndef OLED_RESET
+#define OLED_RESET -1
+#endif
+
+// Same wiring as the board
+#define BUZZER_PIN 9
+#define BTN_A 2
+#define BTN_UP 10
+#define BTN_DOWN 8
+#define BTN_RIGHT 7
+
+#if DISPLAY_PAGE_MODE
+DisplayList display;
+#else
+Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET);
+#endif
+MinuxTimers timers;
+MinuxKernel kernel;
+MinuxInput input;
+MinuxSound sound;
+MinuxDisplay ui(&display);
+MinuxScheduler scheduler;
+MinuxFS filesystem;
+MinuxShell shell;
+
+SimPanel panel;
+MinuxLine serialLine(&Serial);
+
+enum SimScreen {
+  SCREEN_DESKTOP,
+  SCREEN_TERMINAL,
+  SCREEN_INFO
+};
+
+static SimScreen screen = SCREEN_DESKTOP;
+static uint32_t loopCount = 0;
+static size_t expectFrom = 0;
+static bool failed = false;
+
+// Lines scripts can address, in the order of the button names
+static const char* const buttonNames[] = { "a", "up", "down", "right" };
+static const uint8_t buttonPins[] = { BTN_A, BTN_UP, BTN_DOWN, BTN_RIGHT };
+
+static void showDesktop() {
+  screen = SCREEN_DESKTOP;
+  shell.deactivate();
+  ui.showDesktop();
+}
+
+static void handleEvent(InputEvent event) {
+  switch (screen) {
+    case SCREEN_DESKTOP:
+      if (event == EVENT_BTN_A) {
+        screen = SCREEN_TERMINAL;
+        ui.setTerminalMode();
+        shell.activate();
+      } else if (event == EVENT_BTN_UP) {
+        screen = SCREEN_INFO;
+        ui.showSystemInfo();
+      } else if (event == EVENT_BTN_DOWN) {
+        screen = SCREEN_INFO;
+        ui.showFiles();
+      } else if (event == EVENT_BTN_RIGHT) {
+        screen = SCREEN_INFO;
+        ui.showProcessList();
+      }
+      break;
+      
+    case SCREEN_TERMINAL:
+      if (event == EVENT_BTN_A) showDesktop();
+      else if (event == EVENT_BTN_UP) shell.scrollView(TERM_ROWS / 2);
+      else if (event == EVENT_BTN_DOWN) shell.scrollView(-(TERM_ROWS / 2));
+      break;
+      
+    case SCREEN_INFO:
+      if (event != EVENT_NONE) showDesktop();
+      break;
+  }
+}
+
+static void setup() {
+  Serial.begin(115200);
+  Wire.attach(SCREEN_ADDRESS, &panel);
+  Wire.setClock(TWI_CLOCK_HZ);
+  
+  timers.init();
+  kernel.init();
+#if DISPLAY_PAGE_MODE
+  display.begin(SCREEN_ADDRESS);
+#else
+  display.begin(SSD1306_SWITCHCAPVCC, SCREEN_ADDRESS);
+#endif
+  ui.init();
+  ui.showBootScreen();
+  
+  input.init(BTN_A, BTN_UP, BTN_DOWN, BTN_RIGHT, BUZZER_PIN);
+  sound.init(BUZZER_PIN);
+  sound.play(MELODY_BOOT);
+  scheduler.init();
+  filesystem.init();
+  
+  Serial.println("Minux simulation ready");
+  showDesktop();
+}
+
+static void loop() {
+  timers.update();
+  sound.update();
+  
+  InputRecord events[INPUT_QUEUE_SIZE];
+  uint8_t count = input.read(events, INPUT_QUEUE_SIZE);
+  for (uint8_t i = 0; i < count; i++) handleEvent(events[i].event);
+  
+  // Serial feeds the shell in the terminal and the serial console elsewhere
+  if (screen == SCREEN_TERMINAL) {
+    while (Serial.available()) shell.processInput(Serial.read());
+  } else {
+    while (serialLine.poll(Serial)) {
+      char* argv[LINE_MAX_ARGS];
+      shell.runSerial(serialLine.parse(argv), argv);
+    }
+  }
+  
+  scheduler.tick();
+  kernel.idle();
+  loopCount++;
+}
+
+// Runs the system until the virtual clock reaches the given time
+static void runUntil(unsigned long until) {
+  simSetHorizon(until);
+  while (millis() < until) {
+    unsigned long before = micros();
+    loop();
+    // Nothing slept, so let the next millisecond tick by
+    if (micros() == before) simAdvance(1000 - micros() % 1000);
+  }
+}
+
+static int buttonPin(const char* name) {
+  for (uint8_t i = 0; i < 4; i++) {
+    if (!strcmp(name, buttonNames[i])) return buttonPins[i];
+  }
+  fprintf(stderr, "sim: unknown button '%s'\n", name);
+  failed = true;
+  return -1;
+}
+
+static void printStats(double wallMs) {
+  fprintf(stderr, "sim: virtual %lu ms, wall %.1f ms, %lu loop passes\n",
+          millis(), wallMs, (unsigned long)loopCount);
+  fprintf(stderr, "sim: i2c %lu bytes in %lu transactions, %llu us of bus time\n",
+          (unsigned long)Wire.getBytes(), (unsigned long)Wire.getTransactions(),
+          (unsigned long long)Wire.getBusMicros());
+  fprintf(stderr, "sim: panel %lu data bytes, %lu command bytes; %u flushes\n",
+          (unsigned long)panel.getDataBytes(), (unsigned long)panel.getCommandBytes(),
+          ui.getFlushCount());
+#if ENABLE_FS_STORE
+  MinuxStore& store = filesystem.getStore();
+  fprintf(stderr, "sim: eeprom %lu bytes written; log %u used, %u live, %u records\n",
+          (unsigned long)EEPROM.getWrites(), store.getUsed(), store.getLive(), store.getRecords());
+#endif
+}
+
+static void runCommand(char* line, double wallMs) {
+  char* cmd = strtok(line, " \t");
+  if (!cmd || cmd[0] == '#') return;
+  char* rest = strtok(nullptr, "");
+  if (rest) rest += strspn(rest, " \t");
+  
+  if (!strcmp(cmd, "wait")) {
+    runUntil(millis() + (rest ? strtoul(rest, nullptr, 10) : 0));
+  } else if (!strcmp(cmd, "press") || !strcmp(cmd, "hold") || !strcmp(cmd, "release")) {
+    char* name = rest ? strtok(rest, " \t") : nullptr;
+    int pin = name ? buttonPin(name) : -1;
+    if (pin < 0) return;
+    if (!strcmp(cmd, "release")) {
+      simSetPin(pin, HIGH);
+    } else {
+      simSetPin(pin, LOW);
+      if (!strcmp(cmd, "press")) {
+        char* ms = strtok(nullptr, " \t");
+        runUntil(millis() + (ms ? strtoul(ms, nullptr, 10) : 100));
+        simSetPin(pin, HIGH);
+      }
+    }
+  } else if (!strcmp(cmd, "serial")) {
+    simSerialInput(rest ? rest : "");
+    simSerialInput("\n");
+  } else if (!strcmp(cmd, "frame")) {
+    if (!rest || !panel.writePBM(rest)) {
+      fprintf(stderr, "sim: cannot write frame '%s'\n", rest ? rest : "");
+      failed = true;
+    }
+  } else if (!strcmp(cmd, "expect")) {
+    const char* out = simSerialOutput();
+    const char* hit = rest ? strstr(out + expectFrom, rest) : nullptr;
+    if (hit) {
+      expectFrom = hit - out + strlen(rest);
+    } else {
+      fprintf(stderr, "sim: expected '%s' at %lu ms\n", rest ? rest : "", millis());
+      failed = true;
+    }
+  } else if (!strcmp(cmd, "screen")) {
+    // Shell output goes to the terminal, not Serial
+    char row[TERM_COLS + 1];
+    bool hit = false;
+    for (uint8_t r = 0; r < TERM_ROWS && !hit; r++) {
+      memcpy(row, ui.terminalRow(r), TERM_COLS);
+      row[TERM_COLS] = '\0';
+      hit = rest && strstr(row, rest);
+    }
+    if (!hit) {
+      fprintf(stderr, "sim: expected '%s' on the terminal at %lu ms, showing:\n", rest ? rest : "", millis());
+      for (uint8_t r = 0; r < TERM_ROWS; r++) fprintf(stderr, "sim: |%.*s|\n", TERM_COLS, ui.terminalRow(r));
+      failed = true;
+    }
+  } else if (!strcmp(cmd, "stats")) {
+    printStats(wallMs);
+  } else {
+    fprintf(stderr, "sim: unknown command '%s'\n", cmd);
+    failed = true;
+  }
+}
+
+int main(int argc, char** argv) {
+  FILE* script = stdin;
+  if (argc > 1 && !(script = fopen(argv[1], "r"))) {
+    fprintf(stderr, "sim: cannot open %s\n", argv[1]);
+    return 2;
+  }
+  
+  auto started = std::chrono::steady_clock::now();
+  setup();
+  
+  char line[256];
+  while (fgets(line, sizeof(line), script)) {
+    line[strcspn(line, "\r\n")] = '\0';
+    std::chrono::duration<double, std::milli> wall = std::chrono::steady_clock::now() - started;
+    runCommand(line, wall.count());
+  }
+  fflush(stdout);
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,143 @@
+#include "sim_panel.h"
+#include <stdio.h>
+
+SimPanel::SimPanel() {
+  memset(ram, 0, sizeof(ram));
+  mode = 2;                      // Page addressing after reset
+  colStart = 0;
+  colEnd = PANEL_WIDTH - 1;
+  col = 0;
+  pageStart = 0;
+  pageEnd = PANEL_PAGES - 1;
+  page = 0;
+  startLine = 0;
+  inverted = false;
+  on = false;
+  command = 0;
+  argsWanted = 0;
+  argCount = 0;
+  dataBytes = 0;
+  commandBytes = 0;
+}
+
+// Control byte 0x00 starts a command stream, 0x40 a data stream; with Co
+// set (0x80, 0xC0) only one byte follows before the next control byte
+void SimPanel::receive(const uint8_t* data, uint8_t length) {
+  uint8_t i = 0;
+  while (i < length) {
+    uint8_t control = data[i++];
+    bool single = control & 0x80;
+    bool isData = control & 0x40;
+    while (i < length) {
+      if (isData) onData(data[i++]);
+      else onCommand(data[i++]);
+      if (single) break;
+    }
+  }
+}
+
+void SimPanel::onCommand(uint8_t c) {
+  commandBytes++;
+  if (argsWanted) {
+    args[argCount++] = c;
+    if (argCount == argsWanted) {
+      argsWanted = 0;
+      runCommand();
+    }
+    return;
+  }
+  
+  command = c;
+  argCount = 0;
+  switch (c) {
+    case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xD3:
+    case 0xD5: case 0xD9: case 0xDA: case 0xDB:
+      argsWanted = 1;
+      break;
+    case 0x21: case 0x22: case 0xA3:
+      argsWanted = 2;
+      break;
+    case 0x29: case 0x2A:
+      argsWanted = 5;
+      break;
+    case 0x26: case 0x27:
+      argsWanted = 6;
+      break;
+    default:
+      runCommand();
+      break;
+  }
+}
+
+void SimPanel::runCommand() {
+  uint8_t c = command;
+  if (c == 0x20) {
+    mode = args[0] & 0x03;
+  } else if (c == 0x21) {
+    colStart = col = args[0] & 0x7F;
+    colEnd = args[1] & 0x7F;
+  } else if (c == 0x22) {
+    pageStart = page = args[0] & 0x07;
+    pageEnd = args[1] & 0x07;
+  } else if (c >= 0x40 && c <= 0x7F) {
+    startLine = c & 0x3F;
+  } else if (c == 0xA6 || c == 0xA7) {
+    inverted = c == 0xA7;
+  } else if (c == 0xAE || c == 0xAF) {
+    on = c == 0xAF;
+  } else if (c >= 0xB0 && c <= 0xB7) {
+    page = c & 0x07;
+  } else if (c <= 0x0F) {
+    col = (col & 0xF0) | c;
+  } else if (c >= 0x10 && c <= 0x1F) {
+    col = (col & 0x0F) | ((c & 0x07) << 4);
+  }
+}
+
+void SimPanel::onData(uint8_t d) {
+  dataBytes++;
+  ram[page][col] = d;
+  
+  switch (mode) {
+    case 0:
+      if (col++ >= colEnd) {
+        col = colStart;
+        page = page >= pageEnd ? pageStart : page + 1;
+      }
+      break;
+    case 1:
+      if (page++ >= pageEnd) {
+        page = pageStart;
+        col = col >= colEnd ? colStart : col + 1;
+      }
+      break;
+    default:
+      if (++col >= PANEL_WIDTH) col = 0;
+      break;
+  }
+}
+
+bool SimPanel::pixel(uint8_t x, uint8_t y) {
+  if (!on) return false;
+  uint8_t line = (y + startLine) & 0x3F;
+  bool lit = ram[line >> 3][x] & (1 << (line & 7));
+  return lit != inverted;
+}
+
+// Binary PBM; lit pixels are written white on black, as on the panel
+bool SimPanel::writePBM(const char* path) {
+  FILE* f = fopen(path, "wb");
+  if (!f) return false;
+  fprintf(f, "P4\n%d %d\n", PANEL_WIDTH, PANEL_PAGES * 8);
+  for (uint8_t y = 0; y < PANEL_PAGES * 8; y++) {
+    for (uint8_t x = 0; x < PANEL_WIDTH; x += 8) {
+      uint8_t bits = 0;
+      for (uint8_t b = 0; b < 8; b++) {
+        if (!pixel(x + b, y)) bits |= 0x80 >> b;
+      }
+      fputc(bits, f);
+    }
+  }
+  fclose(f);
+  return true;
+}
@@ -0,0 +1,45 @@
+#ifndef SIM_PANEL_H
+#define SIM_PANEL_H
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#define PANEL_WIDTH         128
+#define PANEL_PAGES         8
+
+// SSD1306 controller model. It decodes the command stream and keeps its
+// own GDDRAM, so frames reflect what reached the panel over I2C (addressing
+// windows, start line, inversion), not what sits in a framebuffer.
+class SimPanel : public WireDevice {
+private:
+  uint8_t ram[PANEL_PAGES][PANEL_WIDTH];
+  uint8_t mode;                  // 0 horizontal, 1 vertical, 2 page
+  uint8_t colStart, colEnd, col;
+  uint8_t pageStart, pageEnd, page;
+  uint8_t startLine;
+  bool inverted;
+  bool on;
+  
+  // Multi-byte commands may span transactions
+  uint8_t command;
+  uint8_t argsWanted;
+  uint8_t args[6];
+  uint8_t argCount;
+  
+  uint32_t dataBytes;
+  uint32_t commandBytes;
+  
+  void onCommand(uint8_t c);
+  void runCommand();
+  void onData(uint8_t d);
+  
+public:
+  SimPanel();
+  void receive(const uint8_t* data, uint8_t length) override;
+  bool pixel(uint8_t x, uint8_t y);    // As seen on the glass
+  bool writePBM(const char* path);
+  uint32_t getDataBytes() { return dataBytes; }
+  uint32_t getCommandBytes() { return commandBytes; }
+};
+
+#endif
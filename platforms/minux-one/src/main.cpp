@@ -9,6 +9,12 @@
 #include "minux_scheduler.h"
 #include "minux_fs.h"
 #include "minux_shell.h"
+#include "minux_timer.h"
+#include "minux_line.h"
+#include "minux_command.h"
+#include "minux_syscmd.h"
+#include "minux_sound.h"
+#include "minux_trace.h"
 
 #define SCREEN_WIDTH 128
 #define SCREEN_HEIGHT 64
@@ -21,11 +27,13 @@
 #define BTN_RIGHT 7
 
 Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET);
+MinuxTimers timers;
+MinuxKernel kernel;
+MinuxInput input;
+MinuxSound sound;
 
-// Comment out all Minux objects - Arduino Nano has insufficient SRAM
-// MinuxKernel kernel;
-// MinuxDisplay ui(&display);
-// MinuxInput input;
+// Comment out the remaining Minux objects - Arduino Nano has insufficient SRAM
+// MinuxDisplay ui(&display);   // DISPLAY_PAGE_MODE: DisplayList panel; MinuxDisplay ui(&panel);
 // MinuxScheduler scheduler;
 // MinuxFS filesystem;
 // MinuxShell shell;
@@ -41,48 +49,53 @@ AppState currentState = STATE_DESKTOP;
 
 // Function declarations
 int getFreeMemory();
-void runTasks();
-void updateDisplay();
+void runTasks(void* arg);
+void updateDisplay(void* arg);
 void checkButtons();
 void processSerial();
-void updateStatus();
+void updateStatus(void* arg);
 void showMainScreen();
-void scanI2C();
 
 // Lightweight RTOS variables
-unsigned long lastTaskSwitch = 0;
 unsigned long taskSwitchInterval = 50; // 50ms task switching
 uint8_t currentTask = 0;
-uint8_t numTasks = 4;
+uint8_t numTasks = 2;
 bool displayWorking = false;
 
+// Periodic work runs off the kernel timer wheel
+SoftTimer taskTimer;
+SoftTimer displayTimer;
+SoftTimer statusTimer;
+SoftTimer cursorTimer;
+SoftTimer screenTimer;    // Puts a temporary screen away again
+
+// Serial command line, edited in place with echo back to the host
+MinuxLine serialLine(&Serial);
+
 // Memory management utility
 int getFreeMemory() {
+#if defined(__AVR__)
   extern int __heap_start, *__brkval;
   int v;
   return (int) &v - (__brkval == 0 ? (int) &__heap_start : (int) __brkval);
+#else
+  return kernel.getMemoryInfo().free;
+#endif
 }
 
 // Lightweight task scheduler
-void runTasks() {
-  if (millis() - lastTaskSwitch > taskSwitchInterval) {
-    switch(currentTask) {
-      case 0:
-        updateDisplay();
-        break;
-      case 1:
-        checkButtons();
-        break;
-      case 2:
-        processSerial();
-        break;
-      case 3:
-        updateStatus();
-        break;
-    }
-    currentTask = (currentTask + 1) % numTasks;
-    lastTaskSwitch = millis();
+void runTasks(void*) {
+  TRACE(TASK_BEGIN, currentTask);
+  switch(currentTask) {
+    case 0:
+      checkButtons();
+      break;
+    case 1:
+      processSerial();
+      break;
   }
+  TRACE(TASK_END, currentTask);
+  currentTask = (currentTask + 1) % numTasks;
 }
 unsigned long lastInput = 0;
 bool terminalMode = false;
@@ -91,11 +104,13 @@ void handleDesktopInput(InputEvent event);
 void handleTerminalInput(InputEvent event);
 void handleSysInfoInput(InputEvent event);
 void handleFilesInput(InputEvent event);
-void handleGlobalSerialCommand(String cmd);
 void enterTerminal();
 void showSystemInfo();
 void showFiles();
 void returnToDesktop();
+void blinkCursor(void* arg);
+void restoreMainScreen(void* arg);
+void restoreDesktop(void* arg);
 
 void idle_task();
 void ui_task();
@@ -143,12 +158,10 @@ void setup() {
     Serial.println("System will work via serial commands only");
   }
   
-  // Initialize input pins
-  pinMode(BTN_A, INPUT_PULLUP);
-  pinMode(BTN_UP, INPUT_PULLUP);
-  pinMode(BTN_DOWN, INPUT_PULLUP);
-  pinMode(BTN_RIGHT, INPUT_PULLUP);
-  pinMode(BUZZER_PIN, OUTPUT);
+  // Initialize input pins, presses are captured by pin-change interrupts
+  input.init(BTN_A, BTN_UP, BTN_DOWN, BTN_RIGHT, BUZZER_PIN);
+  sound.init(BUZZER_PIN);
+  sound.play(MELODY_BOOT);
   
   Serial.println("Input pins initialized");
   
@@ -172,42 +185,51 @@ void setup() {
     Serial.println("Display not available - using serial mode");
   }
   
+  kernel.init();
+  timers.init();
+  timers.armPeriodic(&taskTimer, taskSwitchInterval, runTasks);
+  timers.armPeriodic(&displayTimer, 1000, updateDisplay);
+  timers.armPeriodic(&statusTimer, 5000, updateStatus);
+  
   Serial.println("=== MINUX LITE READY ===");
   Serial.println("Commands: help, mem, tasks, clear, i2c");
   Serial.print("Free Memory: ");
   Serial.print(getFreeMemory());
   Serial.println(" bytes");
-  Serial.println("Display Status: " + String(displayWorking ? "Working" : "Failed"));
+  Serial.print("Display Status: ");
+  Serial.println(displayWorking ? "Working" : "Failed");
 }
 
 void loop() {
-  // Run lightweight task scheduler
-  runTasks();
+  // Run whatever timers are due
+  timers.update();
+  sound.update();
   
-  // Small delay to prevent overwhelming the system
-  delay(1);
+  // A press that woke us is handled now, not on the task timer's next turn
+  if (input.pending()) checkButtons();
+  
+  // Sleep until the next deadline, a button press or serial input
+  kernel.idle();
 }
 
 // Lightweight task implementations
-void updateDisplay() {
+void updateDisplay(void*) {
   if(!displayWorking) return;
   
-  static unsigned long lastUpdate = 0;
-  if (millis() - lastUpdate > 1000) { // Update every second
-    display.setTextSize(1);
-    display.setTextColor(SSD1306_WHITE);
-    display.setCursor(100, 0);
-    display.print(millis()/1000);
-    display.display();
-    lastUpdate = millis();
-  }
+  display.setTextSize(1);
+  display.setTextColor(SSD1306_WHITE);
+  display.setCursor(100, 0);
+  display.print(millis()/1000);
+  display.display();
 }
 
 void checkButtons() {
-  static bool lastBtnA = HIGH;
-  bool btnA = digitalRead(BTN_A);
+  InputRecord events[INPUT_QUEUE_SIZE];
+  uint8_t count = input.read(events, INPUT_QUEUE_SIZE);
   
-  if (lastBtnA == HIGH && btnA == LOW) {
+  for (uint8_t i = 0; i < count; i++) {
+    if (events[i].event != EVENT_BTN_A) continue;
+    
     // Button A pressed - show menu
     if(displayWorking) {
       display.clearDisplay();
@@ -226,118 +248,118 @@ void checkButtons() {
       display.display();
       
       Serial.println("Menu displayed");
-      delay(2000); // Show menu for 2 seconds
       
-      // Return to main screen
-      showMainScreen();
+      // Show menu for 2 seconds, then return to main screen
+      timers.arm(&screenTimer, 2000, restoreMainScreen);
     } else {
       Serial.println("=== BUTTON MENU ===");
       Serial.println("Display not available - use serial commands:");
       Serial.println("mem, tasks, i2c, help");
     }
   }
-  lastBtnA = btnA;
 }
 
+// Lite serial commands; the table must stay sorted by name
+static void liteTasks(uint8_t, char**);
+static void liteClear(uint8_t, char**);
+static void cmdTrace(uint8_t argc, char** argv);
+
+static constexpr Command liteCommands[] PROGMEM = {
+  { "clear",  "Clear screen",     liteClear },
+  COMMAND_HELP,
+  COMMAND_I2C,
+  COMMAND_MEM,
+  COMMAND_REBOOT,
+  { "tasks",  "Show task info",   liteTasks },
+  { "trace",  "dump|clear|on|off", cmdTrace },
+};
+COMMAND_TABLE_CHECK(liteCommands);
+
 void processSerial() {
-  static String inputBuffer = "";
-  
-  while (Serial.available()) {
-    char c = Serial.read();
+  while (serialLine.poll(Serial)) {
+    char* argv[LINE_MAX_ARGS];
+    uint8_t argc = serialLine.parse(argv);
+    if (argc == 0) continue;
     
-    if (c == '\n' || c == '\r') {
-      // Process complete command
-      inputBuffer.trim();
-      
-      if (inputBuffer.length() > 0) {
-        Serial.print("Command received: ");
-        Serial.println(inputBuffer);
-        
-        if (inputBuffer == "help") {
-          Serial.println("=== MINUX LITE COMMANDS ===");
-          Serial.println("help - Show this help");
-          Serial.println("mem - Show memory info");
-          Serial.println("tasks - Show task info");
-          Serial.println("clear - Clear screen");
-          Serial.println("i2c - Scan I2C bus");
-          Serial.println("reboot - Restart system");
-        }
-        else if (inputBuffer == "mem") {
-          Serial.print("Free Memory: ");
-          Serial.print(getFreeMemory());
-          Serial.println(" bytes");
-          Serial.println("Total SRAM: 2048 bytes");
-          Serial.print("Used: ");
-          Serial.print(2048 - getFreeMemory());
-          Serial.println(" bytes");
-          Serial.print("Usage: ");
-          Serial.print(((2048 - getFreeMemory()) * 100) / 2048);
-          Serial.println("%");
-        }
-        else if (inputBuffer == "tasks") {
-          Serial.println("=== TASK INFO ===");
-          Serial.println("Task 0: Display Update");
-          Serial.println("Task 1: Button Handler");
-          Serial.println("Task 2: Serial Handler");
-          Serial.println("Task 3: Status Update");
-          Serial.print("Current Task: ");
-          Serial.println(currentTask);
-          Serial.print("Task Switch Interval: ");
-          Serial.print(taskSwitchInterval);
-          Serial.println("ms");
-        }
-        else if (inputBuffer == "clear") {
-          if(displayWorking) {
-            showMainScreen();
-            Serial.println("Screen cleared");
-          } else {
-            Serial.println("Display not available");
-          }
-        }
-        else if (inputBuffer == "i2c") {
-          scanI2C();
-        }
-        else if (inputBuffer == "reboot") {
-          Serial.println("Rebooting...");
-          delay(1000);
-          asm volatile ("  jmp 0");
-        }
-        else {
-          Serial.print("Unknown command: '");
-          Serial.print(inputBuffer);
-          Serial.println("'");
-          Serial.println("Type 'help' for commands");
-        }
-      }
-      
-      inputBuffer = "";
-    }
-    else if (c >= 32 && c <= 126) {
-      // Printable character
-      inputBuffer += c;
-      Serial.print(c); // Echo character
-    }
-    else if (c == 8 || c == 127) {
-      // Backspace
-      if (inputBuffer.length() > 0) {
-        inputBuffer.remove(inputBuffer.length() - 1);
-        Serial.print("\b \b");
-      }
+    Serial.print("Command received: ");
+    Serial.println(argv[0]);
+    
+    if (!runCommand(liteCommands, COMMAND_COUNT(liteCommands), argc, argv)) {
+      sound.play(MELODY_ERROR);
+      Serial.print("Unknown command: '");
+      Serial.print(argv[0]);
+      Serial.println("'");
+      Serial.println("Type 'help' for commands");
     }
   }
 }
 
-void updateStatus() {
-  // Update status info periodically
-  static unsigned long lastStatusUpdate = 0;
-  if (millis() - lastStatusUpdate > 5000) { // Every 5 seconds
-    Serial.print("System Status - Uptime: ");
-    Serial.print(millis()/1000);
-    Serial.print("s, Free RAM: ");
-    Serial.print(getFreeMemory());
-    Serial.println(" bytes");
-    lastStatusUpdate = millis();
+static void liteTasks(uint8_t, char**) {
+  Serial.println("=== TASK INFO ===");
+  Serial.println("Task 0: Button Handler");
+  Serial.println("Task 1: Serial Handler");
+  Serial.println("Timer: Display Update (1000ms)");
+  Serial.println("Timer: Status Update (5000ms)");
+  Serial.print("Current Task: ");
+  Serial.println(currentTask);
+  Serial.print("Task Switch Interval: ");
+  Serial.print(taskSwitchInterval);
+  Serial.println("ms");
+  Serial.print("Armed Timers: ");
+  Serial.println(timers.getArmedCount());
+  Serial.print("Asleep: ");
+  Serial.print(kernel.getSleepTime());
+  Serial.print("ms of ");
+  Serial.print(kernel.getUptime());
+  Serial.print("ms, ");
+  Serial.print(kernel.getWakeCount());
+  Serial.println(" wakeups");
+  Serial.print("Input events dropped: ");
+  Serial.println(input.getDropped());
+}
+
+static void liteClear(uint8_t, char**) {
+  if(displayWorking) {
+    showMainScreen();
+    Serial.println("Screen cleared");
+  } else {
+    Serial.println("Display not available");
+  }
+}
+
+// The dump is binary; decode it on the host with tools/trace_decode.py
+static void cmdTrace(uint8_t argc, char** argv) {
+#if ENABLE_DEBUG
+  if (argc > 1 && strcmp(argv[1], "dump") == 0) {
+    trace.dump(Serial);
+    Serial.flush();
+  } else if (argc > 1 && strcmp(argv[1], "clear") == 0) {
+    trace.clear();
+    Serial.println("Trace cleared");
+  } else if (argc > 1 && (strcmp(argv[1], "on") == 0 || strcmp(argv[1], "off") == 0)) {
+    trace.setEnabled(argv[1][1] == 'n');
+  } else {
+    Serial.print("Trace: ");
+    Serial.print(trace.getCount());
+    Serial.print("/");
+    Serial.print(TRACE_RECORDS);
+    Serial.print(" records, ");
+    Serial.print(trace.getOverwritten());
+    Serial.print(" overwritten, ");
+    Serial.println(trace.isEnabled() ? "on" : "off");
   }
+#else
+  Serial.println("Tracing needs ENABLE_DEBUG");
+#endif
+}
+
+void updateStatus(void*) {
+  // Update status info periodically
+  Serial.print("System Status - Uptime: ");
+  Serial.print(millis()/1000);
+  Serial.print("s, Free RAM: ");
+  Serial.print(getFreeMemory());
+  Serial.println(" bytes");
 }
 
 void showMainScreen() {
@@ -363,44 +385,6 @@ void showMainScreen() {
   display.display();
 }
 
-void scanI2C() {
-  Serial.println("=== I2C SCANNER ===");
-  Serial.println("Scanning...");
-  
-  int nDevices = 0;
-  for(byte address = 1; address < 127; address++) {
-    Wire.beginTransmission(address);
-    byte error = Wire.endTransmission();
-    
-    if (error == 0) {
-      Serial.print("I2C device found at address 0x");
-      if (address < 16) Serial.print("0");
-      Serial.print(address, HEX);
-      Serial.println(" !");
-      nDevices++;
-    }
-    else if (error == 4) {
-      Serial.print("Unknown error at address 0x");
-      if (address < 16) Serial.print("0");
-      Serial.println(address, HEX);
-    }
-  }
-  
-  if (nDevices == 0) {
-    Serial.println("No I2C devices found");
-    Serial.println("Check connections:");
-    Serial.println("SDA -> A4 (Pin 18)");
-    Serial.println("SCL -> A5 (Pin 19)");
-    Serial.println("VCC -> 5V");
-    Serial.println("GND -> GND");
-  } else {
-    Serial.print("Found ");
-    Serial.print(nDevices);
-    Serial.println(" device(s)");
-  }
-  Serial.println("Done");
-}
-
 void handleDesktopInput(InputEvent event) {
   switch(event) {
     case EVENT_BTN_A:
@@ -416,20 +400,9 @@ void handleDesktopInput(InputEvent event) {
       break;
       
     case EVENT_BTN_RIGHT:
-      // Show simple process info on display
-      display.clearDisplay();
-      display.setTextSize(1);
-      display.setTextColor(SSD1306_WHITE);
-      display.setCursor(0, 0);
-      display.println("=== PROCESSES ===");
-      display.setCursor(0, 15);
-      display.print("Active: ");
-      display.println(scheduler.getProcessCount());
-      display.setCursor(0, 35);
-      display.println("Showing for 2 seconds...");
-      display.display();
-      delay(2000);
-      returnToDesktop();
+      // Process list for 2 seconds
+      ui.showProcessList();
+      timers.arm(&screenTimer, 2000, restoreDesktop);
       break;
       
     case EVENT_NONE:
@@ -447,6 +420,10 @@ void handleTerminalInput(InputEvent event) {
   // In terminal mode, handle button to exit
   if (event == EVENT_BTN_A) {
     returnToDesktop();
+  } else if (event == EVENT_BTN_UP) {
+    shell.scrollView(TERM_ROWS / 2);
+  } else if (event == EVENT_BTN_DOWN) {
+    shell.scrollView(-(TERM_ROWS / 2));
   }
   
   // Note: Serial input is handled globally now
@@ -469,85 +446,21 @@ void enterTerminal() {
   currentState = STATE_TERMINAL;
   terminalMode = true;
   
-  display.clearDisplay();
-  display.setTextSize(1);
-  display.setTextColor(SSD1306_WHITE);
-  display.setCursor(0, 0);
-  display.println("=== TERMINAL MODE ===");
-  display.setCursor(0, 15);
-  display.println("Use serial monitor");
-  display.setCursor(0, 25);
-  display.println("for commands");
-  display.setCursor(0, 45);
-  display.println("Button A: Exit");
-  display.display();
-  
+  ui.setTerminalMode();
   shell.activate();
+  timers.armPeriodic(&cursorTimer, 500, blinkCursor);
   lastInput = millis();
 }
 
 void showSystemInfo() {
   currentState = STATE_SYSINFO;
-  
-  display.clearDisplay();
-  display.setTextSize(1);
-  display.setTextColor(SSD1306_WHITE);
-  display.setCursor(0, 0);
-  display.println("=== SYSTEM INFO ===");
-  
-  MemInfo mem = kernel.getMemoryInfo();
-  display.setCursor(0, 15);
-  display.print("Uptime: ");
-  display.print(kernel.getUptime() / 1000);
-  display.println("s");
-  
-  display.setCursor(0, 25);
-  display.print("Free RAM: ");
-  display.print(mem.free);
-  display.println("b");
-  
-  display.setCursor(0, 35);
-  display.print("Processes: ");
-  display.println(scheduler.getProcessCount());
-  
-  display.setCursor(0, 45);
-  display.print("Files: ");
-  display.println(filesystem.getFileCount());
-  
-  display.setCursor(0, 55);
-  display.println("Press any button to return");
-  display.display();
+  ui.showSystemInfo();
   lastInput = millis();
 }
 
 void showFiles() {
   currentState = STATE_FILES;
-  
-  display.clearDisplay();
-  display.setTextSize(1);
-  display.setTextColor(SSD1306_WHITE);
-  display.setCursor(0, 0);
-  display.println("=== FILE SYSTEM ===");
-  display.setCursor(0, 15);
-  
-  for (int i = 0; i < filesystem.getFileCount(); i++) {
-    FileEntry* file = filesystem.getFile(i);
-    if (file) {
-      if (file->isDirectory) {
-        display.print("[DIR]  ");
-      } else {
-        display.print("[FILE] ");
-      }
-      display.print(file->name);
-      display.print(" (");
-      display.print(file->size);
-      display.println("b)");
-    }
-  }
-  
-  display.setCursor(0, 55);
-  display.println("Press any button to return");
-  display.display();
+  ui.showFiles();
   lastInput = millis();
 }
 
@@ -555,176 +468,33 @@ void returnToDesktop() {
   currentState = STATE_DESKTOP;
   terminalMode = false;
   shell.deactivate();
-  
-  // Show simple desktop using direct display calls
-  display.clearDisplay();
-  display.setTextSize(1);
-  display.setTextColor(SSD1306_WHITE);
-  display.setCursor(0, 0);
-  display.println("=== MINUX DESKTOP ===");
-  display.setCursor(0, 15);
-  display.println("BTN_A: Terminal");
-  display.setCursor(0, 25);
-  display.println("BTN_UP: System Info");
-  display.setCursor(0, 35);
-  display.println("BTN_DOWN: Files");
-  display.setCursor(0, 45);
-  display.println("BTN_RIGHT: Processes");
-  display.setCursor(0, 55);
-  display.println("Serial: help");
-  display.display();
+  timers.cancel(&cursorTimer);
+  timers.cancel(&screenTimer);
+  ui.showDesktop();
 }
 
-void handleGlobalSerialCommand(String cmd) {
-  cmd.toLowerCase();
-  
-  if (cmd == "help") {
-    Serial.println("=== Minux RTOS Commands ===");
-    Serial.println("help      - Show this help");
-    Serial.println("status    - Show system status");
-    Serial.println("ps        - Show running processes");
-    Serial.println("mem       - Show memory information");
-    Serial.println("uptime    - Show system uptime");
-    Serial.println("desktop   - Show desktop");
-    Serial.println("terminal  - Enter terminal mode");
-    Serial.println("sysinfo   - Show system info screen");
-    Serial.println("files     - Show file browser");
-    Serial.println("reboot    - Restart system");
-    Serial.println("version   - Show version info");
-    Serial.println("clear     - Clear display");
-  } 
-  else if (cmd == "status") {
-    MemInfo mem = kernel.getMemoryInfo();
-    Serial.println("=== System Status ===");
-    Serial.print("Version: Minux RTOS v");
-    Serial.println(MINUX_VERSION_STRING);
-    Serial.print("Uptime: ");
-    Serial.print(kernel.getUptime() / 1000);
-    Serial.println(" seconds");
-    Serial.print("Free RAM: ");
-    Serial.print(mem.free);
-    Serial.print("/");
-    Serial.print(mem.total);
-    Serial.println(" bytes");
-    Serial.print("Memory fragmentation: ");
-    Serial.print(mem.fragmentation);
-    Serial.println("%");
-    Serial.print("Current state: ");
-    switch(currentState) {
-      case STATE_DESKTOP: Serial.println("Desktop"); break;
-      case STATE_TERMINAL: Serial.println("Terminal"); break;
-      case STATE_SYSINFO: Serial.println("System Info"); break;
-      case STATE_FILES: Serial.println("File Browser"); break;
-    }
-  }
-  else if (cmd == "ps") {
-    Serial.println("=== Running Processes ===");
-    Serial.println("PID\tName\t\tState\tPriority");
-    Serial.println("------------------------------------");
-    for (int i = 0; i < MAX_PROCESSES; i++) {
-      ProcessControlBlock* pcb = scheduler.getProcess(i);
-      if (pcb && pcb->active) {
-        Serial.print(i);
-        Serial.print("\t");
-        Serial.print(pcb->name);
-        Serial.print("\t\t");
-        switch (pcb->state) {
-          case PROC_READY: Serial.print("READY"); break;
-          case PROC_RUNNING: Serial.print("RUNNING"); break;
-          case PROC_BLOCKED: Serial.print("BLOCKED"); break;
-          case PROC_TERMINATED: Serial.print("TERMINATED"); break;
-        }
-        Serial.print("\t");
-        Serial.println(pcb->priority);
-      }
-    }
-  }
-  else if (cmd == "mem") {
-    MemInfo mem = kernel.getMemoryInfo();
-    Serial.println("=== Memory Information ===");
-    Serial.print("Total: ");
-    Serial.print(mem.total);
-    Serial.println(" bytes");
-    Serial.print("Used: ");
-    Serial.print(mem.used);
-    Serial.println(" bytes");
-    Serial.print("Free: ");
-    Serial.print(mem.free);
-    Serial.println(" bytes");
-    Serial.print("Fragmentation: ");
-    Serial.print(mem.fragmentation);
-    Serial.println("%");
-  }
-  else if (cmd == "uptime") {
-    Serial.print("System uptime: ");
-    Serial.print(kernel.getUptime() / 1000);
-    Serial.println(" seconds");
-  }
-  else if (cmd == "desktop") {
-    returnToDesktop();
-    Serial.println("Switched to desktop");
-  }
-  else if (cmd == "terminal") {
-    enterTerminal();
-    Serial.println("Switched to terminal mode");
-  }
-  else if (cmd == "sysinfo") {
-    showSystemInfo();
-    Serial.println("Showing system info");
-  }
-  else if (cmd == "files") {
-    showFiles();
-    Serial.println("Showing file browser");
-  }
-  else if (cmd == "clear") {
-    display.clearDisplay();
-    display.display();
-    Serial.println("Display cleared");
-  }
-  else if (cmd == "reboot") {
-    Serial.println("Rebooting system...");
-    delay(1000);
-    asm volatile ("jmp 0"); // Reset Arduino
-  }
-  else if (cmd == "version") {
-    Serial.println("=== Version Information ===");
-    Serial.print("Minux RTOS v");
-    Serial.println(MINUX_VERSION_STRING);
-    Serial.println("Built for Arduino Nano");
-    Serial.print("Compiled: ");
-    Serial.print(__DATE__);
-    Serial.print(" ");
-    Serial.println(__TIME__);
-  }
-  else if (cmd != "") {
-    Serial.print("Unknown command: '");
-    Serial.print(cmd);
-    Serial.println("'");
-    Serial.println("Type 'help' for available commands");
-  }
+void restoreMainScreen(void*) {
+  showMainScreen();
+}
+
+void restoreDesktop(void*) {
+  returnToDesktop();
+}
+
+void blinkCursor(void*) {
+  // Armed while in terminal mode
+  // Simple cursor blink logic could go here
 }
 
 // System tasks
 void idle_task() {
-  // Update system status
-  static unsigned long lastUpdate = 0;
-  if (millis() - lastUpdate > 5000) {
-    filesystem.updateSystemInfo();
-    lastUpdate = millis();
-  }
+  // System status refresh and EEPROM log compaction run off the
+  // filesystem's own timers
   delay(50);
 }
 
 void ui_task() {
-  // Periodic UI updates
-  static unsigned long lastBlink = 0;
-  
-  // Blink cursor in terminal mode
-  if (terminalMode && millis() - lastBlink > 500) {
-    // Simple cursor blink logic could go here
-    lastBlink = millis();
-  }
-  
+  // Periodic UI updates, cursor blink runs off cursorTimer
   delay(100);
 }
 
@@ -0,0 +1,43 @@
+#include "minux_command.h"
+
+// Set for the length of one runCommand()
+static const Command* runningTable = nullptr;
+static uint8_t runningCount = 0;
+static Print* runningOut = &Serial;
+
+const Command* findCommand(const Command* table, uint8_t count, const char* name) {
+  uint8_t lo = 0;
+  uint8_t hi = count;
+  
+  while (lo < hi) {
+    uint8_t mid = (lo + hi) / 2;
+    int cmp = strcmp_P(name, table[mid].name);
+    if (cmp == 0) return &table[mid];
+    if (cmp < 0) hi = mid;
+    else lo = mid + 1;
+  }
+  return nullptr;
+}
+
+bool runCommand(const Command* table, uint8_t count, uint8_t argc, char** argv, Print& out) {
+  if (argc == 0) return false;
+  
+  const Command* cmd = findCommand(table, count, argv[0]);
+  if (!cmd) return false;
+  
+  runningTable = table;
+  runningCount = count;
+  runningOut = &out;
+  CommandHandler handler = (CommandHandler)pgm_read_ptr(&cmd->handler);
+  handler(argc, argv);
+  return true;
+}
+
+Print& commandOut() {
+  return *runningOut;
+}
+
+void commandHelp(uint8_t, char**) {
+  runningOut->println("Available commands:");
+  printCommandHelp(*runningOut, runningTable, runningCount);
+}
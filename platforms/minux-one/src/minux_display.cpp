@@ -1,10 +1,17 @@
 #include "minux_display.h"
 #include "minux_kernel.h"
 #include "minux_scheduler.h"
+#include "minux_fs.h"
+#include "minux_bench.h"
+#include "minux_trace.h"
+#if !ENABLE_ASYNC_TWI
+#include <Wire.h>
+#endif
 
 // External references
 extern MinuxKernel kernel;
 extern MinuxScheduler scheduler;
+extern MinuxFS filesystem;
 
 // Minimal bitmap icons (8x8)
 const uint8_t icons[][8] PROGMEM = {
@@ -18,40 +25,377 @@ const uint8_t icons[][8] PROGMEM = {
   {0xFF, 0x81, 0x81, 0x81, 0x81, 0xFF, 0x18, 0x3C}
 };
 
-MinuxDisplay::MinuxDisplay(Adafruit_SSD1306* disp) {
+// Bound data for the retained screens
+static uint32_t uptimeSeconds() { return kernel.getUptime() / 1000; }
+static uint32_t memUsed() { return kernel.getMemoryInfo().used; }
+static uint32_t memTotal() { return kernel.getMemoryInfo().total; }
+static uint32_t memFree() { return kernel.getMemoryInfo().free; }
+static uint32_t processCount() { return scheduler.getProcessCount(); }
+static uint32_t statusSource() { return ui.getStatusVersion(); }
+
+// Changes whenever a process comes, goes or changes state
+static uint32_t processSignature() {
+  uint32_t signature = scheduler.getProcessCount();
+  for (uint8_t i = 0; i < scheduler.getProcessCount(); i++) {
+    ProcessControlBlock* proc = scheduler.getProcess(i);
+    if (proc && proc->active) signature = signature * 31 + i * 8 + proc->state;
+  }
+  return signature;
+}
+
+// The file list shows the current directory
+static uint32_t fileSignature() {
+  uint8_t dir = filesystem.getCwd();
+  uint32_t signature = dir;
+  for (uint8_t i = filesystem.firstChild(dir); i != FS_NONE; i = filesystem.nextChild(i)) {
+    signature = signature * 31 + i * 8 + filesystem.getFile(i)->size;
+  }
+  return signature;
+}
+
+static void kernelRow(uint8_t, Print& out) {
+  out.print("Kernel: ");
+  out.print(kernel.getVersion());
+}
+
+static void processRow(uint8_t index, Print& out) {
+  ProcessControlBlock* proc = scheduler.getProcess(index);
+  if (!proc || !proc->active) return;
+  out.print(index);
+  out.print("   ");
+  out.print(proc->name);
+  out.print("  ");
+  switch (proc->state) {
+    case PROC_READY: out.print("RDY"); break;
+    case PROC_RUNNING: out.print("RUN"); break;
+    case PROC_SLEEPING: out.print("SLP"); break;
+    case PROC_BLOCKED: out.print("BLK"); break;
+    case PROC_TERMINATED: out.print("END"); break;
+  }
+}
+
+static void fileRow(uint8_t index, Print& out) {
+  uint8_t i = filesystem.firstChild(filesystem.getCwd());
+  while (i != FS_NONE && index--) i = filesystem.nextChild(i);
+  FileEntry* file = filesystem.getFile(i);
+  if (!file) return;
+  out.print(file->isDirectory ? "[DIR]  " : "[FILE] ");
+  out.print(file->name);
+  out.print(" (");
+  out.print(file->size);
+  out.print("b)");
+}
+
+static const Widget desktopScreen[] PROGMEM = {
+  { WIDGET_GRID,    0,  0,  16, "",  nullptr, nullptr },
+  { WIDGET_ICON,    10, 10, ICON_TERMINAL, "", nullptr, nullptr },
+  { WIDGET_ICON,    30, 10, ICON_SETTINGS, "", nullptr, nullptr },
+  { WIDGET_ICON,    50, 10, ICON_FILES,    "", nullptr, nullptr },
+  { WIDGET_ICON,    70, 10, ICON_MONITOR,  "", nullptr, nullptr },
+  { WIDGET_LABEL,   8,  20, 0,  "T", nullptr, nullptr },
+  { WIDGET_LABEL,   28, 20, 0,  "S", nullptr, nullptr },
+  { WIDGET_LABEL,   48, 20, 0,  "F", nullptr, nullptr },
+  { WIDGET_LABEL,   68, 20, 0,  "M", nullptr, nullptr },
+  { WIDGET_TASKBAR, 0,  56, 0,  "",  statusSource, nullptr },
+};
+WIDGET_SCREEN_CHECK(desktopScreen);
+
+static const Widget sysInfoScreen[] PROGMEM = {
+  { WIDGET_LABEL, 0,   0,  0, "=== SYSTEM INFO ===", nullptr, nullptr },
+  { WIDGET_LIST,  0,   8,  1, "",         nullptr, kernelRow },
+  { WIDGET_LABEL, 0,   16, 0, "Uptime: ", nullptr, nullptr },
+  { WIDGET_VALUE, 48,  16, 7, "",         uptimeSeconds, nullptr },
+  { WIDGET_LABEL, 90,  16, 0, "s",        nullptr, nullptr },
+  { WIDGET_LABEL, 0,   24, 0, "Memory: ", nullptr, nullptr },
+  { WIDGET_VALUE, 48,  24, 4, "",         memUsed, nullptr },
+  { WIDGET_LABEL, 72,  24, 0, "/",        nullptr, nullptr },
+  { WIDGET_VALUE, 78,  24, 4, "",         memTotal, nullptr },
+  { WIDGET_LABEL, 102, 24, 0, "b",        nullptr, nullptr },
+  { WIDGET_LABEL, 0,   32, 0, "Free: ",   nullptr, nullptr },
+  { WIDGET_VALUE, 36,  32, 4, "",         memFree, nullptr },
+  { WIDGET_LABEL, 60,  32, 0, " bytes",   nullptr, nullptr },
+  { WIDGET_LABEL, 0,   40, 0, "Processes: ", nullptr, nullptr },
+  { WIDGET_VALUE, 66,  40, 2, "",         processCount, nullptr },
+};
+WIDGET_SCREEN_CHECK(sysInfoScreen);
+
+static const Widget processScreen[] PROGMEM = {
+  { WIDGET_LABEL, 0, 0,  0, "=== PROCESSES ===",   nullptr, nullptr },
+  { WIDGET_LABEL, 0, 8,  0, "PID Name     State",  nullptr, nullptr },
+  { WIDGET_LABEL, 0, 16, 0, "-------------------", nullptr, nullptr },
+  { WIDGET_LIST,  0, 24, 5, "", processSignature, processRow },
+};
+WIDGET_SCREEN_CHECK(processScreen);
+
+static const Widget filesScreen[] PROGMEM = {
+  { WIDGET_LABEL, 0, 0,  0, "=== FILE SYSTEM ===", nullptr, nullptr },
+  { WIDGET_LIST,  0, 16, 4, "", fileSignature, fileRow },
+  { WIDGET_LABEL, 0, 56, 0, "Any button: return",  nullptr, nullptr },
+};
+WIDGET_SCREEN_CHECK(filesScreen);
+
+MinuxDisplay::MinuxDisplay(DisplayTarget* disp) : widgets(this) {
   display = disp;
+#if DISPLAY_PAGE_MODE
+  writer = disp;
+#else
+  writer = &glyphs;
+#endif
   currentMode = MODE_BOOT;
   cursor_x = 0;
   cursor_y = 0;
   inverted = false;
   strcpy(statusBar, "Minux RTOS v0.1");
+  statusVersion = 0;
+  bytesSent = 0;
+  flushCount = 0;
+  startLine = 0;
+  charsRendered = 0;
+  for (uint8_t page = 0; page < DISPLAY_PAGES; page++) {
+    dirtyLo[page] = 0;
+    dirtyHi[page] = SCREEN_WIDTH - 1;
+  }
+#if ENABLE_ASYNC_TWI
+  for (uint8_t i = 0; i < DISPLAY_STAGING; i++) {
+    PageSlot* slot = &slots[i];
+    slot->busy = false;
+    slot->commandXfer.address = SCREEN_ADDRESS;
+    slot->commandXfer.control = 0x00;
+    slot->commandXfer.txData = slot->commands;
+    slot->commandXfer.txLength = sizeof(slot->commands);
+    slot->dataXfer.address = SCREEN_ADDRESS;
+    slot->dataXfer.control = 0x40;
+    slot->dataXfer.txData = slot->data;
+    slot->dataXfer.done = slotDone;
+    slot->dataXfer.arg = slot;
+  }
+#endif
 }
 
 void MinuxDisplay::init() {
+#if !DISPLAY_PAGE_MODE
+  // The framebuffer only exists once begin() has allocated it
+  glyphs.begin(display->getBuffer());
+#endif
   display->clearDisplay();
   display->setTextSize(1);
-  display->setTextColor(SSD1306_WHITE);
-  display->setCursor(0, 0);
+  writer->setTextColor(SSD1306_WHITE);
+  writer->setCursor(0, 0);
 }
 
 void MinuxDisplay::clear() {
   display->clearDisplay();
+  markDirty(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
+  term.reset();
+  widgets.hide();
+}
+
+// Widens each touched page's dirty column range to cover the rectangle
+void MinuxDisplay::markDirty(int16_t x, int16_t y, int16_t w, int16_t h) {
+  if (x < 0) { w += x; x = 0; }
+  if (y < 0) { h += y; y = 0; }
+  if (x + w > SCREEN_WIDTH) w = SCREEN_WIDTH - x;
+  if (y + h > SCREEN_HEIGHT) h = SCREEN_HEIGHT - y;
+  if (w <= 0 || h <= 0) return;
+  
+  for (uint8_t page = y / 8; page <= (y + h - 1) / 8; page++) {
+    if (x < dirtyLo[page]) dirtyLo[page] = x;
+    if (x + w - 1 > dirtyHi[page]) dirtyHi[page] = x + w - 1;
+  }
+}
+
+// Marks what the last print starting at (x, y) covered, judged by where the
+// GFX cursor ended up; wrapped output dirties the full rows it spans
+void MinuxDisplay::markText(int16_t x, int16_t y) {
+  int16_t endX = writer->getCursorX();
+  int16_t endY = writer->getCursorY();
+  if (endY == y) markDirty(x, y, endX - x, 8);
+  else markDirty(0, y, SCREEN_WIDTH, endY - y + 8);
 }
 
 void MinuxDisplay::update() {
-  display->display();
+  // The first request in a frame schedules the flush, later ones ride along
+  if (!timers.isArmed(&frameTimer)) {
+    timers.arm(&frameTimer, UI_UPDATE_MS, frameDue, this);
+  }
 }
 
+void MinuxDisplay::frameDue(void* arg) {
+  ((MinuxDisplay*)arg)->sendPages(false);
+}
+
+void MinuxDisplay::flush() {
+  sendPages(true);
+}
+
+#if ENABLE_ASYNC_TWI
+PageSlot* MinuxDisplay::freeSlot() {
+  for (uint8_t i = 0; i < DISPLAY_STAGING; i++) {
+    if (!slots[i].busy) return &slots[i];
+  }
+  return nullptr;
+}
+
+// Runs from the TWI interrupt once the page data is out
+void MinuxDisplay::slotDone(TwiTransfer* t) {
+  ((PageSlot*)t->arg)->busy = false;
+}
+
+bool MinuxDisplay::isFlushing() {
+  for (uint8_t i = 0; i < DISPLAY_STAGING; i++) {
+    if (slots[i].busy) return true;
+  }
+  return false;
+}
+#else
+bool MinuxDisplay::isFlushing() {
+  return false;
+}
+#endif
+
+// With the async bus a page is staged and queued, and the next one is drawn
+// while it goes out. When every slot is taken a timer-driven flush picks up
+// the rest on the next tick; a direct flush() waits for a slot instead.
+void MinuxDisplay::sendPages(bool block) {
+  BENCH_SCOPE(DISPLAY_FLUSH);
+  TRACE_SCOPE(FLUSH, 0);
+  timers.cancel(&frameTimer);
+#if !ENABLE_ASYNC_TWI
+  (void)block;   // Every page goes straight out
+#endif
+  if (currentMode == MODE_TERMINAL) renderTerminal();
+#if !DISPLAY_PAGE_MODE
+  const uint8_t* buffer = display->getBuffer();
+#endif
+  
+  for (uint8_t page = 0; page < DISPLAY_PAGES; page++) {
+    uint8_t lo = dirtyLo[page];
+    uint8_t hi = dirtyHi[page];
+    if (lo > hi) continue;
+    
+#if ENABLE_ASYNC_TWI
+    PageSlot* slot = freeSlot();
+    if (!slot && !block) {
+      timers.arm(&frameTimer, TIMER_TICK_MS, frameDue, this);
+      return;
+    }
+    while (!slot) slot = freeSlot();
+#endif
+    dirtyLo[page] = 0xFF;
+    dirtyHi[page] = 0;
+    
+#if DISPLAY_PAGE_MODE
+    // No framebuffer: render the page from the display list on the spot
+    const uint8_t* data = display->renderPage(page) + lo;
+#else
+    const uint8_t* data = buffer + page * SCREEN_WIDTH + lo;
+#endif
+    uint8_t remaining = hi - lo + 1;
+    
+#if ENABLE_ASYNC_TWI
+    // Window commands go out as one command stream, the span as one write
+    slot->commands[0] = SSD1306_PAGEADDR;
+    slot->commands[1] = page;
+    slot->commands[2] = page;
+    slot->commands[3] = SSD1306_COLUMNADDR;
+    slot->commands[4] = lo;
+    slot->commands[5] = hi;
+    memcpy(slot->data, data, remaining);
+    slot->dataXfer.txLength = remaining;
+    slot->busy = true;
+    twi.submit(&slot->commandXfer);
+    twi.submit(&slot->dataXfer);
+    bytesSent += sizeof(slot->commands) + 1 + remaining + 1;
+#else
+    // Window the controller's write pointer onto the dirty span only
+    display->ssd1306_command(SSD1306_PAGEADDR);
+    display->ssd1306_command(page);
+    display->ssd1306_command(page);
+    display->ssd1306_command(SSD1306_COLUMNADDR);
+    display->ssd1306_command(lo);
+    display->ssd1306_command(hi);
+    bytesSent += 6 * 2;   // Control byte plus command, one transfer each
+    
+    while (remaining) {
+      uint8_t n = remaining < DISPLAY_I2C_CHUNK ? remaining : DISPLAY_I2C_CHUNK;
+      Wire.beginTransmission(SCREEN_ADDRESS);
+      Wire.write((uint8_t)0x40);
+      Wire.write(data, n);
+      Wire.endTransmission();
+      bytesSent += n + 1;
+      data += n;
+      remaining -= n;
+    }
+#endif
+  }
+  
+  // Move the panel's start line once the recycled row is on it
+  uint8_t line = currentMode == MODE_TERMINAL ? term.getTop() * 8 : 0;
+  if (line != startLine) {
+    display->ssd1306_command(SSD1306_SETSTARTLINE | line);
+    startLine = line;
+  }
+  flushCount++;
+}
+
+// Draws changed cells at their physical rows; the start line does the rest
+void MinuxDisplay::renderTerminal() {
+#if DISPLAY_PAGE_MODE
+  // A display list cannot overwrite cells, so re-record the grid as one text
+  // run per row when anything changed, and only flush the rows that did
+  bool changed = false;
+  for (uint8_t row = 0; row < TERM_ROWS; row++) {
+    uint32_t mask = term.takeDirty(row);
+    if (!mask) continue;
+    changed = true;
+    markDirty(0, row * 8, TERM_COLS * 6, 8);
+  }
+  if (!changed) return;
+  
+  display->clearDisplay();
+  for (uint8_t row = 0; row < TERM_ROWS; row++) {
+    const char* text = term.viewRow(row);
+    uint8_t length = TERM_COLS;
+    while (length && text[length - 1] == ' ') length--;
+    writer->setCursor(0, row * 8);
+    for (uint8_t c = 0; c < length; c++) writer->write(text[c]);
+    charsRendered += length;
+  }
+#else
+  for (uint8_t row = 0; row < TERM_ROWS; row++) {
+    uint32_t mask = term.takeDirty(row);
+    if (!mask) continue;
+    const char* text = term.viewRow(row);
+    
+    // Opaque cells overwrite the old glyph, no clear needed
+    glyphs.setTextColor(SSD1306_WHITE, SSD1306_BLACK);
+    uint8_t first = 0xFF, last = 0;
+    for (uint8_t c = 0; mask; c++, mask >>= 1) {
+      if (!(mask & 1)) continue;
+      glyphs.drawGlyph(c * GLYPH_WIDTH, row * 8, text[c]);
+      if (first == 0xFF) first = c;
+      last = c;
+      charsRendered++;
+    }
+    glyphs.setTextColor(SSD1306_WHITE);
+    markDirty(first * GLYPH_WIDTH, row * 8, (last - first + 1) * GLYPH_WIDTH, 8);
+  }
+#endif
+}
+
+
 void MinuxDisplay::showBootScreen() {
   clear();
   display->setTextSize(1);
-  display->setCursor(30, 10);
-  display->println("MINUX RTOS");
-  display->setCursor(35, 25);
-  display->println("v0.1.0");
-  display->setCursor(15, 40);
-  display->println("Initializing...");
-  update();
+  writer->setCursor(30, 10);
+  writer->println("MINUX RTOS");
+  writer->setCursor(35, 25);
+  writer->println("v0.1.0");
+  writer->setCursor(15, 40);
+  writer->println("Initializing...");
+  
+  // Timers are not running yet during boot
+  flush();
 }
 
 void MinuxDisplay::showLoadingBar(uint8_t progress) {
@@ -59,48 +403,27 @@ void MinuxDisplay::showLoadingBar(uint8_t progress) {
   display->drawRect(10, 55, 108, 8, SSD1306_WHITE);
   uint8_t barWidth = (progress * 106) / 100;
   display->fillRect(11, 56, barWidth, 6, SSD1306_WHITE);
-  update();
+  markDirty(10, 55, 108, 8);
+  flush();
 }
 
 void MinuxDisplay::showDesktop() {
   clear();
   currentMode = MODE_DESKTOP;
-  
-  // Desktop background pattern
-  for(int i = 0; i < 128; i += 16) {
-    for(int j = 0; j < 64; j += 16) {
-      display->drawPixel(i, j, SSD1306_WHITE);
-    }
-  }
-  
-  // Draw icons
-  drawIcon(10, 10, ICON_TERMINAL);
-  drawIcon(30, 10, ICON_SETTINGS);
-  drawIcon(50, 10, ICON_FILES);
-  drawIcon(70, 10, ICON_MONITOR);
-  
-  // Icon labels
-  display->setTextSize(1);
-  display->setCursor(8, 20);
-  display->print("T");
-  display->setCursor(28, 20);
-  display->print("S");
-  display->setCursor(48, 20);
-  display->print("F");
-  display->setCursor(68, 20);
-  display->print("M");
-  
-  drawTaskbar();
-  update();
+  widgets.show(desktopScreen, WIDGET_COUNT(desktopScreen));
 }
 
 void MinuxDisplay::drawTaskbar() {
-  // Bottom taskbar
-  display->fillRect(0, 56, 128, 8, SSD1306_WHITE);
-  display->setTextColor(SSD1306_BLACK);
-  display->setCursor(2, 57);
-  display->print(statusBar);
-  display->setTextColor(SSD1306_WHITE);
+  paintTaskbar(56);
+  markDirty(0, 56, SCREEN_WIDTH, 8);
+}
+
+void MinuxDisplay::paintTaskbar(uint8_t y) {
+  display->fillRect(0, y, SCREEN_WIDTH, 8, SSD1306_WHITE);
+  writer->setTextColor(SSD1306_BLACK);
+  writer->setCursor(2, y + 1);
+  writer->print(statusBar);
+  writer->setTextColor(SSD1306_WHITE);
 }
 
 void MinuxDisplay::drawWindow(uint8_t x, uint8_t y, uint8_t w, uint8_t h, const char* title) {
@@ -108,10 +431,11 @@ void MinuxDisplay::drawWindow(uint8_t x, uint8_t y, uint8_t w, uint8_t h, const
   display->drawRect(x, y, w, h, SSD1306_WHITE);
   // Title bar
   display->fillRect(x, y, w, 10, SSD1306_WHITE);
-  display->setTextColor(SSD1306_BLACK);
-  display->setCursor(x + 2, y + 2);
-  display->print(title);
-  display->setTextColor(SSD1306_WHITE);
+  writer->setTextColor(SSD1306_BLACK);
+  writer->setCursor(x + 2, y + 2);
+  writer->print(title);
+  writer->setTextColor(SSD1306_WHITE);
+  markDirty(x, y, w, h);
 }
 
 void MinuxDisplay::setTerminalMode() {
@@ -119,171 +443,111 @@ void MinuxDisplay::setTerminalMode() {
   currentMode = MODE_TERMINAL;
   cursor_x = 0;
   cursor_y = 0;
-  display->setCursor(0, 0);
-  display->print("minux:/ $ ");
+  char path[FS_MAX_PATH];
+  term.print("minux:");
+  term.print(filesystem.getPath(filesystem.getCwd(), path, sizeof(path)) ? path : "?");
+  term.print(" $ ");
   update();
 }
 
 void MinuxDisplay::printChar(char c) {
-  if (c == '\n') {
-    cursor_y += 8;
-    cursor_x = 0;
-    if (cursor_y >= 56) {
-      // Scroll up
-      cursor_y = 48;
-      // Simple scroll simulation
-      clear();
-      cursor_y = 0;
-    }
-  } else {
-    display->setCursor(cursor_x, cursor_y);
-    display->print(c);
-    cursor_x += 6;
-    if (cursor_x >= 122) {
-      cursor_x = 0;
-      cursor_y += 8;
-    }
-  }
-  update();
-}
-
-void MinuxDisplay::print(const char* text) {
-  display->setCursor(cursor_x, cursor_y);
-  display->print(text);
-  cursor_x += strlen(text) * 6;
-  if (cursor_x >= 122) {
-    cursor_x = 0;
-    cursor_y += 8;
-  }
-  update();
-}
-
-void MinuxDisplay::print(int value) {
-  display->setCursor(cursor_x, cursor_y);
-  display->print(value);
-  cursor_x += 6 * 5; // Approximate width
-  if (cursor_x >= 122) {
-    cursor_x = 0;
-    cursor_y += 8;
-  }
-  update();
-}
-
-void MinuxDisplay::print(long value) {
-  display->setCursor(cursor_x, cursor_y);
-  display->print(value);
-  cursor_x += 6 * 8; // Approximate width
-  if (cursor_x >= 122) {
+  if (currentMode == MODE_TERMINAL) {
+    term.write(c);
+  } else if (c == '\n') {
     cursor_x = 0;
     cursor_y += 8;
+    if (cursor_y >= SCREEN_HEIGHT) cursor_y = 0;
+  } else {
+    writer->setCursor(cursor_x, cursor_y);
+    writer->print(c);
+    markDirty(cursor_x, cursor_y, 6, 8);
+    cursor_x = writer->getCursorX();
+    cursor_y = writer->getCursorY();
   }
   update();
 }
 
-void MinuxDisplay::print(unsigned long value) {
-  display->setCursor(cursor_x, cursor_y);
-  display->print(value);
-  cursor_x += 6 * 8; // Approximate width
-  if (cursor_x >= 122) {
-    cursor_x = 0;
-    cursor_y += 8;
-  }
-  update();
+// The Print side; println's '\r' would draw a glyph outside the terminal
+size_t MinuxDisplay::write(uint8_t c) {
+  if (c != '\r') printChar(c);
+  return 1;
 }
 
-void MinuxDisplay::print(uint16_t value) {
-  display->setCursor(cursor_x, cursor_y);
-  display->print(value);
-  cursor_x += 6 * 5; // Approximate width
-  if (cursor_x >= 122) {
-    cursor_x = 0;
-    cursor_y += 8;
+// Terminal output goes to the cell grid; other modes draw straight to the
+// target and pick the cursor up from wherever GFX left it
+template <typename T>
+void MinuxDisplay::emit(T value) {
+  if (currentMode == MODE_TERMINAL) {
+    term.print(value);
+  } else {
+    writer->setCursor(cursor_x, cursor_y);
+    writer->print(value);
+    markText(cursor_x, cursor_y);
+    cursor_x = writer->getCursorX();
+    cursor_y = writer->getCursorY();
   }
   update();
 }
 
-void MinuxDisplay::print(uint8_t value) {
-  display->setCursor(cursor_x, cursor_y);
-  display->print(value);
-  cursor_x += 6 * 3; // Approximate width
-  if (cursor_x >= 122) {
-    cursor_x = 0;
-    cursor_y += 8;
-  }
-  update();
-}
+void MinuxDisplay::print(const char* text) { emit(text); }
+void MinuxDisplay::print(int value) { emit(value); }
+void MinuxDisplay::print(long value) { emit(value); }
+void MinuxDisplay::print(unsigned long value) { emit(value); }
+void MinuxDisplay::print(uint16_t value) { emit((unsigned int)value); }
+void MinuxDisplay::print(uint8_t value) { emit((unsigned int)value); }
 
 void MinuxDisplay::println(const char* text) {
-  display->setCursor(cursor_x, cursor_y);
-  display->println(text);
-  cursor_y += 8;
-  if (cursor_y >= 56) cursor_y = 0;
+  if (currentMode == MODE_TERMINAL) {
+    term.println(text);
+    update();
+    return;
+  }
+  writer->setCursor(cursor_x, cursor_y);
+  writer->print(text);
+  markText(cursor_x, cursor_y);
+  cursor_x = 0;
+  cursor_y = writer->getCursorY() + 8;
+  if (cursor_y >= SCREEN_HEIGHT) cursor_y = 0;
   update();
 }
 
 void MinuxDisplay::setCursor(uint8_t x, uint8_t y) {
   cursor_x = x;
   cursor_y = y;
-  display->setCursor(x, y);
+  writer->setCursor(x, y);
+  if (currentMode == MODE_TERMINAL) term.setCursor(x / 6, y / 8);
+}
+
+void MinuxDisplay::scrollView(int8_t lines) {
+  if (currentMode != MODE_TERMINAL) return;
+  term.scrollView(lines);
+  update();
 }
 
 void MinuxDisplay::showSystemInfo() {
   clear();
-  display->setCursor(0, 0);
-  display->println("=== SYSTEM INFO ===");
-  display->print("Kernel: ");
-  display->println(kernel.getVersion());
-  display->print("Uptime: ");
-  display->print(kernel.getUptime() / 1000);
-  display->println("s");
-  
-  MemInfo mem = kernel.getMemoryInfo();
-  display->print("Memory: ");
-  display->print(mem.used);
-  display->print("/");
-  display->print(mem.total);
-  display->println(" bytes");
-  
-  display->print("Free: ");
-  display->print(mem.free);
-  display->println(" bytes");
-  
-  update();
+  widgets.show(sysInfoScreen, WIDGET_COUNT(sysInfoScreen));
 }
 
 void MinuxDisplay::showProcessList() {
   clear();
-  display->setCursor(0, 0);
-  display->println("=== PROCESSES ===");
-  display->println("PID Name     State");
-  display->println("-------------------");
-  
-  for (int i = 0; i < scheduler.getProcessCount(); i++) {
-    ProcessControlBlock* proc = scheduler.getProcess(i);
-    if (proc && proc->active) {
-      display->print(i);
-      display->print("   ");
-      display->print(proc->name);
-      display->print("  ");
-      switch(proc->state) {
-        case PROC_READY: display->println("RDY"); break;
-        case PROC_RUNNING: display->println("RUN"); break;
-        case PROC_BLOCKED: display->println("BLK"); break;
-        case PROC_TERMINATED: display->println("END"); break;
-      }
-    }
-  }
+  widgets.show(processScreen, WIDGET_COUNT(processScreen));
+}
   
-  update();
+void MinuxDisplay::showFiles() {
+  clear();
+  widgets.show(filesScreen, WIDGET_COUNT(filesScreen));
 }
 
 void MinuxDisplay::updateStatusBar(const char* text) {
   strncpy(statusBar, text, 16);
   statusBar[16] = '\0';
+  statusVersion++;
 }
 
 void MinuxDisplay::drawIcon(uint8_t x, uint8_t y, uint8_t icon) {
   if (icon < 4) {
     display->drawBitmap(x, y, icons[icon], 8, 8, SSD1306_WHITE);
+    markDirty(x, y, 8, 8);
   }
 }
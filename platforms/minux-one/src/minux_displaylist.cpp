@@ -0,0 +1,284 @@
+#include "minux_displaylist.h"
+#if ENABLE_ASYNC_TWI
+#include "minux_twi.h"
+#else
+#include <Wire.h>
+#endif
+
+#define OP_COLOR(style)     ((style) & 0x03)
+#define OP_TEXTBG(style)    (((style) >> 2) & 0x03)
+#define OP_TEXTSIZE(style)  ((style) >> 4)
+
+// SSD1306 128x64 power-up sequence (internal charge pump, horizontal addressing)
+static const uint8_t panelInit[] PROGMEM = {
+  0xAE,             // Display off
+  0xD5, 0x80,       // Clock divide
+  0xA8, 0x3F,       // Multiplex 64
+  0xD3, 0x00,       // No display offset
+  0x40,             // Start line 0
+  0x8D, 0x14,       // Charge pump on
+  0x20, 0x00,       // Horizontal addressing
+  0xA1,             // Segment remap
+  0xC8,             // COM scan descending
+  0xDA, 0x12,       // COM pins
+  0x81, 0xCF,       // Contrast
+  0xD9, 0xF1,       // Pre-charge
+  0xDB, 0x40,       // VCOM detect
+  0xA4,             // Resume from RAM
+  0xA6,             // Normal, not inverted
+  0x2E,             // Scrolling off
+  0xAF              // Display on
+};
+
+PageRenderer::PageRenderer() : Adafruit_GFX(SCREEN_WIDTH, SCREEN_HEIGHT) {
+  buffer = nullptr;
+  page = 0;
+  setTextWrap(false);
+}
+
+void PageRenderer::begin(uint8_t* buf, uint8_t pageIndex) {
+  buffer = buf;
+  page = pageIndex;
+  memset(buffer, 0, SCREEN_WIDTH);
+}
+
+void PageRenderer::drawPixel(int16_t x, int16_t y, uint16_t color) {
+  if (x < 0 || x >= SCREEN_WIDTH || y < 0 || (y >> 3) != page) return;
+  uint8_t bit = 1 << (y & 7);
+  switch (color) {
+    case 1: buffer[x] |= bit; break;
+    case 0: buffer[x] &= ~bit; break;
+    case 2: buffer[x] ^= bit; break;
+  }
+}
+
+// Clipped to this page, then applied a column byte at a time
+void PageRenderer::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  int16_t top = page * 8;
+  if (y < top) { h -= top - y; y = top; }
+  if (y + h > top + 8) h = top + 8 - y;
+  if (x < 0) { w += x; x = 0; }
+  if (x + w > SCREEN_WIDTH) w = SCREEN_WIDTH - x;
+  if (w <= 0 || h <= 0) return;
+  
+  uint8_t mask = (uint8_t)(0xFF << (y - top)) & (uint8_t)(0xFF >> (top + 8 - y - h));
+  for (uint8_t* col = buffer + x; w > 0; w--, col++) {
+    switch (color) {
+      case 1: *col |= mask; break;
+      case 0: *col &= ~mask; break;
+      case 2: *col ^= mask; break;
+    }
+  }
+}
+
+void PageRenderer::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+  fillRect(x, y, w, 1, color);
+}
+
+void PageRenderer::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+  fillRect(x, y, 1, h, color);
+}
+
+DisplayList::DisplayList() : Adafruit_GFX(SCREEN_WIDTH, SCREEN_HEIGHT) {
+  opCount = 0;
+  poolUsed = 0;
+  dropped = 0;
+  address = SCREEN_ADDRESS;
+}
+
+bool DisplayList::begin(uint8_t i2caddr) {
+  address = i2caddr;
+#if ENABLE_ASYNC_TWI
+  twi.init();
+#endif
+  for (uint8_t i = 0; i < sizeof(panelInit); i++) {
+    ssd1306_command(pgm_read_byte(&panelInit[i]));
+  }
+  
+  // Probe: a missing panel does not acknowledge its address
+#if ENABLE_ASYNC_TWI
+  return twi.probe(address);
+#else
+  Wire.beginTransmission(address);
+  return Wire.endTransmission() == 0;
+#endif
+}
+
+void DisplayList::ssd1306_command(uint8_t c) {
+#if ENABLE_ASYNC_TWI
+  twi.write(address, 0x00, &c, 1);
+#else
+  Wire.beginTransmission(address);
+  Wire.write((uint8_t)0x00);
+  Wire.write(c);
+  Wire.endTransmission();
+#endif
+}
+
+void DisplayList::invertDisplay(bool invert) {
+  ssd1306_command(invert ? 0xA7 : 0xA6);
+}
+
+void DisplayList::clearDisplay() {
+  opCount = 0;
+  poolUsed = 0;
+}
+
+DisplayOp* DisplayList::add(uint8_t type, int16_t x, int16_t y, uint16_t color) {
+  if (x < 0 || y < 0 || x >= SCREEN_WIDTH || y >= SCREEN_HEIGHT) return nullptr;
+  if (opCount >= DISPLAY_LIST_OPS) {
+    dropped++;
+    return nullptr;
+  }
+  DisplayOp* op = &ops[opCount++];
+  op->type = type;
+  op->style = color & 0x03;
+  op->x = x;
+  op->y = y;
+  return op;
+}
+
+uint8_t DisplayList::textStyle() {
+  return (textcolor & 0x03) | ((textbgcolor & 0x03) << 2) | (textsize_x << 4);
+}
+
+// Mirrors Adafruit_GFX's cursor handling for the built-in font, appending
+// characters to the open text run while they stay on one line
+size_t DisplayList::write(uint8_t c) {
+  if (c == '\r') return 1;
+  if (c == '\n') {
+    cursor_x = 0;
+    cursor_y += textsize_y * 8;
+    return 1;
+  }
+  if (wrap && cursor_x + textsize_x * 6 > _width) {
+    cursor_x = 0;
+    cursor_y += textsize_y * 8;
+  }
+  
+  DisplayOp* run = opCount ? &ops[opCount - 1] : nullptr;
+  bool extend = run && run->type == OP_TEXT && run->y == cursor_y &&
+                run->style == textStyle() &&
+                run->text.offset + run->text.length == poolUsed &&
+                run->x + run->text.length * textsize_x * 6 == cursor_x;
+  
+  if (poolUsed >= DISPLAY_TEXT_POOL) {
+    dropped++;
+  } else if (extend) {
+    textPool[poolUsed++] = c;
+    run->text.length++;
+  } else if ((run = add(OP_TEXT, cursor_x, cursor_y, textcolor))) {
+    run->style = textStyle();
+    run->text.offset = poolUsed;
+    run->text.length = 1;
+    textPool[poolUsed++] = c;
+  }
+  
+  cursor_x += textsize_x * 6;
+  return 1;
+}
+
+void DisplayList::drawPixel(int16_t x, int16_t y, uint16_t color) {
+  add(OP_PIXEL, x, y, color);
+}
+
+void DisplayList::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  DisplayOp* op = add(OP_FILL, x, y, color);
+  if (op) {
+    op->size.w = w;
+    op->size.h = h;
+  }
+}
+
+void DisplayList::drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  DisplayOp* op = add(OP_RECT, x, y, color);
+  if (op) {
+    op->size.w = w;
+    op->size.h = h;
+  }
+}
+
+void DisplayList::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+  fillRect(x, y, w, 1, color);
+}
+
+void DisplayList::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+  fillRect(x, y, 1, h, color);
+}
+
+// Only the 8x8 icon format is kept; anything else is dropped
+void DisplayList::drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color) {
+  if (w != 8 || h != 8) {
+    dropped++;
+    return;
+  }
+  DisplayOp* op = add(OP_BITMAP, x, y, color);
+  if (op) op->bitmap = bitmap;
+}
+
+void DisplayList::drawGrid(uint8_t spacing, uint16_t color) {
+  DisplayOp* op = add(OP_GRID, 0, 0, color);
+  if (op) op->size.w = spacing;
+}
+
+// Replays every operation that reaches into the page
+const uint8_t* DisplayList::renderPage(uint8_t page) {
+  renderer.begin(pageBuffer, page);
+  glyphs.begin(pageBuffer, page, 1);
+  uint8_t top = page * 8;
+  
+  for (uint8_t i = 0; i < opCount; i++) {
+    DisplayOp& op = ops[i];
+    uint8_t color = OP_COLOR(op.style);
+    
+    uint8_t height;
+    switch (op.type) {
+      case OP_TEXT: height = OP_TEXTSIZE(op.style) * 8; break;
+      case OP_FILL:
+      case OP_RECT: height = op.size.h; break;
+      case OP_BITMAP: height = 8; break;
+      case OP_GRID: height = SCREEN_HEIGHT; break;
+      default: height = 1; break;
+    }
+    if (op.y >= top + 8 || op.y + height <= top) continue;
+    
+    switch (op.type) {
+      case OP_TEXT:
+        if (OP_TEXTSIZE(op.style) == 1) {
+          // Runs never wrap, so glyphs go straight into the page
+          glyphs.setTextColor(color, OP_TEXTBG(op.style));
+          for (uint8_t n = 0; n < op.text.length; n++) {
+            glyphs.drawGlyph(op.x + n * GLYPH_WIDTH, op.y, textPool[op.text.offset + n]);
+          }
+          break;
+        }
+        renderer.setTextSize(OP_TEXTSIZE(op.style));
+        renderer.setTextColor(color, OP_TEXTBG(op.style));
+        renderer.setCursor(op.x, op.y);
+        for (uint8_t n = 0; n < op.text.length; n++) {
+          renderer.write(textPool[op.text.offset + n]);
+        }
+        break;
+      case OP_FILL:
+        renderer.fillRect(op.x, op.y, op.size.w, op.size.h, color);
+        break;
+      case OP_RECT:
+        renderer.drawRect(op.x, op.y, op.size.w, op.size.h, color);
+        break;
+      case OP_PIXEL:
+        renderer.drawPixel(op.x, op.y, color);
+        break;
+      case OP_BITMAP:
+        renderer.drawBitmap(op.x, op.y, op.bitmap, 8, 8, color);
+        break;
+      case OP_GRID:
+        if (top % op.size.w == 0) {
+          for (uint8_t x = 0; x < SCREEN_WIDTH; x += op.size.w) {
+            renderer.drawPixel(x, top, color);
+          }
+        }
+        break;
+    }
+  }
+  return pageBuffer;
+}
@@ -1,105 +1,597 @@
 #include "minux_fs.h"
 #include "minux_scheduler.h"
+#include "minux_bench.h"
+#include "minux_trace.h"
 
 // External references
 extern MinuxScheduler scheduler;
 
+static_assert(FS_BLOCKS <= 255 && FS_EXTENTS < FS_NONE, "block and extent indices are bytes");
+static_assert(MAX_FILES <= FS_ROOT, "entry numbers are bytes; FS_ROOT and FS_NONE are not entries");
+static_assert(FS_MAX_PATH - 2 <= FS_STORE_MAX_RECORD - STORE_OVERHEAD, "a path must fit in a log record");
+static_assert((FS_HASH_SLOTS & (FS_HASH_SLOTS - 1)) == 0 && FS_HASH_SLOTS > MAX_FILES,
+              "name index must be a power of two with a slot to spare");
+              
+#define FS_HASH_MASK (FS_HASH_SLOTS - 1)
+
+#if FS_HASH_SLOTS > 256
+typedef uint16_t FsSlot;
+#else
+typedef uint8_t FsSlot;
+#endif
+
+static inline uint16_t blocksFor(uint16_t size) {
+  return (size + FS_BLOCK_SIZE - 1) / FS_BLOCK_SIZE;
+}
+
+// djb2 (xor variant) over the directory and the name: the low bits pick
+// the slot, the high byte is the tag
+static uint16_t nameHash(uint8_t dir, const char* name) {
+  uint16_t hash = 5381;
+  hash = ((hash << 5) + hash) ^ dir;
+  while (*name) hash = ((hash << 5) + hash) ^ (uint8_t)*name++;
+  return hash;
+}
+
+static inline bool isDots(const char* name) {
+  return name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'));
+}
+
 MinuxFS::MinuxFS() {
   fileCount = 0;
-  strcpy(currentPath, "/");
+  slotCount = 0;
+  freeSlot = FS_NONE;
+  rootChild = FS_NONE;
+  cwd = FS_ROOT;
+  memset(nameIndex, FS_NONE, sizeof(nameIndex));
+  memset(blockMap, 0, sizeof(blockMap));
+  for (uint8_t i = 0; i < FS_EXTENTS; i++) extents[i].count = 0;
+  freeBlocks = FS_BLOCKS;
 }
 
 void MinuxFS::init() {
+  // System files are made before the store is mounted and never written
+  // out; they are rebuilt at every boot anyway
   createSystemFiles();
+  for (uint8_t i = 0; i < slotCount; i++) files[i].isVolatile = true;
+#if ENABLE_FS_STORE
+  store.mount(*this);
+  timers.armPeriodic(&maintenanceTimer, FS_MAINTENANCE_MS, maintainStore);
+#endif
+  timers.armPeriodic(&refreshTimer, SYSINFO_REFRESH_MS, refreshSystemInfo);
+}
+
+void MinuxFS::refreshSystemInfo(void*) {
+  filesystem.updateSystemInfo();
+}
+
+#if ENABLE_FS_STORE
+// At most FS_STORE_STEP bytes per run keeps each EEPROM burst short; writes
+// that find the log full compact for themselves
+void MinuxFS::maintainStore(void*) {
+  filesystem.compact();
+}
+#endif
+
+void MinuxFS::setUsed(uint8_t block, bool used) {
+  if (used) {
+    blockMap[block >> 3] |= 1 << (block & 7);
+    freeBlocks--;
+  } else {
+    blockMap[block >> 3] &= ~(1 << (block & 7));
+    freeBlocks++;
+  }
+}
+
+// Worst fit: new runs go into the largest free gap, centred when the gap is
+// bigger than needed, so the files on either side can still grow in place
+uint8_t MinuxFS::placeRun(uint16_t need) {
+  uint16_t bestStart = 0, bestLength = 0;
+  uint16_t block = 0;
+  while (block < FS_BLOCKS) {
+    if (isUsed(block)) {
+      block++;
+      continue;
+    }
+    uint16_t start = block;
+    while (block < FS_BLOCKS && !isUsed(block)) block++;
+    if (block - start > bestLength) {
+      bestStart = start;
+      bestLength = block - start;
+    }
+  }
+  return bestStart + (need < bestLength ? (bestLength - need) / 2 : 0);
 }
 
-bool MinuxFS::createFile(const char* name, const uint8_t* data, uint16_t size) {
-  if (fileCount >= MAX_FILES || size > MAX_FILESIZE) return false;
+uint8_t MinuxFS::newExtent(uint8_t start) {
+  for (uint8_t i = 0; i < FS_EXTENTS; i++) {
+    if (extents[i].count == 0) {
+      extents[i].start = start;
+      extents[i].count = 1;
+      extents[i].next = FS_NONE;
+      setUsed(start, true);
+      return i;
+    }
+  }
+  return FS_NONE;
+}
+
+// Grows the chain to cover size bytes. The last run is extended in place
+// while the block after it is free, so appends stay in few extents.
+bool MinuxFS::reserve(FileEntry* file, uint16_t size) {
+  uint16_t have = blocksFor(file->size);
+  uint16_t need = blocksFor(size);
+  if (need <= have) return true;
+  if (need - have > freeBlocks) return false;
   
-  FileEntry* file = &files[fileCount];
-  strncpy(file->name, name, MAX_FILENAME - 1);
-  file->name[MAX_FILENAME - 1] = '\0';
+  uint8_t last = file->extent;
+  while (last != FS_NONE && extents[last].next != FS_NONE) last = extents[last].next;
   
-  memcpy(file->data, data, size);
-  file->size = size;
+  for (; have < need; have++) {
+    if (last != FS_NONE) {
+      uint16_t after = extents[last].start + extents[last].count;
+      if (after < FS_BLOCKS && !isUsed(after) && extents[last].count < 255) {
+        setUsed(after, true);
+        extents[last].count++;
+        continue;
+      }
+    }
+    
+    uint8_t e = newExtent(placeRun(need - have));
+    if (e == FS_NONE) {
+      // Out of extents: give back what this call took
+      release(file, file->size);
+      return false;
+    }
+    if (last == FS_NONE) file->extent = e;
+    else extents[last].next = e;
+    last = e;
+  }
+  return true;
+}
+
+// Frees every block past the first size bytes
+void MinuxFS::release(FileEntry* file, uint16_t size) {
+  uint16_t keep = blocksFor(size);
+  uint8_t* link = &file->extent;
+  
+  while (*link != FS_NONE) {
+    FsExtent* ext = &extents[*link];
+    uint8_t kept = keep < ext->count ? keep : ext->count;
+    keep -= kept;
+    while (ext->count > kept) {
+      ext->count--;
+      setUsed(ext->start + ext->count, false);
+    }
+    
+    if (ext->count == 0) {
+      // Whole run gone; the chain continues from its successor
+      *link = ext->next;
+    } else {
+      link = &ext->next;
+    }
+  }
+}
+
+// Copies between a buffer and the file's runs; blocks in a run are adjacent,
+// so each run is a single memcpy
+uint16_t MinuxFS::transfer(FileEntry* file, uint16_t offset, uint8_t* buffer, uint16_t length, bool toFile) {
+  uint16_t done = 0;
+  for (uint8_t e = file->extent; e != FS_NONE && done < length; e = extents[e].next) {
+    uint16_t span = extents[e].count * FS_BLOCK_SIZE;
+    if (offset >= span) {
+      offset -= span;
+      continue;
+    }
+    
+    uint16_t n = min((uint16_t)(span - offset), (uint16_t)(length - done));
+    uint8_t* p = blocks[extents[e].start] + offset;
+    if (toFile) memcpy(p, buffer + done, n);
+    else memcpy(buffer + done, p, n);
+    done += n;
+    offset = 0;
+  }
+  return done;
+}
+
+// Deleted slots are reused first, newest first; fresh ones come after
+uint8_t MinuxFS::takeSlot() {
+  uint8_t slot = freeSlot;
+  if (slot != FS_NONE) {
+    freeSlot = files[slot].extent;
+  } else if (slotCount < MAX_FILES) {
+    slot = slotCount++;
+    files[slot].generation = 0;
+  }
+  return slot;
+}
+
+// Tombstones the slot: no name, a new generation, and onto the free list
+void MinuxFS::dropSlot(uint8_t slot) {
+  FileEntry* file = &files[slot];
+  file->name[0] = '\0';
+  file->generation++;
+  file->extent = freeSlot;
+  freeSlot = slot;
+}
+
+// place() has checked the name fits
+FileEntry* MinuxFS::newEntry(uint8_t slot, uint8_t dir, const char* name) {
+  FileEntry* file = &files[slot];
+  strcpy(file->name, name);
+  file->size = 0;
+  file->extent = FS_NONE;
+  file->parent = dir;
   file->isDirectory = false;
+  file->isVolatile = false;
+  file->logPos = STORE_NONE;
   file->created = millis();
   file->modified = millis();
-  
-  fileCount++;
+  return file;
+}
+
+// Takes a file or an empty directory out of the tree and frees its slot
+void MinuxFS::drop(uint8_t entry) {
+  FileEntry* file = &files[entry];
+#if ENABLE_FS_STORE
+  store.remove(file);
+#endif
+  if (!file->isDirectory) release(file, 0);
+  unlink(entry);
+  dropSlot(entry);
+  fileCount--;
+}
+
+// Checked before anything changes in RAM, so a full EEPROM fails the
+// operation instead of leaving a file that would not survive a reboot.
+// Records are named by the path from the root.
+bool MinuxFS::canStore(FileEntry* file, uint16_t pathLength, uint16_t size) {
+#if ENABLE_FS_STORE
+  if (file && file->isVolatile) return true;
+  return store.fits(pathLength, size);
+#else
+  (void)file;
+  (void)pathLength;
+  (void)size;
   return true;
+#endif
 }
 
-bool MinuxFS::deleteFile(const char* name) {
-  for (int i = 0; i < fileCount; i++) {
-    if (strcmp(files[i].name, name) == 0) {
-      // Shift remaining files
-      for (int j = i; j < fileCount - 1; j++) {
-        files[j] = files[j + 1];
-      }
-      fileCount--;
-      return true;
+void MinuxFS::stored(FileEntry* file) {
+#if ENABLE_FS_STORE
+  if (!file->isVolatile) store.save(*this, file);
+#else
+  (void)file;
+#endif
+}
+
+uint8_t MinuxFS::lookup(uint8_t dir, const char* name) {
+  uint16_t hash = nameHash(dir, name);
+  uint8_t tag = hash >> 8;
+  for (FsSlot slot = hash & FS_HASH_MASK;; slot = (slot + 1) & FS_HASH_MASK) {
+    uint8_t entry = nameIndex[slot];
+    if (entry == FS_NONE) return FS_NONE;
+    if (nameTag[entry] == tag && files[entry].parent == dir && strcmp(files[entry].name, name) == 0) return entry;
+  }
+}
+
+// Enters the entry in the name index and at the end of its directory
+void MinuxFS::link(uint8_t entry) {
+  FileEntry* file = &files[entry];
+  uint16_t hash = nameHash(file->parent, file->name);
+  nameTag[entry] = hash >> 8;
+  FsSlot slot = hash & FS_HASH_MASK;
+  while (nameIndex[slot] != FS_NONE) slot = (slot + 1) & FS_HASH_MASK;
+  nameIndex[slot] = entry;
+  
+  uint8_t& first = childrenOf(file->parent);
+  if (first == FS_NONE) {
+    first = entry;
+    file->next = file->prev = entry;
+  } else {
+    file->next = first;
+    file->prev = files[first].prev;
+    files[file->prev].next = entry;
+    files[first].prev = entry;
+  }
+}
+
+// Backward-shift delete, so the index never fills up with tombstones: later
+// members of the probe run move into the hole unless that would put them
+// ahead of their home slot
+void MinuxFS::unlink(uint8_t entry) {
+  FileEntry* file = &files[entry];
+  FsSlot hole = nameHash(file->parent, file->name) & FS_HASH_MASK;
+  while (nameIndex[hole] != entry) hole = (hole + 1) & FS_HASH_MASK;
+  
+  for (FsSlot slot = (hole + 1) & FS_HASH_MASK; nameIndex[slot] != FS_NONE; slot = (slot + 1) & FS_HASH_MASK) {
+    FileEntry* other = &files[nameIndex[slot]];
+    FsSlot home = nameHash(other->parent, other->name) & FS_HASH_MASK;
+    if (((slot - home) & FS_HASH_MASK) >= ((slot - hole) & FS_HASH_MASK)) {
+      nameIndex[hole] = nameIndex[slot];
+      hole = slot;
     }
   }
-  return false;
+  nameIndex[hole] = FS_NONE;
+  
+  uint8_t& first = childrenOf(file->parent);
+  if (file->next == entry) {
+    first = FS_NONE;
+  } else {
+    files[file->prev].next = file->next;
+    files[file->next].prev = file->prev;
+    if (first == entry) first = file->next;
+  }
 }
 
-FileEntry* MinuxFS::openFile(const char* name) {
-  for (int i = 0; i < fileCount; i++) {
-    if (strcmp(files[i].name, name) == 0) {
-      return &files[i];
+// Follows path from the root or the current directory, one index lookup
+// per component. With leaf, stops before the last component and copies it
+// there (empty when the path ends at a directory). Returns the directory
+// reached, FS_NONE when a component is missing, not a directory or too long.
+uint8_t MinuxFS::walk(const char* path, char* leaf) {
+  uint8_t dir = *path == '/' ? FS_ROOT : cwd;
+  char part[MAX_FILENAME];
+  
+  for (;;) {
+    while (*path == '/') path++;
+    if (!*path) break;
+    
+    const char* end = path;
+    while (*end && *end != '/') end++;
+    if (end - path >= MAX_FILENAME) return FS_NONE;
+    memcpy(part, path, end - path);
+    part[end - path] = '\0';
+    for (path = end; *path == '/'; path++);
+    
+    if (leaf && !*path) {
+      strcpy(leaf, part);
+      return dir;
+    }
+    if (strcmp(part, "..") == 0) {
+      if (dir != FS_ROOT) dir = files[dir].parent;
+    } else if (strcmp(part, ".") != 0) {
+      dir = lookup(dir, part);
+      if (dir == FS_NONE || !files[dir].isDirectory) return FS_NONE;
     }
   }
-  return nullptr;
+  if (leaf) leaf[0] = '\0';
+  return dir;
 }
 
-bool MinuxFS::writeFile(const char* name, const uint8_t* data, uint16_t size) {
-  FileEntry* file = openFile(name);
-  if (file && size <= MAX_FILESIZE) {
-    memcpy(file->data, data, size);
-    file->size = size;
-    file->modified = millis();
-    return true;
+// The entry a path names: a slot, FS_ROOT, or FS_NONE
+uint8_t MinuxFS::find(const char* path) {
+  // A plain name in the current directory needs no walk
+  if (!strchr(path, '/') && strlen(path) < MAX_FILENAME && !isDots(path)) {
+    return *path ? lookup(cwd, path) : FS_NONE;
   }
+  
+  char leaf[MAX_FILENAME];
+  uint8_t dir = walk(path, leaf);
+  if (dir == FS_NONE || !leaf[0] || strcmp(leaf, ".") == 0) return dir;
+  if (strcmp(leaf, "..") == 0) return dir == FS_ROOT ? FS_ROOT : files[dir].parent;
+  return lookup(dir, leaf);
+}
+
+// Where a new entry would go: its directory, with the name in leaf, or
+// FS_NONE when the name is unusable or the whole path too long
+uint8_t MinuxFS::place(const char* path, char* leaf) {
+  uint8_t dir = walk(path, leaf);
+  if (dir == FS_NONE || !leaf[0] || isDots(leaf)) return FS_NONE;
+  return pathLength(dir, leaf) + 2 <= FS_MAX_PATH ? dir : FS_NONE;
+}
+
+// Length of dir/name spelled out from the root, without the leading '/'
+uint16_t MinuxFS::pathLength(uint8_t dir, const char* name) {
+  uint16_t length = strlen(name);
+  for (; dir != FS_ROOT; dir = files[dir].parent) length += strlen(files[dir].name) + 1;
+  return length;
+}
+
+bool MinuxFS::compact() {
+#if ENABLE_FS_STORE
+  return store.compact(*this);
+#else
   return false;
+#endif
+}
+
+bool MinuxFS::createFile(const char* path, const uint8_t* data, uint16_t size) {
+  BENCH_SCOPE(FS_CREATE);
+  TRACE_SCOPE(FS, TRACE_FS_CREATE);
+  char name[MAX_FILENAME];
+  uint8_t dir = place(path, name);
+  if (dir == FS_NONE || fileCount >= MAX_FILES || lookup(dir, name) != FS_NONE) return false;
+  if (!canStore(nullptr, pathLength(dir, name), size)) return false;
+  
+  uint8_t slot = takeSlot();
+  FileEntry* file = newEntry(slot, dir, name);
+  if (!reserve(file, size)) {
+    dropSlot(slot);
+    return false;
+  }
+  
+  transfer(file, 0, (uint8_t*)data, size, true);
+  file->size = size;
+  
+  fileCount++;
+  link(slot);
+  stored(file);
+  return true;
 }
 
-uint16_t MinuxFS::readFile(const char* name, uint8_t* buffer, uint16_t maxSize) {
-  FileEntry* file = openFile(name);
-  if (file) {
-    uint16_t copySize = min(file->size, maxSize);
-    memcpy(buffer, file->data, copySize);
-    return copySize;
+// Files only; directories go through removeDir(). Nothing else moves,
+// the slot is tombstoned and reused by a later create.
+bool MinuxFS::deleteFile(const char* path) {
+  BENCH_SCOPE(FS_DELETE);
+  TRACE_SCOPE(FS, TRACE_FS_DELETE);
+  uint8_t slot = find(path);
+  if (slot >= MAX_FILES || files[slot].isDirectory) return false;
+  
+  drop(slot);
+  return true;
+}
+
+// FS_ROOT and FS_NONE are both past the last slot
+FileEntry* MinuxFS::openFile(const char* path) {
+  BENCH_SCOPE(FS_OPEN);
+  TRACE_SCOPE(FS, TRACE_FS_OPEN);
+  uint8_t entry = find(path);
+  return entry < MAX_FILES ? &files[entry] : nullptr;
+}
+
+// Replaces the contents; shrinking hands the tail blocks back to the heap
+bool MinuxFS::writeFile(const char* path, const uint8_t* data, uint16_t size) {
+  BENCH_SCOPE(FS_WRITE);
+  TRACE_SCOPE(FS, TRACE_FS_WRITE);
+  FileEntry* file = openFile(path);
+  if (!file || file->isDirectory) return false;
+  if (!canStore(file, pathLength(file->parent, file->name), size)) return false;
+  
+  if (size > file->size) {
+    if (!reserve(file, size)) return false;
+  } else {
+    release(file, size);
   }
-  return 0;
+  transfer(file, 0, (uint8_t*)data, size, true);
+  file->size = size;
+  file->modified = millis();
+  stored(file);
+  return true;
 }
 
-bool MinuxFS::createDir(const char* name) {
-  if (fileCount >= MAX_FILES) return false;
+bool MinuxFS::appendFile(const char* path, const uint8_t* data, uint16_t size) {
+  BENCH_SCOPE(FS_APPEND);
+  TRACE_SCOPE(FS, TRACE_FS_APPEND);
+  FileEntry* file = openFile(path);
+  if (!file || file->isDirectory || size > 0xFFFF - file->size) return false;
+  if (!canStore(file, pathLength(file->parent, file->name), file->size + size)) return false;
+  if (!reserve(file, file->size + size)) return false;
   
-  FileEntry* dir = &files[fileCount];
-  strncpy(dir->name, name, MAX_FILENAME - 1);
-  dir->name[MAX_FILENAME - 1] = '\0';
-  dir->size = 0;
+  transfer(file, file->size, (uint8_t*)data, size, true);
+  file->size += size;
+  file->modified = millis();
+  stored(file);
+  return true;
+}
+
+// Also moves between directories. System files keep their names; they are
+// recreated under them anyway. Stored as a new record under the new path,
+// so a power cut between that write and retiring the old record leaves
+// both names on the next boot. The records of a directory's contents carry
+// its path, so only an empty directory can be renamed.
+bool MinuxFS::renameFile(const char* path, const char* newPath) {
+  char name[MAX_FILENAME];
+  uint8_t entry = find(path);
+  uint8_t dir = place(newPath, name);
+  if (entry >= MAX_FILES || dir == FS_NONE || lookup(dir, name) != FS_NONE) return false;
+  FileEntry* file = &files[entry];
+  if (file->isDirectory && (file->child != FS_NONE || dir == entry)) return false;
+  if (file->isVolatile || !canStore(file, pathLength(dir, name), file->size)) return false;
+  
+  unlink(entry);
+  strcpy(file->name, name);
+  file->parent = dir;
+  link(entry);
+  file->modified = millis();
+  stored(file);
+  return true;
+}
+
+uint16_t MinuxFS::readFile(const char* path, uint8_t* buffer, uint16_t maxSize) {
+  BENCH_SCOPE(FS_READ);
+  TRACE_SCOPE(FS, TRACE_FS_READ);
+  FileEntry* file = openFile(path);
+  return file ? read(file, 0, buffer, maxSize) : 0;
+}
+
+uint16_t MinuxFS::read(FileEntry* file, uint16_t offset, uint8_t* buffer, uint16_t length) {
+  if (offset >= file->size) return 0;
+  if (length > file->size - offset) length = file->size - offset;
+  return transfer(file, offset, buffer, length, false);
+}
+
+uint8_t MinuxFS::getExtentCount(FileEntry* file) {
+  uint8_t n = 0;
+  for (uint8_t e = file->extent; e != FS_NONE; e = extents[e].next) n++;
+  return n;
+}
+
+bool MinuxFS::createDir(const char* path) {
+  char name[MAX_FILENAME];
+  uint8_t parent = place(path, name);
+  if (parent == FS_NONE || fileCount >= MAX_FILES || lookup(parent, name) != FS_NONE) return false;
+  if (!canStore(nullptr, pathLength(parent, name), 0)) return false;
+  
+  uint8_t slot = takeSlot();
+  FileEntry* dir = newEntry(slot, parent, name);
   dir->isDirectory = true;
-  dir->created = millis();
-  dir->modified = millis();
   
   fileCount++;
+  link(slot);
+  stored(dir);
   return true;
 }
 
-FileEntry* MinuxFS::getFile(uint8_t index) {
-  if (index < fileCount) {
-    return &files[index];
+// Only empty directories, and not the current one
+bool MinuxFS::removeDir(const char* path) {
+  uint8_t dir = find(path);
+  if (dir >= MAX_FILES || dir == cwd || !files[dir].isDirectory || files[dir].child != FS_NONE) return false;
+  
+  drop(dir);
+  return true;
+}
+
+bool MinuxFS::changeDir(const char* path) {
+  uint8_t dir = findDir(path);
+  if (dir == FS_NONE) return false;
+  cwd = dir;
+  return true;
+}
+
+// A directory's slot, FS_ROOT, or FS_NONE when path is not a directory
+uint8_t MinuxFS::findDir(const char* path) {
+  uint8_t dir = find(path);
+  return dir == FS_ROOT || (dir < MAX_FILES && files[dir].isDirectory) ? dir : FS_NONE;
+}
+
+// Spells out the absolute path of an entry or FS_ROOT, filling it in from
+// the end while climbing the parent links
+bool MinuxFS::getPath(uint8_t dir, char* path, uint8_t size) {
+  uint16_t length = dir == FS_ROOT ? 1 : pathLength(files[dir].parent, files[dir].name) + 1;
+  if (length >= size) return false;
+  
+  path[0] = '/';
+  path[length] = '\0';
+  for (; dir != FS_ROOT; dir = files[dir].parent) {
+    uint8_t n = strlen(files[dir].name);
+    length -= n;
+    memcpy(path + length, files[dir].name, n);
+    path[--length] = '/';
+  }
+  return true;
+}
+
+uint8_t MinuxFS::nextChild(uint8_t slot) {
+  uint8_t next = files[slot].next;
+  return next == childrenOf(files[slot].parent) ? FS_NONE : next;
+}
+
+FileEntry* MinuxFS::getFile(uint8_t slot) {
+  if (slot < slotCount && files[slot].name[0]) {
+    return &files[slot];
   }
   return nullptr;
 }
 
+FileEntry* MinuxFS::resolve(FileHandle handle) {
+  FileEntry* file = getFile(handle & 0xFF);
+  return file && file->generation == handle >> 8 ? file : nullptr;
+}
+
 void MinuxFS::createSystemFiles() {
   // Create minimal system files
   const char* version = "Minux v0.1";
-  createFile("version", (const uint8_t*)version, strlen(version));
+  createFile("/version", (const uint8_t*)version, strlen(version));
   
   updateSystemInfo();
 }
@@ -108,10 +600,9 @@ void MinuxFS::updateSystemInfo() {
   char sysinfo[32];
   sprintf(sysinfo, "Up:%lus Mem:%db", millis()/1000, 1024);
   
-  // Update or create system info file
-  if (openFile("sysinfo")) {
-    writeFile("sysinfo", (const uint8_t*)sysinfo, strlen(sysinfo));
-  } else {
-    createFile("sysinfo", (const uint8_t*)sysinfo, strlen(sysinfo));
+  // Update or create system info file; one lookup when it already exists.
+  // Absolute, since the shell may have moved the current directory.
+  if (!writeFile("/sysinfo", (const uint8_t*)sysinfo, strlen(sysinfo))) {
+    createFile("/sysinfo", (const uint8_t*)sysinfo, strlen(sysinfo));
   }
 }
@@ -0,0 +1,83 @@
+#include "minux_glyph.h"
+#include <glcdfont.c>   // Adafruit_GFX's classic 5x7 font
+
+GlyphBlitter::GlyphBlitter() {
+  buffer = nullptr;
+  firstPage = 0;
+  pageCount = 0;
+  cursorX = 0;
+  cursorY = 0;
+  color = 1;
+  background = 1;
+  glyphCount = 0;
+}
+
+void GlyphBlitter::begin(uint8_t* buf, uint8_t first, uint8_t pages) {
+  buffer = buf;
+  firstPage = first;
+  pageCount = pages;
+}
+
+// Applies glyph bits to one byte; mask covers the cell rows within it
+inline uint8_t GlyphBlitter::blend(uint8_t dst, uint8_t bits, uint8_t mask) {
+  uint8_t out;
+  switch (color) {
+    case 0: out = dst & ~bits; break;
+    case 2: out = dst ^ bits; break;
+    default: out = dst | bits; break;
+  }
+  if (background == color) return out;
+  
+  // Opaque: the rest of the cell takes the background
+  uint8_t paper = mask & ~bits;
+  switch (background) {
+    case 0: return out & ~paper;
+    case 2: return out ^ paper;
+    default: return out | paper;
+  }
+}
+
+void GlyphBlitter::drawGlyph(int16_t x, int16_t y, uint8_t c) {
+  if (!buffer) return;
+  
+  // Same glyph indexing as Adafruit_GFX with cp437 off
+  if (c >= 176) c++;
+  const uint8_t* glyph = font + c * 5;
+  
+  int16_t page = (y >> 3) - firstPage;
+  uint8_t shift = y & 7;
+  uint8_t* upper = page >= 0 && page < pageCount ? buffer + page * SCREEN_WIDTH : nullptr;
+  uint8_t* lower = shift && page + 1 >= 0 && page + 1 < pageCount ?
+                   buffer + (page + 1) * SCREEN_WIDTH : nullptr;
+  if (!upper && !lower) return;
+  
+  for (uint8_t i = 0; i < GLYPH_WIDTH; i++, x++) {
+    if (x < 0) continue;
+    if (x >= SCREEN_WIDTH) break;
+    uint8_t bits = i < 5 ? pgm_read_byte(glyph + i) : 0;
+    if (!shift) {
+      upper[x] = blend(upper[x], bits, 0xFF);
+      continue;
+    }
+    if (upper) upper[x] = blend(upper[x], bits << shift, 0xFF << shift);
+    if (lower) lower[x] = blend(lower[x], bits >> (8 - shift), 0xFF >> (8 - shift));
+  }
+  glyphCount++;
+}
+
+// Cursor handling follows Adafruit_GFX::write for size 1 with wrap on
+size_t GlyphBlitter::write(uint8_t c) {
+  if (c == '\r') return 1;
+  if (c == '\n') {
+    cursorX = 0;
+    cursorY += GLYPH_HEIGHT;
+    return 1;
+  }
+  if (cursorX + GLYPH_WIDTH > SCREEN_WIDTH) {
+    cursorX = 0;
+    cursorY += GLYPH_HEIGHT;
+  }
+  drawGlyph(cursorX, cursorY, c);
+  cursorX += GLYPH_WIDTH;
+  return 1;
+}
@@ -1,79 +1,158 @@
 #include "minux_input.h"
+#include "minux_config.h"
+#include "minux_sound.h"
+#include "minux_trace.h"
+
+#if defined(__AVR__)
+#include <avr/interrupt.h>
+
+// Buttons sit on ports B and D; port C shares the handler in case a pin moves
+ISR(PCINT0_vect) {
+  input.onPinChange();
+}
+ISR(PCINT1_vect, ISR_ALIASOF(PCINT0_vect));
+ISR(PCINT2_vect, ISR_ALIASOF(PCINT0_vect));
+#endif
+
+// Keeps queue stores ahead of the index that publishes them
+#define QUEUE_BARRIER() asm volatile("" ::: "memory")
 
 MinuxInput::MinuxInput() {
-  debounce_delay = 50;
+  debounce_delay = INPUT_DEBOUNCE_MS;
   buzzer_enabled = true;
+  combo_latched = false;
+  queue_head = 0;
+  queue_tail = 0;
+  dropped = 0;
   for(int i = 0; i < 4; i++) {
     btn_states[i] = BTN_RELEASED;
     last_press[i] = 0;
+    pin_regs[i] = nullptr;
+    pin_masks[i] = 0;
   }
 }
 
 void MinuxInput::init(uint8_t a, uint8_t up, uint8_t down, uint8_t right, uint8_t buzzer) {
-  pin_a = a;
-  pin_up = up;
-  pin_down = down;
-  pin_right = right;
+  pins[0] = a;
+  pins[1] = up;
+  pins[2] = down;
+  pins[3] = right;
   pin_buzzer = buzzer;
   
-  pinMode(pin_a, INPUT_PULLUP);
-  pinMode(pin_up, INPUT_PULLUP);
-  pinMode(pin_down, INPUT_PULLUP);
-  pinMode(pin_right, INPUT_PULLUP);
+  for(int i = 0; i < 4; i++) {
+    pinMode(pins[i], INPUT_PULLUP);
+#if defined(__AVR__)
+    pin_regs[i] = portInputRegister(digitalPinToPort(pins[i]));
+    pin_masks[i] = digitalPinToBitMask(pins[i]);
+#endif
+  }
   pinMode(pin_buzzer, OUTPUT);
-}
-
-InputEvent MinuxInput::poll() {
-  static unsigned long lastPoll = 0;
-  
-  if (millis() - lastPoll < 10) return EVENT_NONE;
-  lastPoll = millis();
   
-  // Check for button presses
-  if (!digitalRead(pin_a) && btn_states[0] == BTN_RELEASED) {
-    btn_states[0] = BTN_PRESSED;
-    last_press[0] = millis();
-    if (buzzer_enabled) playTone(440, 50);
-    return EVENT_BTN_A;
+  // Start from the current levels so a button held at boot is not reported
+  for(int i = 0; i < 4; i++) {
+    btn_states[i] = isDown(i) ? BTN_PRESSED : BTN_RELEASED;
   }
   
-  if (!digitalRead(pin_up) && btn_states[1] == BTN_RELEASED) {
-    btn_states[1] = BTN_PRESSED;
-    last_press[1] = millis();
-    if (buzzer_enabled) playTone(523, 50);
-    return EVENT_BTN_UP;
+#if defined(__AVR__)
+  // Pin-change interrupts stay on; they also wake the kernel from idle sleep
+  noInterrupts();
+  for(int i = 0; i < 4; i++) {
+    *digitalPinToPCMSK(pins[i]) |= _BV(digitalPinToPCMSKbit(pins[i]));
+    *digitalPinToPCICR(pins[i]) |= _BV(digitalPinToPCICRbit(pins[i]));
   }
+  interrupts();
+#endif
+}
+
+bool MinuxInput::isDown(uint8_t button) {
+#if defined(__AVR__)
+  return !(*pin_regs[button] & pin_masks[button]);
+#else
+  return !digitalRead(pins[button]);
+#endif
+}
+
+void MinuxInput::onPinChange() {
+  sample(millis());
+}
+
+// Producer side: runs in the ISR, or with interrupts off from read()
+void MinuxInput::push(InputEvent event, unsigned long now) {
+  uint8_t head = queue_head;
+  uint8_t next = (head + 1) & (INPUT_QUEUE_SIZE - 1);
+  if (next == queue_tail) {
+    dropped++;
+    return;
+  }
+  queue[head].event = event;
+  queue[head].timestamp = now;
+  QUEUE_BARRIER();
+  queue_head = next;
+  TRACE(INPUT, event);
+}
+
+// Compares every button with its recorded state. A change only counts once
+// the debounce window since that button's last accepted edge has passed, so
+// bounces are rejected by timestamp rather than by polling slowly.
+void MinuxInput::sample(unsigned long now) {
+  uint8_t held = 0;
   
-  if (!digitalRead(pin_down) && btn_states[2] == BTN_RELEASED) {
-    btn_states[2] = BTN_PRESSED;
-    last_press[2] = millis();
-    if (buzzer_enabled) playTone(392, 50);
-    return EVENT_BTN_DOWN;
+  for(uint8_t i = 0; i < 4; i++) {
+    bool down = isDown(i);
+    bool pressed = btn_states[i] != BTN_RELEASED;
+    
+    if (down != pressed && now - last_press[i] >= debounce_delay) {
+      last_press[i] = now;
+      pressed = down;
+      btn_states[i] = down ? BTN_PRESSED : BTN_RELEASED;
+      if (down) push((InputEvent)(EVENT_BTN_A + i), now);
+    }
+    if (pressed) held++;
   }
   
-  if (!digitalRead(pin_right) && btn_states[3] == BTN_RELEASED) {
-    btn_states[3] = BTN_PRESSED;
-    last_press[3] = millis();
-    if (buzzer_enabled) playTone(349, 50);
-    return EVENT_BTN_RIGHT;
+  // One combo event per chord, re-armed once every button is up
+  if (held > 1 && !combo_latched) {
+    combo_latched = true;
+    push(EVENT_BTN_COMBO, now);
+  } else if (held == 0) {
+    combo_latched = false;
   }
+}
+
+uint8_t MinuxInput::read(InputRecord* out, uint8_t max) {
+  // Edges that fell inside a debounce window have no later edge to report
+  // them, so settle the buttons here as well
+  noInterrupts();
+  sample(millis());
+  interrupts();
   
-  // Reset button states
-  for(int i = 0; i < 4; i++) {
-    uint8_t pins[] = {pin_a, pin_up, pin_down, pin_right};
-    if (digitalRead(pins[i]) && btn_states[i] == BTN_PRESSED) {
-      if (millis() - last_press[i] > debounce_delay) {
-        btn_states[i] = BTN_RELEASED;
-      }
-    }
+  uint8_t n = 0;
+  uint8_t tail = queue_tail;
+  while (n < max && tail != queue_head) {
+    out[n++] = queue[tail];
+    tail = (tail + 1) & (INPUT_QUEUE_SIZE - 1);
   }
+  QUEUE_BARRIER();
+  queue_tail = tail;
+  return n;
+}
+
+InputEvent MinuxInput::poll() {
+  static const uint16_t pressTones[4] = { 440, 523, 392, 349 };
+  
+  InputRecord record;
+  if (!read(&record, 1)) return EVENT_NONE;
   
-  return EVENT_NONE;
+  if (record.event <= EVENT_BTN_RIGHT && buzzer_enabled) {
+    playTone(pressTones[record.event - EVENT_BTN_A], 50);
+  }
+  return record.event;
 }
 
+// Queued on the sequencer, so a key click never holds up the caller
 void MinuxInput::playTone(uint16_t freq, uint16_t duration) {
   if (buzzer_enabled) {
-    tone(pin_buzzer, freq, duration);
+    sound.beep(freq, duration);
   }
 }
 
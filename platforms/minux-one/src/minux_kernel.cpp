@@ -1,6 +1,89 @@
 #include "minux_kernel.h"
 #include "minux_input.h"
 #include "minux_scheduler.h"
+#include "minux_timer.h"
+#include "minux_sound.h"
+
+#if defined(__AVR__)
+// Linker and avr-libc malloc symbols
+extern uint8_t _end;
+extern uint8_t __stack;
+extern uint8_t __heap_start;
+extern uint8_t* __brkval;
+
+static inline uint8_t* heapEnd() {
+  return __brkval ? __brkval : &__heap_start;
+}
+
+// avr-libc's malloc free list, each chunk's size excludes its 2-byte header
+struct __freelist {
+  size_t sz;
+  struct __freelist* nx;
+};
+extern struct __freelist* __flp;
+#endif
+
+#if ENABLE_POOL
+// Backing store for every pool, carved up by initPools()
+static uint8_t poolArena[POOL_ARENA_SIZE];
+
+// Threads may allocate too, so free list updates run with interrupts off
+static inline uint8_t poolLock() {
+#if defined(__AVR__)
+  uint8_t sreg = SREG;
+  cli();
+  return sreg;
+#else
+  return 0;
+#endif
+}
+
+static inline void poolUnlock(uint8_t sreg) {
+#if defined(__AVR__)
+  SREG = sreg;
+#else
+  (void)sreg;
+#endif
+}
+#endif
+
+#if defined(__AVR__)
+// Paints everything above .bss before the C runtime sets up, so the scanner
+// can tell which bytes the stack has ever reached
+void minux_paintStack() __attribute__((naked, used, section(".init1")));
+void minux_paintStack() {
+  asm volatile(
+    "    ldi r30, lo8(_end)     \n"
+    "    ldi r31, hi8(_end)     \n"
+    "    ldi r24, %0            \n"
+    "    ldi r25, hi8(__stack)  \n"
+    "    rjmp 2f                \n"
+    "1:  st Z+, r24             \n"
+    "2:  cpi r30, lo8(__stack)  \n"
+    "    cpc r31, r25           \n"
+    "    brlo 1b                \n"
+    "    breq 1b                \n"
+    :: "M" (STACK_PAINT));
+}
+#endif
+
+#if ENABLE_TICKLESS && defined(__AVR__)
+#include <avr/sleep.h>
+#include <avr/interrupt.h>
+
+// Maintained by the Arduino core's Timer0 overflow ISR; micros() is built
+// from the overflow count
+extern volatile unsigned long timer0_millis;
+extern volatile unsigned long timer0_overflow_count;
+
+// The alarm only needs to end sleep_cpu(); button pin changes are handled
+// (and wake us) in MinuxInput
+EMPTY_INTERRUPT(TIMER1_COMPB_vect);
+#endif
+
+// Timer0 overflows every 64 * 256 cycles, Timer1 at clk/1024 ticks every
+// 1024, so one overflow is 16 Timer1 ticks whatever F_CPU is
+#define TIMER1_TICKS_PER_OVERFLOW (64 * 256 / 1024)
 
 // External references
 extern MinuxInput input;
@@ -10,6 +93,17 @@ MinuxKernel::MinuxKernel() {
   currentState = SYS_BOOT;
   bootTime = 0;
   uptime = 0;
+  sleepTime = 0;
+  wakeCount = 0;
+  sleepResidue = 0;
+  overflowResidue = 0;
+  scanPtr = nullptr;
+  heapTop = nullptr;
+  taskSpMin = nullptr;
+  stackFreeMin = 0xFFFF;
+#if ENABLE_POOL
+  initPools();
+#endif
 }
 
 void MinuxKernel::init() {
@@ -23,12 +117,23 @@ void MinuxKernel::panic(const char* message) {
   // Display panic message and halt
   Serial.print("KERNEL PANIC: ");
   Serial.println(message);
+  sound.silence();
+  sound.play(MELODY_ERROR);
   while(1) {
-    // Blink LED or make sound to indicate panic
+    // The error pattern keeps playing from its timer interrupt
     delay(500);
   }
 }
 
+void MinuxKernel::reboot() {
+#if defined(__AVR__)
+  // Software reset for Arduino
+  asm volatile ("  jmp 0");
+#else
+  exit(0);
+#endif
+}
+
 unsigned long MinuxKernel::getUptime() {
   return millis() - bootTime;
 }
@@ -39,11 +144,249 @@ MemInfo MinuxKernel::getMemoryInfo() {
 }
 
 void MinuxKernel::updateMemoryInfo() {
-  // Simplified memory calculation for Arduino
-  extern int __heap_start, *__brkval;
-  int v;
+  // Free memory is the heap-to-stack gap plus every chunk on malloc's free
+  // list; only the largest of those can serve a single request
   memory.total = 2048; // Arduino Nano has 2KB SRAM
-  memory.used = (int) &v - (__brkval == 0 ? (int) &__heap_start : (int) __brkval);
-  memory.free = memory.total - memory.used;
-  memory.fragmentation = (memory.used * 100) / memory.total;
+#if defined(__AVR__)
+  uint8_t v;
+  uint16_t gap = &v - heapEnd();
+  uint16_t freeBytes = gap;
+  uint16_t largest = gap;
+  for (struct __freelist* fp = __flp; fp; fp = fp->nx) {
+    freeBytes += fp->sz;
+    if (fp->sz > largest) largest = fp->sz;
+  }
+#else
+  // No heap or stack to measure off-target; report a fixed, idle figure
+  uint16_t freeBytes = memory.total;
+  uint16_t largest = memory.total;
+#endif
+  
+  memory.free = freeBytes;
+  memory.used = memory.total - memory.free;
+  memory.largestFree = largest;
+  memory.fragmentation = freeBytes ? (uint32_t)(freeBytes - largest) * 100 / freeBytes : 0;
+  
+#if ENABLE_POOL
+  uint8_t sreg = poolLock();
+  memcpy(memory.pools, poolStats, sizeof(poolStats));
+  poolUnlock(sreg);
+#endif
+  
+  // Worst case from the painted region rather than this instant
+  memory.stackFreeMin = stackFreeMin < memory.free ? stackFreeMin : memory.free;
+#if defined(__AVR__)
+  uint8_t* top = heapTop ? heapTop : heapEnd();
+  memory.stackPeak = &__stack - (top + memory.stackFreeMin) + 1;
+  uint16_t taskPeak = taskSpMin ? &__stack - taskSpMin : 0;
+  memory.isrPeak = memory.stackPeak > taskPeak ? memory.stackPeak - taskPeak : 0;
+#else
+  memory.stackPeak = 0;
+  memory.isrPeak = 0;
+#endif
+}
+
+#if ENABLE_POOL
+void MinuxKernel::initPools() {
+  const uint8_t sizes[POOL_CLASSES] = { POOL_SMALL_SIZE, POOL_MEDIUM_SIZE, POOL_LARGE_SIZE };
+  const uint8_t counts[POOL_CLASSES] = { POOL_SMALL_COUNT, POOL_MEDIUM_COUNT, POOL_LARGE_COUNT };
+  
+  uint8_t* base = poolArena;
+  for (uint8_t c = 0; c < POOL_CLASSES; c++) {
+    memset(&poolStats[c], 0, sizeof(PoolInfo));
+    poolStats[c].blockSize = sizes[c];
+    poolStats[c].blocks = counts[c];
+    poolBase[c] = base;
+    
+    // Thread the blocks into a free list in address order
+    poolFreeList[c] = nullptr;
+    for (uint8_t i = counts[c]; i > 0; i--) {
+      FreeBlock* block = (FreeBlock*)(base + (uint16_t)(i - 1) * sizes[c]);
+      block->next = poolFreeList[c];
+      poolFreeList[c] = block;
+    }
+    base += (uint16_t)sizes[c] * counts[c];
+  }
+}
+
+// Takes a block from the smallest class that fits, spilling into larger
+// classes when it runs dry; returns nullptr when none can serve the request
+void* MinuxKernel::poolAlloc(uint16_t size) {
+  if (size == 0) return nullptr;
+  
+  uint8_t first = 0;
+  while (first < POOL_CLASSES && poolStats[first].blockSize < size) first++;
+  
+  uint8_t sreg = poolLock();
+  for (uint8_t c = first; c < POOL_CLASSES; c++) {
+    FreeBlock* block = poolFreeList[c];
+    if (!block) continue;
+    
+    poolFreeList[c] = block->next;
+    PoolInfo& pool = poolStats[c];
+    pool.allocs++;
+    if (++pool.used > pool.peak) pool.peak = pool.used;
+    poolUnlock(sreg);
+    return block;
+  }
+  
+  // Oversized requests are charged to the largest class
+  poolStats[first < POOL_CLASSES ? first : POOL_CLASSES - 1].failures++;
+  poolUnlock(sreg);
+  return nullptr;
+}
+
+void MinuxKernel::poolFree(void* ptr) {
+  if (!ptr) return;
+  
+  // Block classes are contiguous in the arena, so a range check finds the owner
+  uint8_t* p = (uint8_t*)ptr;
+  for (uint8_t c = 0; c < POOL_CLASSES; c++) {
+    PoolInfo& pool = poolStats[c];
+    size_t offset = p - poolBase[c];
+    if (p < poolBase[c] || offset >= (uint16_t)pool.blockSize * pool.blocks) continue;
+    if (offset & (pool.blockSize - 1)) panic("Bad pool free");
+    
+    uint8_t sreg = poolLock();
+    FreeBlock* block = (FreeBlock*)p;
+    block->next = poolFreeList[c];
+    poolFreeList[c] = block;
+    pool.used--;
+    poolUnlock(sreg);
+    return;
+  }
+  panic("Bad pool free");
+}
+#endif
+
+// Records how deep task code has taken the stack; call from task context
+void MinuxKernel::sampleStack() {
+#if defined(__AVR__)
+  // Threads run on their own stacks in .bss, only the main stack counts here
+  uint8_t* sp = (uint8_t*)SP;
+  if (sp < &_end) return;
+  if (!taskSpMin || sp < taskSpMin) taskSpMin = sp;
+#endif
+}
+
+// Incremental watermark scan plus overflow guard, run from the idle path
+void MinuxKernel::checkStack() {
+#if defined(__AVR__)
+  uint8_t* sp = (uint8_t*)SP;
+  if (sp < &_end) return;
+  sampleStack();
+  
+  // Bytes the heap has ever owned are no longer paint, start above them
+  uint8_t* heap = heapEnd();
+  if (heap > heapTop) heapTop = heap;
+  if (scanPtr < heapTop) scanPtr = heapTop;
+  
+  // The guard band sits between heap and stack; touching it means the next
+  // push could land in heap data
+  for (uint8_t i = 0; i < STACK_GUARD_BYTES; i++) {
+    if (heapTop[i] != STACK_PAINT) panic("Stack overflow");
+  }
+  
+  // Walk up from the heap; the first non-paint byte is the deepest the
+  // stack (or an ISR on top of it) has ever reached
+  for (uint8_t n = 0; n < STACK_SCAN_CHUNK; n++, scanPtr++) {
+    if (scanPtr >= sp || *scanPtr != STACK_PAINT) {
+      uint16_t gap = scanPtr - heapTop;
+      if (gap < stackFreeMin) stackFreeMin = gap;
+      scanPtr = heapTop;
+      break;
+    }
+  }
+#endif
+}
+
+// Converts a Timer1 count taken at clk/1024 into whole ms for millis() and
+// Timer0 overflows for micros(), carrying both remainders into the next
+// sleep so neither clock drifts. Plain arithmetic, so host tests can run it.
+unsigned long MinuxKernel::foldSleep(uint16_t elapsed, uint16_t* overflows) {
+  sleepResidue += (uint32_t)elapsed * 1000;
+  unsigned long slept = sleepResidue / (F_CPU / 1024);
+  sleepResidue -= slept * (F_CPU / 1024);
+  
+  uint32_t ticks = (uint32_t)elapsed + overflowResidue;
+  *overflows = ticks / TIMER1_TICKS_PER_OVERFLOW;
+  overflowResidue = ticks % TIMER1_TICKS_PER_OVERFLOW;
+  return slept;
+}
+
+// Sleeps until the next timer is due or an interrupt arrives. Queued input
+// keeps it awake, so a press that ended the last sleep is handled first.
+void MinuxKernel::idle() {
+  checkStack();
+  
+#if ENABLE_TICKLESS
+  unsigned long sleepMs = timers.nextExpiry();
+  if (sleepMs == 0) return;
+  if (sleepMs > MAX_SLEEP_MS) sleepMs = MAX_SLEEP_MS;
+  
+#if defined(__AVR__)
+  set_sleep_mode(SLEEP_MODE_IDLE);
+  
+  // Checked with interrupts off: an edge after this still ends sleep_cpu(),
+  // since sei takes effect only after the next instruction
+  noInterrupts();
+  if (input.pending()) {
+    interrupts();
+    return;
+  }
+  
+  // Preemption tick owns Timer1 and wakes us anyway; short sleeps ride Timer0
+  if ((TIMSK1 & _BV(OCIE1A)) || sleepMs < 2) {
+    sleep_enable();
+    sei();
+    sleep_cpu();
+    sleep_disable();
+    return;
+  }
+  
+  // Timer1 at clk/1024 measures the sleep while the millis tick is stopped
+  TCCR1A = 0;
+  TCCR1B = 0;
+  TCNT1 = 0;
+  OCR1B = (uint32_t)sleepMs * (F_CPU / 1024) / 1000;
+  TIFR1 = _BV(OCF1B);
+  TIMSK1 |= _BV(OCIE1B);
+  TCCR1B = _BV(CS12) | _BV(CS10);
+  TIMSK0 &= ~_BV(TOIE0);
+  
+  sleep_enable();
+  sei();
+  sleep_cpu();
+  sleep_disable();
+  
+  noInterrupts();
+  uint16_t elapsed = TCNT1;
+  TCCR1B = 0;
+  TIMSK1 &= ~_BV(OCIE1B);
+  
+  // Fold the slept time back into millis() and into the overflow count,
+  // or micros() would lag by the whole sleep
+  uint16_t overflows;
+  unsigned long slept = foldSleep(elapsed, &overflows);
+  timer0_millis += slept;
+  timer0_overflow_count += overflows;
+  
+  // Overflows during sleep are already counted above
+  TIFR0 = _BV(TOV0);
+  TIMSK0 |= _BV(TOIE0);
+  interrupts();
+#else
+  // Simulated sleep: the clock runs to the deadline, or to the runner's
+  // horizon, which stands in for an interrupt ending the sleep early
+  if (input.pending()) return;
+  unsigned long before = millis();
+  delay(sleepMs);
+  unsigned long slept = millis() - before;
+#endif
+  
+  sleepTime += slept;
+  wakeCount++;
+#else
+  delay(1);
+#endif
 }
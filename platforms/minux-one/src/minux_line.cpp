@@ -0,0 +1,80 @@
+#include "minux_line.h"
+
+MinuxLine::MinuxLine(Print* echoTo) {
+  echo = echoTo;
+  lastWasCR = false;
+  reset();
+}
+
+void MinuxLine::reset() {
+  length = 0;
+  complete = false;
+  buffer[0] = '\0';
+}
+
+bool MinuxLine::feed(char c) {
+  // A finished line is consumed by the first byte of the next one
+  if (complete) reset();
+  
+  // CR, LF and CR LF all end a line exactly once
+  bool wasCR = lastWasCR;
+  lastWasCR = (c == '\r');
+  if (c == '\r' || c == '\n') {
+    if (c == '\n' && wasCR) return false;
+    buffer[length] = '\0';
+    complete = true;
+    if (echo) echo->println();
+    return true;
+  }
+  
+  if (c == 8 || c == 127) {
+    // Backspace
+    if (length > 0) {
+      length--;
+      if (echo) echo->print("\b \b");
+    }
+  }
+  else if (c >= 32 && c <= 126 && length < MAX_CMD_LENGTH - 1) {
+    // Printable character, dropped once the buffer is full
+    buffer[length++] = c;
+    if (echo) echo->print(c);
+  }
+  return false;
+}
+
+bool MinuxLine::poll(Stream& in) {
+  while (in.available()) {
+    if (feed(in.read())) return true;
+  }
+  return false;
+}
+
+uint8_t MinuxLine::parse(char** argv, uint8_t maxArgs) {
+  return splitLine(buffer, argv, maxArgs);
+}
+
+uint8_t splitLine(char* line, char** argv, uint8_t maxArgs) {
+  uint8_t argc = 0;
+  char* p = line;
+  
+  while (argc < maxArgs) {
+    while (*p == ' ') p++;
+    if (!*p) break;
+    
+    argv[argc++] = p;
+    if (argc == maxArgs) break;
+    while (*p && *p != ' ') p++;
+    if (*p) *p++ = '\0';
+  }
+  
+  // Trim trailing blanks off the remainder
+  if (argc == maxArgs) {
+    char* end = argv[argc - 1] + strlen(argv[argc - 1]);
+    while (end > argv[argc - 1] && end[-1] == ' ') *--end = '\0';
+  }
+  
+  if (argc > 0) {
+    for (char* c = argv[0]; *c; c++) *c = tolower(*c);
+  }
+  return argc;
+}
@@ -1,21 +1,301 @@
 #include "minux_scheduler.h"
+#include "minux_bench.h"
+#include "minux_trace.h"
+
+#if MINUX_PREEMPTIVE
+#include <avr/interrupt.h>
+
+// Statically sized stacks for preemptive tasks
+static uint8_t threadStacks[MAX_THREADS][THREAD_STACK_SIZE];
+
+extern "C" {
+  // Points at the saved-SP slot of the running context
+  uint8_t** volatile minux_ctxSlot __attribute__((used));
+  void minux_contextSwitch() __attribute__((naked, noinline));
+  void minux_selectContext();
+}
+
+// Register save/restore in the same layout as the initial thread frame
+#define SAVE_CONTEXT()                  \
+  asm volatile(                         \
+    "push r0                    \n\t"   \
+    "in   r0, __SREG__          \n\t"   \
+    "cli                        \n\t"   \
+    "push r0                    \n\t"   \
+    "push r1                    \n\t"   \
+    "clr  r1                    \n\t"   \
+    "push r2                    \n\t"   \
+    "push r3                    \n\t"   \
+    "push r4                    \n\t"   \
+    "push r5                    \n\t"   \
+    "push r6                    \n\t"   \
+    "push r7                    \n\t"   \
+    "push r8                    \n\t"   \
+    "push r9                    \n\t"   \
+    "push r10                   \n\t"   \
+    "push r11                   \n\t"   \
+    "push r12                   \n\t"   \
+    "push r13                   \n\t"   \
+    "push r14                   \n\t"   \
+    "push r15                   \n\t"   \
+    "push r16                   \n\t"   \
+    "push r17                   \n\t"   \
+    "push r18                   \n\t"   \
+    "push r19                   \n\t"   \
+    "push r20                   \n\t"   \
+    "push r21                   \n\t"   \
+    "push r22                   \n\t"   \
+    "push r23                   \n\t"   \
+    "push r24                   \n\t"   \
+    "push r25                   \n\t"   \
+    "push r26                   \n\t"   \
+    "push r27                   \n\t"   \
+    "push r28                   \n\t"   \
+    "push r29                   \n\t"   \
+    "push r30                   \n\t"   \
+    "push r31                   \n\t"   \
+    "lds  r26, minux_ctxSlot    \n\t"   \
+    "lds  r27, minux_ctxSlot+1  \n\t"   \
+    "in   r0, __SP_L__          \n\t"   \
+    "st   x+, r0                \n\t"   \
+    "in   r0, __SP_H__          \n\t"   \
+    "st   x+, r0                \n\t"   \
+  )
+  
+#define RESTORE_CONTEXT()               \
+  asm volatile(                         \
+    "lds  r26, minux_ctxSlot    \n\t"   \
+    "lds  r27, minux_ctxSlot+1  \n\t"   \
+    "ld   r28, x+               \n\t"   \
+    "out  __SP_L__, r28         \n\t"   \
+    "ld   r29, x+               \n\t"   \
+    "out  __SP_H__, r29         \n\t"   \
+    "pop  r31                   \n\t"   \
+    "pop  r30                   \n\t"   \
+    "pop  r29                   \n\t"   \
+    "pop  r28                   \n\t"   \
+    "pop  r27                   \n\t"   \
+    "pop  r26                   \n\t"   \
+    "pop  r25                   \n\t"   \
+    "pop  r24                   \n\t"   \
+    "pop  r23                   \n\t"   \
+    "pop  r22                   \n\t"   \
+    "pop  r21                   \n\t"   \
+    "pop  r20                   \n\t"   \
+    "pop  r19                   \n\t"   \
+    "pop  r18                   \n\t"   \
+    "pop  r17                   \n\t"   \
+    "pop  r16                   \n\t"   \
+    "pop  r15                   \n\t"   \
+    "pop  r14                   \n\t"   \
+    "pop  r13                   \n\t"   \
+    "pop  r12                   \n\t"   \
+    "pop  r11                   \n\t"   \
+    "pop  r10                   \n\t"   \
+    "pop  r9                    \n\t"   \
+    "pop  r8                    \n\t"   \
+    "pop  r7                    \n\t"   \
+    "pop  r6                    \n\t"   \
+    "pop  r5                    \n\t"   \
+    "pop  r4                    \n\t"   \
+    "pop  r3                    \n\t"   \
+    "pop  r2                    \n\t"   \
+    "pop  r1                    \n\t"   \
+    "pop  r0                    \n\t"   \
+    "out  __SREG__, r0          \n\t"   \
+    "pop  r0                    \n\t"   \
+  )
+  
+// Saves the running context, picks the next one and resumes it.
+// Called from the tick ISR and from voluntary yields.
+void minux_contextSwitch() {
+  SAVE_CONTEXT();
+  minux_selectContext();
+  RESTORE_CONTEXT();
+  asm volatile("ret");
+}
+
+void minux_selectContext() {
+  minux_ctxSlot = scheduler.selectContext();
+}
+
+// Preemption tick: the call leaves a return address that leads to reti
+ISR(TIMER1_COMPA_vect, ISR_NAKED) {
+  minux_contextSwitch();
+  reti();
+}
+
+// Arduino's delay() spins on yield(); let a waiting thread hand over the CPU
+void yield() {
+  if (scheduler.inThread()) {
+    minux_contextSwitch();
+  }
+}
+
+// Builds the frame RESTORE_CONTEXT expects, returning into the entry point
+static uint8_t* initStack(uint8_t* top, void (*entry)()) {
+  uint16_t addr = (uint16_t)entry;
+  *top-- = addr & 0xFF;
+  *top-- = addr >> 8;
+  *top-- = 0x00;      // r0
+  *top-- = 0x80;      // SREG with interrupts enabled
+  for (uint8_t r = 1; r < 32; r++) {
+    *top-- = 0x00;    // r1 must be zero for compiled code
+  }
+  return top;
+}
+
+static void startPreemptTimer() {
+  // Timer1 CTC at the scheduler tick (Timer0 keeps millis, Timer2 drives tone)
+  noInterrupts();
+  TCCR1A = 0;
+  TCCR1B = _BV(WGM12) | _BV(CS11) | _BV(CS10);
+  TCNT1 = 0;
+  OCR1A = (F_CPU / 64 / 1000) * SCHEDULER_TICK_MS - 1;
+  TIMSK1 |= _BV(OCIE1A);
+  interrupts();
+}
+#endif
+
+#if defined(__AVR__)
+// Highest set bit of a nibble, no CLZ instruction on AVR
+static const uint8_t nibbleMsb[16] PROGMEM = {
+  0, 0, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3
+};
+
+static inline uint8_t highestBit(uint8_t bits) {
+  if (bits & 0xF0) return 4 + pgm_read_byte(&nibbleMsb[bits >> 4]);
+  return pgm_read_byte(&nibbleMsb[bits]);
+}
+#else
+static inline uint8_t highestBit(uint8_t bits) {
+  return 31 - __builtin_clz(bits);
+}
+#endif
 
 MinuxScheduler::MinuxScheduler() {
   processCount = 0;
   currentProcess = 0;
   lastSchedule = 0;
-  scheduleInterval = 10; // 10ms time slice
+  scheduleInterval = SCHEDULER_TICK_MS;
+  threadCount = 0;
+  runningThread = -1;
+  mainStackPointer = nullptr;
+  readyBitmap = 0;
+  statsSince = 0;
+  for(int p = 0; p < NUM_PRIORITIES; p++) {
+    readyHead[p] = NO_PROCESS;
+    readyTail[p] = NO_PROCESS;
+  }
 }
 
 void MinuxScheduler::init() {
   for(int i = 0; i < MAX_PROCESSES; i++) {
     processes[i].active = false;
     processes[i].state = PROC_TERMINATED;
+    processes[i].preemptive = false;
+    processes[i].next = NO_PROCESS;
+    processes[i].prev = NO_PROCESS;
   }
+#if MINUX_PREEMPTIVE
+  minux_ctxSlot = &mainStackPointer;
+#endif
 }
 
-bool MinuxScheduler::startProcess(const char* name, void (*func)(), unsigned long interval, uint8_t priority) {
-  if (processCount >= MAX_PROCESSES) return false;
+// Intrusive doubly linked lists threaded through the PCB table
+void MinuxScheduler::listAppend(uint8_t& head, uint8_t& tail, uint8_t index) {
+  ProcessControlBlock* pcb = &processes[index];
+  pcb->next = NO_PROCESS;
+  pcb->prev = tail;
+  if (tail == NO_PROCESS) {
+    head = index;
+  } else {
+    processes[tail].next = index;
+  }
+  tail = index;
+}
+
+void MinuxScheduler::listRemove(uint8_t& head, uint8_t& tail, uint8_t index) {
+  ProcessControlBlock* pcb = &processes[index];
+  if (pcb->prev == NO_PROCESS) {
+    head = pcb->next;
+  } else {
+    processes[pcb->prev].next = pcb->next;
+  }
+  if (pcb->next == NO_PROCESS) {
+    tail = pcb->prev;
+  } else {
+    processes[pcb->next].prev = pcb->prev;
+  }
+  pcb->next = NO_PROCESS;
+  pcb->prev = NO_PROCESS;
+}
+
+void MinuxScheduler::makeReady(uint8_t index) {
+  uint8_t prio = processes[index].priority;
+  listAppend(readyHead[prio], readyTail[prio], index);
+  readyBitmap |= (1 << prio);
+  processes[index].state = PROC_READY;
+}
+
+// Arms the entry's periodic wake timer once; dispatch never touches it, so
+// a run costs no timer work beyond the wheel re-filing it on expiry
+void MinuxScheduler::armWake(uint8_t index, unsigned long firstMs) {
+  ProcessControlBlock* pcb = &processes[index];
+  if (firstMs == 0) {
+    pcb->dueAt = millis();
+    makeReady(index);
+    firstMs = pcb->interval;
+  } else {
+    pcb->state = PROC_SLEEPING;
+  }
+  timers.armPeriodic(&pcb->wakeTimer, pcb->interval, wakeProcess, (void*)(uintptr_t)index, firstMs);
+}
+
+// The timer carries the index, not the PCB: pointer subtraction would cost a
+// division by sizeof(ProcessControlBlock) on every release. A release that
+// finds the entry still queued merges with the pending one.
+void MinuxScheduler::wakeProcess(void* arg) {
+  uint8_t index = (uintptr_t)arg;
+  ProcessControlBlock* pcb = &scheduler.processes[index];
+  if (pcb->state == PROC_SLEEPING) {
+    pcb->dueAt = timers.getTickTime();
+    scheduler.makeReady(index);
+  }
+}
+
+// Takes a cooperative entry off whichever queue its state puts it on
+void MinuxScheduler::unlink(uint8_t index) {
+  ProcessControlBlock* pcb = &processes[index];
+  if (pcb->preemptive) return;
+  
+  timers.cancel(&pcb->wakeTimer);
+  if (pcb->state == PROC_READY) {
+    uint8_t prio = pcb->priority;
+    listRemove(readyHead[prio], readyTail[prio], index);
+    if (readyHead[prio] == NO_PROCESS) readyBitmap &= ~(1 << prio);
+  }
+}
+
+uint8_t MinuxScheduler::popHighestReady() {
+  if (!readyBitmap) return NO_PROCESS;
+  
+  // Always the head, so skip listRemove's general case
+  uint8_t prio = highestBit(readyBitmap);
+  uint8_t index = readyHead[prio];
+  uint8_t next = processes[index].next;
+  readyHead[prio] = next;
+  if (next == NO_PROCESS) {
+    readyTail[prio] = NO_PROCESS;
+    readyBitmap &= ~(1 << prio);
+  } else {
+    processes[next].prev = NO_PROCESS;
+  }
+  return index;
+}
+
+int8_t MinuxScheduler::addProcess(const char* name, void (*func)(), unsigned long interval, uint8_t priority) {
+  if (processCount >= MAX_PROCESSES) return -1;
   
   ProcessControlBlock* pcb = &processes[processCount];
   strncpy(pcb->name, name, 7);
@@ -24,44 +304,217 @@ bool MinuxScheduler::startProcess(const char* name, void (*func)(), unsigned lon
   pcb->interval = interval;
   pcb->lastRun = 0;
   pcb->active = true;
-  pcb->priority = priority;
-  pcb->state = PROC_READY;
+  pcb->priority = priority < NUM_PRIORITIES ? priority : NUM_PRIORITIES - 1;
+  pcb->state = PROC_SLEEPING;
+  pcb->preemptive = false;
+  pcb->stackPointer = nullptr;
+  pcb->stackBase = nullptr;
+  pcb->next = NO_PROCESS;
+  pcb->prev = NO_PROCESS;
+  pcb->dueAt = 0;
+  pcb->runTime = 0;
+  pcb->worstTime = 0;
+  pcb->runCount = 0;
+  memset(pcb->jitter, 0, sizeof(pcb->jitter));
   
-  processCount++;
+  return processCount++;
+}
+
+bool MinuxScheduler::startProcess(const char* name, void (*func)(), unsigned long interval, uint8_t priority) {
+  int8_t index = addProcess(name, func, interval, priority);
+  if (index < 0) return false;
+  
+  // First run on the next tick
+  armWake(index, 0);
   return true;
 }
 
+bool MinuxScheduler::startThread(const char* name, void (*func)(), unsigned long interval, uint8_t priority) {
+#if MINUX_PREEMPTIVE
+  if (threadCount >= MAX_THREADS) return false;
+  int8_t index = addProcess(name, func, interval, priority);
+  if (index < 0) return false;
+  
+  ProcessControlBlock* pcb = &processes[index];
+  pcb->stackBase = threadStacks[threadCount];
+  memset(pcb->stackBase, STACK_PAINT, THREAD_STACK_SIZE);
+  pcb->stackPointer = initStack(pcb->stackBase + THREAD_STACK_SIZE - 1, threadEntry);
+  
+  // Only becomes visible to the tick ISR once the frame is complete
+  noInterrupts();
+  pcb->preemptive = true;
+  threadCount++;
+  interrupts();
+  
+  if (threadCount == 1) startPreemptTimer();
+  return true;
+#else
+  // No context switch on this target, run it as a cooperative entry
+  return startProcess(name, func, interval, priority);
+#endif
+}
+
+void MinuxScheduler::threadEntry() {
+  ProcessControlBlock* pcb = &scheduler.processes[scheduler.runningThread];
+  
+  for (;;) {
+    // The tick ISR reads both fields, keep the transition atomic
+    noInterrupts();
+    pcb->lastRun = millis();
+    pcb->state = PROC_RUNNING;
+    interrupts();
+    
+    // Wall time for threads: includes slices spent switched out. No bench
+    // markers here, a switch mid-run would interleave them with the main loop's
+    uint32_t started = micros();
+    TRACE(TASK_BEGIN, scheduler.runningThread);
+    pcb->function();
+    TRACE(TASK_END, scheduler.runningThread);
+    scheduler.account(pcb, pcb->lastRun, micros() - started);
+    pcb->dueAt = pcb->lastRun + pcb->interval;
+    pcb->state = PROC_SLEEPING;
+    
+    // Nothing left to do until the next interval
+    scheduler.yield();
+  }
+}
+
+bool MinuxScheduler::isRunnable(ProcessControlBlock* pcb, unsigned long now) {
+  if (!pcb->active || !pcb->preemptive) return false;
+  if (pcb->state == PROC_RUNNING) return true;
+  return pcb->state == PROC_SLEEPING && now - pcb->lastRun >= pcb->interval;
+}
+
+uint8_t** MinuxScheduler::selectContext() {
+  unsigned long now = millis();
+  
+  // Round-robin over runnable threads; the main loop gets the slot after the last one
+  int8_t next = runningThread;
+  for (;;) {
+    next++;
+    if (next >= processCount) {
+      next = -1;
+      break;
+    }
+    if (isRunnable(&processes[next], now)) break;
+  }
+  
+  runningThread = next;
+  return next < 0 ? &mainStackPointer : &processes[next].stackPointer;
+}
+
 void MinuxScheduler::stopProcess(const char* name) {
   for(int i = 0; i < processCount; i++) {
     if (strcmp(processes[i].name, name) == 0) {
+      unlink(i);
       processes[i].active = false;
       processes[i].state = PROC_TERMINATED;
+#if MINUX_PREEMPTIVE
+      // A thread stopping itself never gets switched back in
+      if (runningThread == i) minux_contextSwitch();
+#endif
       break;
     }
   }
 }
 
 void MinuxScheduler::tick() {
-  unsigned long now = millis();
+  BENCH_SCOPE(SCHED_TICK);
+  unsigned long start = millis();
   
-  // Round-robin scheduling with time-based intervals
-  for(int i = 0; i < processCount; i++) {
-    ProcessControlBlock* pcb = &processes[i];
+  uint8_t index;
+  
+  if (threadCount) checkStacks();
+  
+  // Expired wake timers move their entries onto the ready queue
+  timers.update();
     
-    if (pcb->active && pcb->state == PROC_READY) {
-      if (now - pcb->lastRun >= pcb->interval) {
-        pcb->state = PROC_RUNNING;
-        pcb->function();
-        pcb->lastRun = now;
-        pcb->state = PROC_READY;
-      }
+  // One micros() read per dispatch: each run is timed from the end of the
+  // previous one, so the queue work in between is charged to the entry
+  uint32_t mark = micros();
+  
+  // Strict priority, FIFO within a level; stop once the time slice is used up
+  while ((index = popHighestReady()) != NO_PROCESS) {
+    ProcessControlBlock* pcb = &processes[index];
+    unsigned long now = millis();
+    
+    currentProcess = index;
+    pcb->state = PROC_RUNNING;
+    BENCH_BEGIN(SCHED_TASK);
+    TRACE(TASK_BEGIN, index);
+    pcb->function();
+    TRACE(TASK_END, index);
+    BENCH_END(SCHED_TASK);
+    uint32_t done = micros();
+    account(pcb, now, done - mark);
+    mark = done;
+    pcb->lastRun = now;
+    
+    // The wake timer is still armed; the entry may have suspended or stopped itself
+    if (pcb->state == PROC_RUNNING) pcb->state = PROC_SLEEPING;
+    
+    if (millis() - start >= scheduleInterval) break;
+  }
+  lastSchedule = start;
+}
+
+// Adds, compares and one table lookup, no loops, so dispatch cost stays flat
+void MinuxScheduler::account(ProcessControlBlock* pcb, unsigned long started, uint32_t runTicks) {
+  pcb->runTime += runTicks;
+  if (pcb->runCount != 0xFFFF) pcb->runCount++;
+  if (runTicks > pcb->worstTime) pcb->worstTime = runTicks;
+  
+  // log2 bucket from the ready bitmap's MSB lookup; 255 ms is past the last one
+  long late = started - pcb->dueAt;
+  uint8_t bucket = 0;
+  if (late > 0) {
+    bucket = highestBit(late > 0xFF ? 0xFF : late) + 1;
+    if (bucket > JITTER_BUCKETS - 1) bucket = JITTER_BUCKETS - 1;
+  }
+  if (pcb->jitter[bucket] != 0xFFFF) pcb->jitter[bucket]++;
+}
+
+void MinuxScheduler::resetStats() {
+  for (int i = 0; i < processCount; i++) {
+    ProcessControlBlock* pcb = &processes[i];
+    pcb->runTime = 0;
+    pcb->worstTime = 0;
+    pcb->runCount = 0;
+    memset(pcb->jitter, 0, sizeof(pcb->jitter));
+  }
+  statsSince = millis();
+}
+
+// Untouched paint at the bottom of a thread stack, 0 for cooperative entries
+uint16_t MinuxScheduler::getStackFree(uint8_t index) {
+  if (index >= processCount || !processes[index].preemptive) return 0;
+  
+  uint8_t* base = processes[index].stackBase;
+  uint16_t n = 0;
+  while (n < THREAD_STACK_SIZE && base[n] == STACK_PAINT) n++;
+  return n;
+}
+
+// Guard band check on each thread stack, panics before the next frame
+// would spill into the neighbouring stack
+void MinuxScheduler::checkStacks() {
+  for (uint8_t i = 0; i < processCount; i++) {
+    if (!processes[i].preemptive || !processes[i].active) continue;
+    for (uint8_t g = 0; g < STACK_GUARD_BYTES; g++) {
+      if (processes[i].stackBase[g] != STACK_PAINT) kernel.panic("Thread stack overflow");
     }
   }
 }
 
 void MinuxScheduler::yield() {
-  // Simple yield - just delay a bit
-  delay(1);
+#if MINUX_PREEMPTIVE
+  if (threadCount > 0) {
+    minux_contextSwitch();
+    return;
+  }
+#endif
+  // Nothing runnable, sleep until the next wake timer
+  kernel.idle();
 }
 
 ProcessControlBlock* MinuxScheduler::getProcess(uint8_t index) {
@@ -74,6 +527,8 @@ ProcessControlBlock* MinuxScheduler::getProcess(uint8_t index) {
 void MinuxScheduler::suspendProcess(const char* name) {
   for(int i = 0; i < processCount; i++) {
     if (strcmp(processes[i].name, name) == 0) {
+      if (processes[i].state == PROC_TERMINATED) break;
+      unlink(i);
       processes[i].state = PROC_BLOCKED;
       break;
     }
@@ -83,7 +538,13 @@ void MinuxScheduler::suspendProcess(const char* name) {
 void MinuxScheduler::resumeProcess(const char* name) {
   for(int i = 0; i < processCount; i++) {
     if (strcmp(processes[i].name, name) == 0) {
-      processes[i].state = PROC_READY;
+      if (processes[i].state != PROC_BLOCKED) break;
+      if (processes[i].preemptive) {
+        processes[i].state = PROC_SLEEPING;
+      } else {
+        unsigned long elapsed = millis() - processes[i].lastRun;
+        armWake(i, elapsed < processes[i].interval ? processes[i].interval - elapsed : 0);
+      }
       break;
     }
   }
@@ -3,6 +3,10 @@
 #include "minux_display.h"
 #include "minux_fs.h"
 #include "minux_scheduler.h"
+#include "minux_command.h"
+#include "minux_syscmd.h"
+#include "minux_line.h"
+#include "minux_bench.h"
 
 // External references
 extern MinuxKernel kernel;
@@ -10,6 +14,103 @@ extern MinuxDisplay ui;
 extern MinuxFS filesystem;
 extern MinuxScheduler scheduler;
 
+// Built-in commands; the table must stay sorted by name
+static void shellCat(uint8_t argc, char** argv) {
+  if (argc > 1) shell.cmd_cat(argv[1]);
+  else ui.println("Usage: cat <filename>");
+}
+
+static void shellCd(uint8_t argc, char** argv) {
+  shell.cmd_cd(argc > 1 ? argv[1] : "/");
+}
+
+static void shellClear(uint8_t, char**) { shell.cmd_clear(); }
+
+static void shellEcho(uint8_t argc, char** argv) {
+  if (argc > 1) shell.cmd_echo(argv[1]);
+}
+
+static void shellLs(uint8_t argc, char** argv) { shell.cmd_ls(argc > 1 ? argv[1] : "."); }
+
+static void shellMkdir(uint8_t argc, char** argv) {
+  if (argc > 1) shell.cmd_mkdir(argv[1]);
+  else ui.println("Usage: mkdir <dir>");
+}
+
+static void shellPs(uint8_t, char**) { shell.cmd_ps(); }
+static void shellPwd(uint8_t, char**) { shell.cmd_pwd(); }
+
+static void shellRmdir(uint8_t argc, char** argv) {
+  if (argc > 1) shell.cmd_rmdir(argv[1]);
+  else ui.println("Usage: rmdir <dir>");
+}
+
+static void shellSched(uint8_t argc, char** argv) { shell.cmd_sched(ui, argc > 1 ? argv[1] : "", false); }
+static void shellTop(uint8_t, char**) { shell.cmd_top(ui, false); }
+static void shellUptime(uint8_t, char**) { shell.cmd_uptime(); }
+static void shellVersion(uint8_t, char**) { shell.cmd_version(); }
+
+static constexpr Command shellCommands[] PROGMEM = {
+  { "cat",     "Display file",      shellCat },
+  { "cd",      "Change directory",  shellCd },
+  { "clear",   "Clear screen",      shellClear },
+  { "echo",    "Print text",        shellEcho },
+  COMMAND_HELP,
+  { "ls",      "List files",        shellLs },
+  COMMAND_MEM,
+  { "mkdir",   "Make directory",    shellMkdir },
+  { "ps",      "List processes",    shellPs },
+  { "pwd",     "Show directory",    shellPwd },
+  COMMAND_REBOOT,
+  { "rmdir",   "Remove directory",  shellRmdir },
+  { "sched",   "stats | reset",     shellSched },
+  { "top",     "CPU use per task",  shellTop },
+  { "uptime",  "Show uptime",       shellUptime },
+  { "version", "Show version",      shellVersion },
+};
+COMMAND_TABLE_CHECK(shellCommands);
+
+// Serial console outside the terminal, full-width tables; the table must
+// stay sorted by name
+static void serialSched(uint8_t argc, char** argv) { shell.cmd_sched(Serial, argc > 1 ? argv[1] : "", true); }
+static void serialTop(uint8_t, char**) { shell.cmd_top(Serial, true); }
+
+static constexpr Command serialCommands[] PROGMEM = {
+  COMMAND_HELP,
+  COMMAND_I2C,
+  COMMAND_MEM,
+  COMMAND_REBOOT,
+  { "sched", "stats | reset",     serialSched },
+  { "top",   "CPU use per task",  serialTop },
+};
+COMMAND_TABLE_CHECK(serialCommands);
+
+// Right-aligns a number in width columns
+static void printRight(Print& out, unsigned long value, uint8_t width) {
+  uint8_t digits = 1;
+  for (unsigned long v = value; v >= 10; v /= 10) digits++;
+  for (; digits < width; digits++) out.print(' ');
+  out.print(value);
+}
+
+// Left-aligns text in width columns
+static void printLeft(Print& out, const char* text, uint8_t width) {
+  out.print(text);
+  for (uint8_t n = strlen(text); n < width; n++) out.print(' ');
+}
+
+// Jitter bucket b holds releases 2^(b-1) to 2^b - 1 ms late, 0 is on time
+// and the last one is open ended
+static void printBucket(Print& out, uint8_t b) {
+  out.print(b ? 1U << (b - 1) : 0U);
+  if (b == JITTER_BUCKETS - 1) {
+    out.print('+');
+  } else if (b > 1) {
+    out.print('-');
+    out.print((1U << b) - 1);
+  }
+}
+
 MinuxShell::MinuxShell() {
   bufferIndex = 0;
   shellActive = false;
@@ -42,77 +143,66 @@ void MinuxShell::processInput(char c) {
 }
 
 void MinuxShell::executeCommand(const char* cmd) {
+  BENCH_SCOPE(SHELL_COMMAND);
   if (strlen(cmd) == 0) return;
   
   // Parse command and arguments
   char cmdCopy[MAX_CMD_LENGTH];
   strcpy(cmdCopy, cmd);
   
-  char* token = strtok(cmdCopy, " ");
-  if (!token) return;
+  char* argv[MAX_ARGS];
+  uint8_t argc = splitLine(cmdCopy, argv, MAX_ARGS);
+  if (argc == 0) return;
   
-  // Built-in commands
-  if (strcmp(token, "help") == 0) {
-    cmd_help();
-  } else if (strcmp(token, "ls") == 0) {
-    cmd_ls();
-  } else if (strcmp(token, "ps") == 0) {
-    cmd_ps();
-  } else if (strcmp(token, "clear") == 0) {
-    cmd_clear();
-  } else if (strcmp(token, "uptime") == 0) {
-    cmd_uptime();
-  } else if (strcmp(token, "mem") == 0) {
-    cmd_mem();
-  } else if (strcmp(token, "reboot") == 0) {
-    cmd_reboot();
-  } else if (strcmp(token, "version") == 0) {
-    cmd_version();
-  } else if (strcmp(token, "cat") == 0) {
-    char* filename = strtok(nullptr, " ");
-    if (filename) cmd_cat(filename);
-    else ui.println("Usage: cat <filename>");
-  } else if (strcmp(token, "echo") == 0) {
-    char* text = strtok(nullptr, "");
-    if (text) cmd_echo(text);
-  } else {
+  if (!runCommand(shellCommands, COMMAND_COUNT(shellCommands), argc, argv, ui)) {
     ui.print("Command not found: ");
     ui.println(cmd);
     ui.println("Type 'help' for available commands");
   }
 }
 
+void MinuxShell::runSerial(uint8_t argc, char** argv) {
+  if (argc == 0) return;
+  
+  if (!runCommand(serialCommands, COMMAND_COUNT(serialCommands), argc, argv)) {
+    Serial.print("Unknown command: '");
+    Serial.print(argv[0]);
+    Serial.println("'");
+    Serial.println("Type 'help' for available commands");
+  }
+}
+
 void MinuxShell::printPrompt() {
-  ui.print("minux:/ $ ");
+  char path[FS_MAX_PATH];
+  ui.print("minux:");
+  ui.print(filesystem.getPath(filesystem.getCwd(), path, sizeof(path)) ? path : "?");
+  ui.print(" $ ");
 }
 
-void MinuxShell::cmd_help() {
-  ui.println("Available commands:");
-  ui.println("help    - Show this help");
-  ui.println("ls      - List files");
-  ui.println("ps      - List processes");
-  ui.println("clear   - Clear screen");
-  ui.println("uptime  - Show uptime");
-  ui.println("mem     - Show memory info");
-  ui.println("version - Show version");
-  ui.println("cat     - Display file");
-  ui.println("echo    - Print text");
-  ui.println("reboot  - Restart system");
+// UP/DOWN browse what has scrolled off the terminal
+void MinuxShell::scrollView(int8_t lines) {
+  ui.scrollView(lines);
 }
 
-void MinuxShell::cmd_ls() {
+// Walks the directory's own entries only
+void MinuxShell::cmd_ls(const char* path) {
+  uint8_t dir = filesystem.findDir(path);
+  if (dir == FS_NONE) {
+    ui.print("No such directory: ");
+    ui.println(path);
+    return;
+  }
+  
   ui.println("Name\t\tSize\tType");
   ui.println("------------------------");
   
-  for (int i = 0; i < filesystem.getFileCount(); i++) {
+  for (uint8_t i = filesystem.firstChild(dir); i != FS_NONE; i = filesystem.nextChild(i)) {
     FileEntry* file = filesystem.getFile(i);
-    if (file) {
-      ui.print(file->name);
-      ui.print("\t\t");
-      ui.print(file->size);
-      ui.print("\t");
-      ui.println(file->isDirectory ? "DIR" : "FILE");
-    }
+    ui.print(file->name);
+    ui.print("\t\t");
+    ui.print(file->size);
+    ui.print("\t");
+    ui.println(file->isDirectory ? "DIR" : "FILE");
   }
 }
 
@@ -130,6 +220,7 @@ void MinuxShell::cmd_ps() {
       switch(proc->state) {
         case PROC_READY: ui.println("READY"); break;
         case PROC_RUNNING: ui.println("RUNNING"); break;
+        case PROC_SLEEPING: ui.println("SLEEPING"); break;
         case PROC_BLOCKED: ui.println("BLOCKED"); break;
         case PROC_TERMINATED: ui.println("TERMINATED"); break;
       }
@@ -137,6 +228,77 @@ void MinuxShell::cmd_ps() {
   }
 }
 
+// CPU share, runs, mean and worst run time (us) since the last reset. The
+// terminal's 21 columns only fit name, share and worst run.
+void MinuxShell::cmd_top(Print& out, bool wide) {
+  unsigned long window = scheduler.getStatsWindow();
+  out.print("CPU over ");
+  out.print(window);
+  out.println(" ms");
+  out.println(wide ? "PID\tName\tCPU%\tRuns\tAvg\tMax" : "Name    CPU%  Max us");
+  for (int i = 0; i < scheduler.getProcessCount(); i++) {
+    ProcessControlBlock* pcb = scheduler.getProcess(i);
+    if (!pcb || !pcb->active) continue;
+    unsigned long share = window ? pcb->runTime / (window * 10) : 0UL;
+    if (!wide) {
+      printLeft(out, pcb->name, 8);
+      printRight(out, share, 3);
+      out.print('%');
+      printRight(out, pcb->worstTime, 8);
+      out.println();
+      continue;
+    }
+    out.print(i);
+    out.print("\t");
+    out.print(pcb->name);
+    out.print("\t");
+    out.print(share);
+    out.print("\t");
+    out.print(pcb->runCount);
+    out.print("\t");
+    out.print((unsigned long)(pcb->runCount ? pcb->runTime / pcb->runCount : 0));
+    out.print("\t");
+    out.println((unsigned long)pcb->worstTime);
+  }
+}
+
+// Release jitter, ms late in log2 buckets. The terminal gets the late count
+// and the worst bucket hit instead of all eight columns.
+void MinuxShell::cmd_sched(Print& out, const char* arg, bool wide) {
+  if (strcmp(arg, "stats") == 0) {
+    out.println(wide ? "Name\t0\t1\t2-3\t4-7\t8-15\t16-31\t32-63\t64+" : "Name     Late Worst");
+    for (int i = 0; i < scheduler.getProcessCount(); i++) {
+      ProcessControlBlock* pcb = scheduler.getProcess(i);
+      if (!pcb || !pcb->active) continue;
+      if (!wide) {
+        unsigned long late = 0;
+        uint8_t worst = 0;
+        for (uint8_t b = 1; b < JITTER_BUCKETS; b++) {
+          late += pcb->jitter[b];
+          if (pcb->jitter[b]) worst = b;
+        }
+        printLeft(out, pcb->name, 8);
+        printRight(out, late, 5);
+        out.print(' ');
+        printBucket(out, worst);
+        out.println();
+        continue;
+      }
+      out.print(pcb->name);
+      for (int b = 0; b < JITTER_BUCKETS; b++) {
+        out.print("\t");
+        out.print(pcb->jitter[b]);
+      }
+      out.println();
+    }
+  } else if (strcmp(arg, "reset") == 0) {
+    scheduler.resetStats();
+    out.println("Statistics reset");
+  } else {
+    out.println("Usage: sched stats|reset");
+  }
+}
+
 void MinuxShell::cmd_clear() {
   ui.clear();
   ui.setCursor(0, 0);
@@ -149,22 +311,6 @@ void MinuxShell::cmd_uptime() {
   ui.println(" seconds");
 }
 
-void MinuxShell::cmd_mem() {
-  MemInfo mem = kernel.getMemoryInfo();
-  ui.print("Total: ");
-  ui.print(mem.total);
-  ui.println(" bytes");
-  ui.print("Used: ");
-  ui.print(mem.used);
-  ui.println(" bytes");
-  ui.print("Free: ");
-  ui.print(mem.free);
-  ui.println(" bytes");
-  ui.print("Usage: ");
-  ui.print(mem.fragmentation);
-  ui.println("%");
-}
-
 void MinuxShell::cmd_version() {
   ui.print("Minux RTOS ");
   ui.println(kernel.getVersion());
@@ -177,8 +323,10 @@ void MinuxShell::cmd_version() {
 void MinuxShell::cmd_cat(const char* filename) {
   FileEntry* file = filesystem.openFile(filename);
   if (file) {
-    for (int i = 0; i < file->size; i++) {
-      ui.printChar((char)file->data[i]);
+    uint8_t chunk[FS_BLOCK_SIZE];
+    uint16_t n;
+    for (uint16_t offset = 0; (n = filesystem.read(file, offset, chunk, sizeof(chunk))) > 0; offset += n) {
+      for (uint16_t i = 0; i < n; i++) ui.printChar((char)chunk[i]);
     }
     ui.printChar('\n');
   } else {
@@ -191,9 +339,30 @@ void MinuxShell::cmd_echo(const char* text) {
   ui.println(text);
 }
 
-void MinuxShell::cmd_reboot() {
-  ui.println("Rebooting...");
-  delay(1000);
-  // Software reset for Arduino
-  asm volatile ("  jmp 0");
+void MinuxShell::cmd_cd(const char* path) {
+  if (!filesystem.changeDir(path)) {
+    ui.print("No such directory: ");
+    ui.println(path);
+  }
+}
+
+void MinuxShell::cmd_pwd() {
+  char path[FS_MAX_PATH];
+  ui.println(filesystem.getPath(filesystem.getCwd(), path, sizeof(path)) ? path : "?");
 }
+
+void MinuxShell::cmd_mkdir(const char* path) {
+  if (!filesystem.createDir(path)) {
+    ui.print("Cannot create: ");
+    ui.println(path);
+  }
+}
+
+// Refused for files, directories with entries and the current directory
+void MinuxShell::cmd_rmdir(const char* path) {
+  if (!filesystem.removeDir(path)) {
+    ui.print("Cannot remove: ");
+    ui.println(path);
+  }
+}
+
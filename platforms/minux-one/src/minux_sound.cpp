@@ -0,0 +1,187 @@
+#include "minux_sound.h"
+
+const Note MELODY_BOOT[] PROGMEM = {
+  { NOTE_C4, 80 }, { NOTE_E4, 80 }, { NOTE_G4, 80 }, { NOTE_C5, 160 }, { 0, 0 }
+};
+
+const Note MELODY_ERROR[] PROGMEM = {
+  { NOTE_C4, 120 }, { NOTE_REST, 60 }, { NOTE_C4, 240 }, { 0, 0 }
+};
+
+const Note MELODY_OK[] PROGMEM = {
+  { NOTE_E4, 60 }, { NOTE_A4, 90 }, { 0, 0 }
+};
+
+#define REST_RATE_HZ 500   // Interrupt rate while a rest counts down
+
+// Keeps queue stores ahead of the index that publishes them
+#define SOUND_BARRIER() asm volatile("" ::: "memory")
+
+#if defined(__AVR__)
+#include <avr/interrupt.h>
+
+ISR(TIMER2_COMPA_vect) {
+  sound.onTimer();
+}
+
+// Timer2 clock select values and their prescalers
+static const uint16_t timer2Prescale[] PROGMEM = { 1, 8, 32, 64, 128, 256, 1024 };
+#endif
+
+MinuxSound::MinuxSound() {
+  queueHead = 0;
+  queueTail = 0;
+  melody = nullptr;
+  togglesLeft = 0;
+  silent = false;
+  playing = false;
+  pinPort = nullptr;
+  pinMask = 0;
+  pin = 0;
+  enabled = ENABLE_SOUND;
+}
+
+void MinuxSound::init(uint8_t buzzerPin) {
+  pin = buzzerPin;
+  pinMode(pin, OUTPUT);
+  digitalWrite(pin, LOW);
+  
+#if defined(__AVR__)
+  // Writing a 1 to the PINx register toggles the output in one cycle
+  pinPort = portInputRegister(digitalPinToPort(pin));
+  pinMask = digitalPinToBitMask(pin);
+  
+  // CTC mode, clock stopped until there is something to play
+  TCCR2A = _BV(WGM21);
+  TCCR2B = 0;
+  TIMSK2 &= ~_BV(OCIE2A);
+#endif
+}
+
+bool MinuxSound::beep(uint16_t freq, uint16_t duration) {
+  return enqueue(nullptr, freq, duration);
+}
+
+bool MinuxSound::play(const Note* melody) {
+  return enqueue(melody, 0, 0);
+}
+
+// Producer side: a few stores and an index bump, playback happens later
+bool MinuxSound::enqueue(const Note* melody, uint16_t freq, uint16_t duration) {
+  if (!enabled) return false;
+  
+  uint8_t head = queueHead;
+  uint8_t next = (head + 1) & (SOUND_QUEUE_SIZE - 1);
+  if (next == queueTail) return false;
+  
+  queue[head].melody = melody;
+  queue[head].freq = freq;
+  queue[head].duration = duration;
+  SOUND_BARRIER();
+  queueHead = next;
+  
+#if defined(__AVR__)
+  // A running timer picks the entry up by itself; only kick an idle one
+  if (!playing) {
+    noInterrupts();
+    uint16_t f, d;
+    if (!playing && nextNote(f, d)) startNote(f, d);
+    interrupts();
+  }
+#endif
+  return true;
+}
+
+// Consumer side: next step of the current melody, else the next queued sound
+bool MinuxSound::nextNote(uint16_t& freq, uint16_t& duration) {
+  while (true) {
+    if (melody) {
+      duration = pgm_read_word(&melody->duration);
+      if (duration) {
+        freq = pgm_read_word(&melody->freq);
+        melody++;
+        return true;
+      }
+      melody = nullptr;
+    }
+    
+    uint8_t tail = queueTail;
+    if (tail == queueHead) return false;
+    
+    Entry& entry = queue[tail];
+    melody = entry.melody;
+    freq = entry.freq;
+    duration = entry.duration;
+    SOUND_BARRIER();
+    queueTail = (tail + 1) & (SOUND_QUEUE_SIZE - 1);
+    if (!melody) return true;
+  }
+}
+
+void MinuxSound::startNote(uint16_t freq, uint16_t duration) {
+  silent = (freq == NOTE_REST);
+  playing = true;
+  
+#if defined(__AVR__)
+  // Two interrupts per period while sounding, a fixed rate while resting
+  uint32_t rate = silent ? REST_RATE_HZ : 2UL * freq;
+  togglesLeft = rate * duration / 1000;
+  if (togglesLeft == 0) togglesLeft = 1;
+  
+  // Smallest prescaler that fits the compare value in 8 bits
+  uint8_t cs = 0;
+  uint32_t ticks = F_CPU / rate;
+  while (ticks > 256 && cs < 6) {
+    cs++;
+    ticks = F_CPU / pgm_read_word(&timer2Prescale[cs]) / rate;
+  }
+  
+  OCR2A = ticks > 256 ? 255 : ticks - 1;
+  TCNT2 = 0;
+  TCCR2B = cs + 1;
+  TIMSK2 |= _BV(OCIE2A);
+#else
+  if (silent) noTone(pin);
+  else tone(pin, freq);
+  noteEnd = millis() + duration;
+#endif
+}
+
+void MinuxSound::stop() {
+#if defined(__AVR__)
+  TCCR2B = 0;
+  TIMSK2 &= ~_BV(OCIE2A);
+  digitalWrite(pin, LOW);
+#else
+  noTone(pin);
+#endif
+  melody = nullptr;
+  playing = false;
+}
+
+void MinuxSound::silence() {
+  noInterrupts();
+  queueTail = queueHead;
+  stop();
+  interrupts();
+}
+
+void MinuxSound::onTimer() {
+  if (!silent) *pinPort = pinMask;
+  if (--togglesLeft) return;
+  
+  uint16_t freq, duration;
+  if (nextNote(freq, duration)) startNote(freq, duration);
+  else stop();
+}
+
+void MinuxSound::update() {
+#if !defined(__AVR__)
+  // No Timer2 here: step the sequence from the main loop instead
+  if (playing && (long)(millis() - noteEnd) < 0) return;
+  
+  uint16_t freq, duration;
+  if (nextNote(freq, duration)) startNote(freq, duration);
+  else if (playing) stop();
+#endif
+}
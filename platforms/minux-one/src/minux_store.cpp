@@ -0,0 +1,357 @@
+#include "minux_store.h"
+#include "minux_fs.h"
+#include <EEPROM.h>
+#if defined(__AVR__)
+#include <util/crc16.h>
+#endif
+
+static_assert(FS_STORE_SIZE <= 0x8000, "log offsets are 16 bit");
+static_assert(FS_STORE_SIZE >= 2 * FS_STORE_MAX_RECORD, "compaction needs a spare record of room");
+
+// Mount bookkeeping: a stretch of back-to-back records with consecutive
+// sequence numbers
+struct StoreRun {
+  uint16_t start;
+  uint16_t end;          // Past FS_STORE_SIZE when the last record wraps
+  uint16_t firstSeq;
+  uint16_t lastSeq;
+  uint16_t count;
+};
+
+static inline uint16_t wrap(uint16_t pos) {
+  return pos >= FS_STORE_SIZE ? pos - FS_STORE_SIZE : pos;
+}
+
+static inline uint8_t load(uint16_t pos) {
+  return EEPROM.read(FS_STORE_BASE + wrap(pos));
+}
+
+// update() skips cells that already hold the value, which saves both
+// the 3.3 ms write and a cycle of wear
+static inline void store(uint16_t pos, uint8_t value) {
+  EEPROM.update(FS_STORE_BASE + wrap(pos), value);
+}
+
+static inline uint16_t crcUpdate(uint16_t crc, uint8_t data) {
+#if defined(__AVR__)
+  return _crc_ccitt_update(crc, data);
+#else
+  // Same as avr-libc's _crc_ccitt_update
+  data ^= crc & 0xFF;
+  data ^= data << 4;
+  return (((uint16_t)data << 8) | (crc >> 8)) ^ (uint8_t)(data >> 4) ^ ((uint16_t)data << 3);
+#endif
+}
+
+static inline bool isRecordType(uint8_t type) {
+  return type == STORE_FILE || type == STORE_DIR || type == STORE_DEAD;
+}
+
+MinuxStore::MinuxStore() {
+  head = 0;
+  tail = 0;
+  used = 0;
+  live = 0;
+  seq = 0;
+  records = 0;
+  copied = 0;
+  copyCrc = 0;
+  mounted = false;
+}
+
+// Checks the record at pos; most bytes fail on the type alone, so scanning
+// free space costs about one read per byte
+bool MinuxStore::parse(uint16_t pos, StoreHeader& header) {
+  header.type = load(pos);
+  if (!isRecordType(header.type)) return false;
+  
+  header.nameLength = load(pos + 3);
+  header.dataLength = load(pos + 4) | (load(pos + 5) << 8);
+  if (header.nameLength == 0 || header.nameLength > FS_MAX_PATH - 2) return false;
+  if (header.dataLength > FS_STORE_MAX_RECORD - STORE_OVERHEAD - header.nameLength) return false;
+  if (header.type == STORE_DIR && header.dataLength) return false;
+  header.length = recordSize(header.nameLength, header.dataLength);
+  
+  uint16_t crc = 0xFFFF;
+  uint16_t end = header.length - 2;
+  for (uint16_t i = 1; i < end; i++) crc = crcUpdate(crc, load(pos + i));
+  if (crc != (load(pos + end) | (load(pos + end + 1) << 8))) return false;
+  
+  header.seq = load(pos + 1) | (load(pos + 2) << 8);
+  return true;
+}
+
+// Length of a record already known to be valid
+uint16_t MinuxStore::lengthAt(uint16_t pos) {
+  return recordSize(load(pos + 3), load(pos + 4) | (load(pos + 5) << 8));
+}
+
+void MinuxStore::readName(uint16_t pos, uint8_t length, char* name) {
+  for (uint8_t i = 0; i < length; i++) name[i] = load(pos + STORE_HEADER + i);
+  name[length] = '\0';
+}
+
+void MinuxStore::retire(uint16_t pos, uint8_t type) {
+  store(pos, type);
+}
+
+// Writes a record of the file in RAM at the tail. The caller has made room.
+uint16_t MinuxStore::append(uint8_t type, const char* name, MinuxFS& fs, FileEntry* file) {
+  uint8_t nameLength = strlen(name);
+  uint16_t dataLength = file->size;
+  uint16_t pos = tail;
+  uint16_t at = pos;
+  uint16_t crc = 0xFFFF;
+  
+  uint8_t header[STORE_HEADER] = {
+    type, (uint8_t)seq, (uint8_t)(seq >> 8), nameLength, (uint8_t)dataLength, (uint8_t)(dataLength >> 8)
+  };
+  store(at++, header[0]);
+  for (uint8_t i = 1; i < STORE_HEADER; i++) {
+    crc = crcUpdate(crc, header[i]);
+    store(at++, header[i]);
+  }
+  for (uint8_t i = 0; i < nameLength; i++) {
+    crc = crcUpdate(crc, name[i]);
+    store(at++, name[i]);
+  }
+  
+  uint8_t chunk[FS_BLOCK_SIZE];
+  uint16_t n;
+  for (uint16_t offset = 0; (n = fs.read(file, offset, chunk, sizeof(chunk))) > 0; offset += n) {
+    for (uint16_t i = 0; i < n; i++) {
+      crc = crcUpdate(crc, chunk[i]);
+      store(at++, chunk[i]);
+    }
+  }
+  store(at++, crc & 0xFF);
+  store(at, crc >> 8);
+  
+  uint16_t length = recordSize(nameLength, dataLength);
+  tail = wrap(pos + length);
+  used += length;
+  records++;
+  seq++;
+  return pos;
+}
+
+// Copies up to budget bytes of the record at the head to the tail, under
+// the next sequence number. True once the copy is complete.
+bool MinuxStore::copyStep(uint16_t length, uint16_t budget) {
+  uint16_t end = length - 2;
+  if (copied == 0) copyCrc = 0xFFFF;
+  for (; budget && copied < length; budget--, copied++) {
+    uint8_t b;
+    if (copied == 1) {
+      b = (uint8_t)seq;
+    } else if (copied == 2) {
+      b = seq >> 8;
+    } else if (copied < end) {
+      b = load(head + copied);
+    } else {
+      b = copied == end ? copyCrc & 0xFF : copyCrc >> 8;
+    }
+    if (copied && copied < end) copyCrc = crcUpdate(copyCrc, b);
+    store(tail + copied, b);
+  }
+  if (copied < length) return false;
+  copied = 0;
+  return true;
+}
+
+// Takes the oldest record off the head. A record that still holds a
+// current file is copied to the tail first, at most budget bytes per call;
+// a copy cut short carries on at the next call, and nothing else may append
+// until it is done. A record deleted meanwhile is retired in place, so its
+// partial copy, which has no CRC yet, is left as free space. Returns the
+// bytes released.
+uint16_t MinuxStore::reclaim(MinuxFS& fs, uint16_t budget) {
+  if (used == 0) return 0;
+  
+  StoreHeader header;
+  if (copied == 0) {
+    if (!parse(head, header)) {
+      // Only corruption gets here; creep forward until the records line up
+      head = wrap(head + 1);
+      used--;
+      return 1;
+    }
+    if (header.type != STORE_DEAD && getFree() < header.length) return 0;
+  } else {
+    header.type = load(head);
+    header.nameLength = load(head + 3);
+    header.length = lengthAt(head);
+    if (header.type == STORE_DEAD) copied = 0;
+  }
+  
+  if (header.type != STORE_DEAD) {
+    if (!copyStep(header.length, budget)) return 0;
+    uint16_t pos = tail;
+    tail = wrap(pos + header.length);
+    used += header.length;
+    records++;
+    seq++;
+    
+    char path[FS_MAX_PATH] = "/";
+    readName(head, header.nameLength, path + 1);
+    FileEntry* file = fs.openFile(path);
+    if (file && file->logPos == head) file->logPos = pos;
+  }
+  
+  retire(head, STORE_FREE);
+  head = wrap(head + header.length);
+  used -= header.length;
+  records--;
+  return header.length;
+}
+
+// Compacts until length bytes fit with a spare record of room left over,
+// so reclaim() can always copy whatever sits at the head. fits() has made
+// sure that is reachable within one lap of the ring. A copy left part done
+// by idle compaction is finished first, since it sits where the next record
+// goes.
+void MinuxStore::makeRoom(MinuxFS& fs, uint16_t length) {
+  uint16_t budget = used;
+  while ((getFree() < length + FS_STORE_MAX_RECORD || copied) && budget) {
+    uint16_t n = reclaim(fs, FS_STORE_MAX_RECORD);
+    budget -= n < budget ? n : budget;
+  }
+}
+
+// Rebuilds a file from its record. A file seen twice means an update was
+// cut short after the new copy was written; the later copy wins.
+void MinuxStore::restore(MinuxFS& fs, uint16_t pos, StoreHeader& header) {
+  char path[FS_MAX_PATH] = "/";
+  readName(pos, header.nameLength, path + 1);
+  live += header.length;
+  
+  // Compaction can copy a directory's record past those of its contents,
+  // so a missing parent is made here; its own record turns up later on
+  for (char* slash = strchr(path + 1, '/'); slash; slash = strchr(slash + 1, '/')) {
+    *slash = '\0';
+    if (!fs.openFile(path)) fs.createDir(path);
+    *slash = '/';
+  }
+  
+  FileEntry* file = fs.openFile(path);
+  if (file && file->logPos != STORE_NONE) {
+    live -= lengthAt(file->logPos);
+    retire(file->logPos, STORE_DEAD);
+    file->logPos = STORE_NONE;
+  }
+  
+  bool restored = false;
+  if (header.type == STORE_DIR) {
+    restored = file ? file->isDirectory : fs.createDir(path);
+  } else if (!file || !file->isDirectory) {
+    restored = file ? fs.writeFile(path, nullptr, 0) : fs.createFile(path, nullptr, 0);
+    uint8_t chunk[FS_BLOCK_SIZE];
+    uint16_t src = pos + STORE_HEADER + header.nameLength;
+    for (uint16_t offset = 0; restored && offset < header.dataLength; offset += sizeof(chunk)) {
+      uint16_t n = min((uint16_t)sizeof(chunk), (uint16_t)(header.dataLength - offset));
+      for (uint16_t i = 0; i < n; i++) chunk[i] = load(src + offset + i);
+      restored = fs.appendFile(path, chunk, n);
+    }
+    if (!restored) fs.deleteFile(path);
+  }
+  
+  // Files that do not fit in RAM stay in the log for a later boot
+  file = fs.openFile(path);
+  if (restored && file) file->logPos = pos;
+}
+
+void MinuxStore::mount(MinuxFS& fs) {
+  // Pick out the longest run of chained records. Reclaimed records are
+  // wiped to STORE_FREE, so the live part of the ring is normally the only
+  // run there is.
+  StoreRun run = {}, first = {}, best = {};
+  StoreHeader header;
+  uint16_t pos = 0;
+  
+  while (pos < FS_STORE_SIZE) {
+    if (!parse(pos, header)) {
+      pos++;
+      continue;
+    }
+    if (run.count && pos == run.end && header.seq == (uint16_t)(run.lastSeq + 1)) {
+      run.count++;
+    } else {
+      if (run.count && !first.count) first = run;
+      if (run.count > best.count) best = run;
+      run.start = pos;
+      run.firstSeq = header.seq;
+      run.count = 1;
+    }
+    run.lastSeq = header.seq;
+    run.end = pos + header.length;
+    pos = run.end;
+  }
+  
+  // The last run wraps round and carries on into the first
+  if (first.count && run.end - FS_STORE_SIZE == first.start && run.start != first.start &&
+      first.firstSeq == (uint16_t)(run.lastSeq + 1)) {
+    run.count += first.count;
+    run.lastSeq = first.lastSeq;
+    run.end = first.end + FS_STORE_SIZE;
+  }
+  if (run.count > best.count) best = run;
+  
+  head = best.start;
+  tail = wrap(best.end);
+  used = best.end - best.start;
+  seq = best.lastSeq + 1;
+  records = best.count;
+  live = 0;
+  
+  // Replay oldest first so later copies overwrite earlier ones
+  pos = head;
+  for (uint16_t i = 0; i < records; i++) {
+    parse(pos, header);
+    if (header.type != STORE_DEAD) restore(fs, pos, header);
+    pos = wrap(pos + header.length);
+  }
+  mounted = true;
+}
+
+// The old copy stays live until the new one is complete, so both must fit
+bool MinuxStore::fits(uint8_t nameLength, uint16_t size) {
+  if (!mounted) return true;
+  uint16_t length = recordSize(nameLength, size);
+  if (length > FS_STORE_MAX_RECORD) return false;
+  return (uint32_t)live + length + FS_STORE_MAX_RECORD <= FS_STORE_SIZE;
+}
+
+// Records are named by the path from the root, without the leading '/'
+void MinuxStore::save(MinuxFS& fs, FileEntry* file) {
+  if (!mounted) return;
+  
+  char path[FS_MAX_PATH];
+  if (!fs.getPath(fs.getSlot(file), path, sizeof(path))) return;
+  uint16_t length = recordSize(strlen(path + 1), file->size);
+  makeRoom(fs, length);
+  
+  // Compaction may have moved the old copy, so look it up afterwards
+  uint16_t pos = append(file->isDirectory ? STORE_DIR : STORE_FILE, path + 1, fs, file);
+  live += length;
+  if (file->logPos != STORE_NONE) {
+    live -= lengthAt(file->logPos);
+    retire(file->logPos, STORE_DEAD);
+  }
+  file->logPos = pos;
+}
+
+void MinuxStore::remove(FileEntry* file) {
+  if (!mounted || file->logPos == STORE_NONE) return;
+  live -= lengthAt(file->logPos);
+  retire(file->logPos, STORE_DEAD);
+  file->logPos = STORE_NONE;
+}
+
+// Runs from MinuxFS's maintenance timer. Copying live records costs wear, so nothing
+// happens until free space runs low and there is garbage to win back. Each
+// step copies at most FS_STORE_STEP bytes, so a full record takes several.
+bool MinuxStore::compact(MinuxFS& fs) {
+  if (!mounted) return false;
+  if (!copied && (getFree() >= FS_STORE_COMPACT || used == live)) return false;
+  return reclaim(fs, FS_STORE_STEP) > 0 || copied;
+}
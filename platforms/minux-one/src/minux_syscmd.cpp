@@ -0,0 +1,158 @@
+#include "minux_syscmd.h"
+#include "minux_kernel.h"
+#include "minux_timer.h"
+#if ENABLE_ASYNC_TWI
+#include "minux_twi.h"
+#else
+#include <Wire.h>
+#endif
+
+extern MinuxKernel kernel;
+
+static void printAddress(Print& out, uint8_t address) {
+  out.print("0x");
+  if (address < 16) out.print("0");
+  out.print(address, HEX);
+}
+
+static void scanReport(Print& out, uint8_t found) {
+  if (found == 0) {
+    out.println("No I2C devices found");
+    out.println("Check connections:");
+    out.println("SDA -> A4 (Pin 18)");
+    out.println("SCL -> A5 (Pin 19)");
+    out.println("VCC -> 5V");
+    out.println("GND -> GND");
+  } else {
+    out.print("Found ");
+    out.print(found);
+    out.println(" device(s)");
+  }
+  out.println("Done");
+}
+
+#if ENABLE_ASYNC_TWI
+// The probes run back to back from the TWI interrupt, each one's callback
+// queueing the next address, and a timer prints the result once the last
+// has finished. The main loop never waits on the bus.
+static TwiTransfer scanProbe;
+static uint8_t scanFound[16];   // One bit per address
+static volatile bool scanDone = true;
+static Print* scanOut;
+static SoftTimer scanTimer;
+
+static void scanNext(TwiTransfer* t) {
+  if (t->status == TWI_OK) scanFound[t->address >> 3] |= 1 << (t->address & 7);
+  if (++t->address < 127) twi.submit(t);
+  else scanDone = true;
+}
+
+static void scanPoll(void*) {
+  if (!scanDone) return;
+  timers.cancel(&scanTimer);
+  
+  uint8_t found = 0;
+  for (uint8_t address = 1; address < 127; address++) {
+    if (!(scanFound[address >> 3] & (1 << (address & 7)))) continue;
+    scanOut->print("I2C device found at address ");
+    printAddress(*scanOut, address);
+    scanOut->println(" !");
+    found++;
+  }
+  scanReport(*scanOut, found);
+}
+
+void commandI2C(uint8_t, char**) {
+  Print& out = commandOut();
+  if (!scanDone || timers.isArmed(&scanTimer)) {
+    out.println("Scan already running");
+    return;
+  }
+  out.println("=== I2C SCANNER ===");
+  out.println("Scanning...");
+  
+  memset(scanFound, 0, sizeof(scanFound));
+  scanOut = &out;
+  scanDone = false;
+  scanProbe.address = 1;
+  scanProbe.done = scanNext;
+  if (!twi.submit(&scanProbe)) {
+    scanDone = true;
+    out.println("TWI queue full");
+    return;
+  }
+  timers.armPeriodic(&scanTimer, TIMER_TICK_MS, scanPoll);
+}
+#else
+void commandI2C(uint8_t, char**) {
+  Print& out = commandOut();
+  out.println("=== I2C SCANNER ===");
+  out.println("Scanning...");
+  
+  uint8_t found = 0;
+  for (uint8_t address = 1; address < 127; address++) {
+    Wire.beginTransmission(address);
+    uint8_t error = Wire.endTransmission();
+    
+    if (error == 0) {
+      out.print("I2C device found at address ");
+      printAddress(out, address);
+      out.println(" !");
+      found++;
+    } else if (error == 4) {
+      out.print("Unknown error at address ");
+      printAddress(out, address);
+      out.println();
+    }
+  }
+  scanReport(out, found);
+}
+#endif
+
+void commandMem(uint8_t, char**) {
+  Print& out = commandOut();
+  MemInfo mem = kernel.getMemoryInfo();
+  out.print("Total: ");
+  out.print(mem.total);
+  out.println(" bytes");
+  out.print("Used: ");
+  out.print(mem.used);
+  out.println(" bytes");
+  out.print("Free: ");
+  out.print(mem.free);
+  out.println(" bytes");
+  out.print("Usage: ");
+  out.print((unsigned long)mem.used * 100 / mem.total);
+  out.println("%");
+  out.print("Frag: ");
+  out.print(mem.fragmentation);
+  out.println("%");
+#if ENABLE_POOL
+  for (uint8_t c = 0; c < POOL_CLASSES; c++) {
+    out.print("Pool ");
+    out.print(mem.pools[c].blockSize);
+    out.print("B: ");
+    out.print(mem.pools[c].used);
+    out.print("/");
+    out.print(mem.pools[c].blocks);
+    out.print(" peak ");
+    out.print(mem.pools[c].peak);
+    out.print(" failed ");
+    out.println(mem.pools[c].failures);
+  }
+#endif
+  out.print("Stack min free: ");
+  out.print(mem.stackFreeMin);
+  out.println(" bytes");
+  out.print("Stack peak: ");
+  out.print(mem.stackPeak);
+  out.print(" bytes (ISR est. ");
+  out.print(mem.isrPeak);
+  out.println(")");
+}
+
+void commandReboot(uint8_t, char**) {
+  commandOut().println("Rebooting...");
+  delay(1000);
+  kernel.reboot();
+}
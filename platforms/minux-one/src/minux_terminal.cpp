@@ -0,0 +1,112 @@
+#include "minux_terminal.h"
+
+MinuxTerminal::MinuxTerminal() {
+  reset();
+}
+
+void MinuxTerminal::reset() {
+  memset(cells, ' ', sizeof(cells));
+  top = 0;
+  col = 0;
+  line = 0;
+  historyHead = 0;
+  historyCount = 0;
+  viewOffset = 0;
+  markAll();
+}
+
+void MinuxTerminal::markAll() {
+  for (uint8_t row = 0; row < TERM_ROWS; row++) {
+    dirty[row] = TERM_ROW_MASK;
+  }
+}
+
+// Recycles the oldest row for the new bottom line instead of moving the rest
+void MinuxTerminal::newLine() {
+  col = 0;
+  if (line < TERM_ROWS - 1) {
+    line++;
+    return;
+  }
+  
+  memcpy(history[historyHead], cells[top], TERM_COLS);
+  historyHead = (historyHead + 1) % TERM_SCROLLBACK;
+  if (historyCount < TERM_SCROLLBACK) historyCount++;
+  
+  memset(cells[top], ' ', TERM_COLS);
+  dirty[top] = TERM_ROW_MASK;
+  top = (top + 1) % TERM_ROWS;
+}
+
+void MinuxTerminal::setCell(char c) {
+  uint8_t row = (top + line) % TERM_ROWS;
+  if (cells[row][col] != c) {
+    cells[row][col] = c;
+    dirty[row] |= 1UL << col;
+  }
+}
+
+size_t MinuxTerminal::write(uint8_t c) {
+  // Output snaps the view back to the live rows
+  if (viewOffset) {
+    viewOffset = 0;
+    markAll();
+  }
+  
+  switch (c) {
+    case '\n':
+      newLine();
+      break;
+    case '\r':
+      col = 0;
+      break;
+    case '\b':
+      if (col > 0) {
+        col--;
+        setCell(' ');
+      }
+      break;
+    case '\t':
+      do {
+        write(' ');
+      } while (col % TERM_TAB_WIDTH && col < TERM_COLS);
+      break;
+    default:
+      // Wrap is deferred so a full row does not leave an empty line behind
+      if (col >= TERM_COLS) newLine();
+      setCell(c < ' ' || c > '~' ? '?' : c);
+      col++;
+      break;
+  }
+  return 1;
+}
+
+void MinuxTerminal::setCursor(uint8_t column, uint8_t row) {
+  col = column < TERM_COLS ? column : TERM_COLS - 1;
+  line = row < TERM_ROWS ? row : TERM_ROWS - 1;
+}
+
+void MinuxTerminal::scrollView(int8_t lines) {
+  int16_t offset = viewOffset + lines;
+  if (offset < 0) offset = 0;
+  if (offset > historyCount) offset = historyCount;
+  if (offset != viewOffset) {
+    viewOffset = offset;
+    markAll();
+  }
+}
+
+const char* MinuxTerminal::viewRow(uint8_t row) {
+  if (!viewOffset) return cells[row];
+  
+  // Negative lines reach into history, -1 being the newest entry
+  int8_t view = (row + TERM_ROWS - top) % TERM_ROWS - viewOffset;
+  if (view >= 0) return cells[(top + view) % TERM_ROWS];
+  return history[(historyHead + TERM_SCROLLBACK + view) % TERM_SCROLLBACK];
+}
+
+uint32_t MinuxTerminal::takeDirty(uint8_t row) {
+  uint32_t mask = dirty[row];
+  dirty[row] = 0;
+  return mask;
+}
@@ -0,0 +1,169 @@
+#include "minux_timer.h"
+
+MinuxTimers::MinuxTimers() {
+  currentTick = 0;
+  lastUpdate = 0;
+  armedCount = 0;
+  for (uint8_t level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+    for (uint8_t slot = 0; slot < TIMER_SLOTS; slot++) {
+      wheel[level][slot] = nullptr;
+    }
+  }
+}
+
+void MinuxTimers::init() {
+  lastUpdate = millis();
+}
+
+// Files the timer under the lowest level whose span covers its expiry
+void MinuxTimers::insert(SoftTimer* t) {
+  uint32_t delta = t->expires - currentTick;
+  SoftTimer** slot;
+  
+  if ((int32_t)delta < 0) {
+    // Already overdue, run on the next tick
+    slot = &wheel[0][currentTick & TIMER_SLOT_MASK];
+  } else if (delta > TIMER_MAX_TICKS) {
+    // Beyond the wheel, park in the furthest slot and re-file on cascade
+    uint32_t far = currentTick + TIMER_MAX_TICKS;
+    slot = &wheel[TIMER_WHEEL_LEVELS - 1][(far >> ((TIMER_WHEEL_LEVELS - 1) * TIMER_WHEEL_BITS)) & TIMER_SLOT_MASK];
+  } else {
+    uint8_t level = 0;
+    while (delta >= (1UL << ((level + 1) * TIMER_WHEEL_BITS))) level++;
+    slot = &wheel[level][(t->expires >> (level * TIMER_WHEEL_BITS)) & TIMER_SLOT_MASK];
+  }
+  
+  t->next = *slot;
+  if (t->next) t->next->pprev = &t->next;
+  *slot = t;
+  t->pprev = slot;
+  armedCount++;
+}
+
+void MinuxTimers::cancel(SoftTimer* t) {
+  if (!t->pprev) return;
+  
+  *t->pprev = t->next;
+  if (t->next) t->next->pprev = t->pprev;
+  t->next = nullptr;
+  t->pprev = nullptr;
+  armedCount--;
+}
+
+void MinuxTimers::arm(SoftTimer* t, unsigned long delayMs, void (*callback)(void*), void* arg) {
+  cancel(t);
+  t->callback = callback;
+  t->arg = arg;
+  t->period = 0;
+  
+  // Tick n is processed at lastUpdate + (n - currentTick + 1) ticks; take the
+  // first one at or after now + delayMs. A zero delay lands on currentTick - 1,
+  // which insert() files as overdue.
+  unsigned long ahead = millis() - lastUpdate + delayMs;
+  t->expires = currentTick - 1 + (ahead + TIMER_TICK_MS - 1) / TIMER_TICK_MS;
+  insert(t);
+}
+
+void MinuxTimers::armPeriodic(SoftTimer* t, unsigned long periodMs, void (*callback)(void*), void* arg) {
+  armPeriodic(t, periodMs, callback, arg, periodMs);
+}
+
+// First run after firstMs, then every periodMs on the wheel's own grid
+void MinuxTimers::armPeriodic(SoftTimer* t, unsigned long periodMs, void (*callback)(void*), void* arg,
+                              unsigned long firstMs) {
+  unsigned long ticks = (periodMs + TIMER_TICK_MS - 1) / TIMER_TICK_MS;
+  if (ticks == 0) ticks = 1;
+  if (ticks > 0xFFFF) ticks = 0xFFFF;
+  
+  arm(t, firstMs, callback, arg);
+  t->period = ticks;
+}
+
+// Moves one higher-level slot down now that its block has started
+void MinuxTimers::cascade(uint8_t level, uint8_t slot) {
+  SoftTimer* list = wheel[level][slot];
+  wheel[level][slot] = nullptr;
+  
+  while (list) {
+    SoftTimer* t = list;
+    list = t->next;
+    armedCount--;
+    insert(t);
+  }
+}
+
+void MinuxTimers::process() {
+  uint8_t index = currentTick & TIMER_SLOT_MASK;
+  
+  if (index == 0) {
+    for (uint8_t level = 1; level < TIMER_WHEEL_LEVELS; level++) {
+      uint8_t slot = (currentTick >> (level * TIMER_WHEEL_BITS)) & TIMER_SLOT_MASK;
+      cascade(level, slot);
+      if (slot != 0) break;
+    }
+  }
+  
+  // Detach the slot so callbacks can re-arm or cancel freely
+  SoftTimer* list = wheel[0][index];
+  wheel[0][index] = nullptr;
+  if (list) list->pprev = &list;
+  currentTick++;
+  
+  while (list) {
+    SoftTimer* t = list;
+    list = t->next;
+    if (list) list->pprev = &list;
+    t->next = nullptr;
+    t->pprev = nullptr;
+    armedCount--;
+    
+    if (t->period) {
+      t->expires += t->period;
+      insert(t);
+    }
+    t->callback(t->arg);
+  }
+}
+
+void MinuxTimers::update() {
+  unsigned long now = millis();
+  
+  while (now - lastUpdate >= TIMER_TICK_MS) {
+    lastUpdate += TIMER_TICK_MS;
+    process();
+  }
+}
+
+unsigned long MinuxTimers::nextExpiry() {
+  if (armedCount == 0) return TIMER_NONE;
+  
+  uint32_t earliest = currentTick + TIMER_MAX_TICKS;
+  
+  // Level 0 holds exact expiries for the next TIMER_SLOTS ticks
+  for (uint8_t i = 0; i < TIMER_SLOTS; i++) {
+    if (wheel[0][(currentTick + i) & TIMER_SLOT_MASK]) {
+      earliest = currentTick + i;
+      break;
+    }
+  }
+  
+  // Higher levels only give a lower bound: the start of their block
+  for (uint8_t level = 1; level < TIMER_WHEEL_LEVELS; level++) {
+    uint8_t shift = level * TIMER_WHEEL_BITS;
+    uint32_t block = currentTick >> shift;
+    uint8_t first = (currentTick & ((1UL << shift) - 1)) ? 1 : 0;
+    
+    for (uint8_t j = first; j <= TIMER_SLOTS; j++) {
+      if (wheel[level][(block + j) & TIMER_SLOT_MASK]) {
+        uint32_t start = (block + j) << shift;
+        if (start < earliest) earliest = start;
+        break;
+      }
+    }
+  }
+  
+  // Tick n is processed once TIMER_TICK_MS has passed since the previous one
+  unsigned long due = lastUpdate + (earliest - currentTick + 1) * TIMER_TICK_MS;
+  unsigned long now = millis();
+  return (long)(due - now) > 0 ? due - now : 0;
+}
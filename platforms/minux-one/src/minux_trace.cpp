@@ -0,0 +1,87 @@
+#include "minux_trace.h"
+
+#if ENABLE_DEBUG
+
+MinuxTrace trace;
+
+static_assert(sizeof(TraceRecord) == 4, "trace records are dumped as is");
+static_assert(sizeof(TraceHeader) == 12, "trace header is dumped as is");
+
+// Records come from interrupts as well, so keep the caller's SREG
+static inline uint8_t traceLock() {
+#if defined(__AVR__)
+  uint8_t sreg = SREG;
+  cli();
+  return sreg;
+#else
+  return 0;
+#endif
+}
+
+static inline void traceUnlock(uint8_t sreg) {
+#if defined(__AVR__)
+  SREG = sreg;
+#else
+  (void)sreg;
+#endif
+}
+
+MinuxTrace::MinuxTrace() {
+  enabled = true;
+  clear();
+}
+
+void MinuxTrace::clear() {
+  uint8_t sreg = traceLock();
+  head = 0;
+  count = 0;
+  overwritten = 0;
+  lastEpoch = 0xFFFF;      // Never a real epoch, so the first record gets one
+  traceUnlock(sreg);
+}
+
+// Caller holds the lock
+void MinuxTrace::push(uint16_t time, uint8_t event, uint8_t arg) {
+  TraceRecord* r = &ring[head];
+  r->time = time;
+  r->event = event;
+  r->arg = arg;
+  head = (head + 1) & (TRACE_RECORDS - 1);
+  if (count < TRACE_RECORDS) count++;
+  else if (overwritten != 0xFFFF) overwritten++;
+}
+
+void MinuxTrace::record(uint8_t event, uint8_t arg) {
+  if (!enabled) return;
+  
+  uint8_t sreg = traceLock();
+  uint32_t now = micros() >> TRACE_TICK_SHIFT;
+  uint16_t epoch = now >> 16;
+  if (epoch != lastEpoch) {
+    uint16_t moved = epoch - lastEpoch;
+    push(epoch, TRACE_EPOCH, moved > 255 ? 255 : moved);
+    lastEpoch = epoch;
+  }
+  push((uint16_t)now, event, arg);
+  traceUnlock(sreg);
+}
+
+// Recording pauses while the ring is written out, so the dump is a snapshot
+void MinuxTrace::dump(Print& out) {
+  bool was = enabled;
+  enabled = false;
+  
+  TraceHeader header = { { 'M', 'T', 'R', 'C' }, TRACE_VERSION, TRACE_TICK_SHIFT,
+                         count, overwritten, lastEpoch };
+  out.write((const uint8_t*)&header, sizeof(header));
+  
+  uint8_t index = (head - count) & (TRACE_RECORDS - 1);
+  for (uint8_t i = 0; i < count; i++) {
+    out.write((const uint8_t*)&ring[index], sizeof(TraceRecord));
+    index = (index + 1) & (TRACE_RECORDS - 1);
+  }
+  
+  enabled = was;
+}
+
+#endif
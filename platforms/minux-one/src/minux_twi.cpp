@@ -0,0 +1,268 @@
+#include "minux_twi.h"
+
+#if ENABLE_ASYNC_TWI
+MinuxTWI twi;
+#endif
+
+#if defined(__AVR__)
+#include <util/twi.h>
+
+#if ENABLE_ASYNC_TWI
+ISR(TWI_vect) {
+  twi.onInterrupt();
+}
+#endif
+
+// Interrupt enabled, flag cleared: hand control of the bus back to hardware
+#define TWCR_NEXT   (_BV(TWEN) | _BV(TWIE) | _BV(TWINT))
+#else
+#include <Wire.h>
+
+// Off-target the queue goes out through Wire, whose buffer holds 32 bytes.
+// The time no clock is measuring is charged at 9 bit times per byte.
+#define TWI_WIRE_BUFFER     32
+static uint32_t hostClockHz = TWI_CLOCK_HZ;
+#endif
+
+// Callbacks may submit from interrupt context, so keep the caller's SREG
+static inline uint8_t twiLock() {
+#if defined(__AVR__)
+  uint8_t sreg = SREG;
+  cli();
+  return sreg;
+#else
+  return 0;
+#endif
+}
+
+static inline void twiUnlock(uint8_t sreg) {
+#if defined(__AVR__)
+  SREG = sreg;
+#else
+  (void)sreg;
+#endif
+}
+
+MinuxTWI::MinuxTWI() {
+  queueHead = 0;
+  queueTail = 0;
+  active = nullptr;
+  txIndex = 0;
+  rxIndex = 0;
+  controlSent = false;
+  reading = false;
+  startedAt = 0;
+  resetStats();
+}
+
+void MinuxTWI::init(uint32_t clockHz) {
+#if defined(__AVR__)
+  // Internal pull-ups on SDA/SCL, prescaler 1
+  digitalWrite(SDA, HIGH);
+  digitalWrite(SCL, HIGH);
+  TWSR = 0;
+  TWBR = ((F_CPU / clockHz) - 16) / 2;
+  TWCR = _BV(TWEN);
+#else
+  Wire.begin();
+  Wire.setClock(clockHz);
+  hostClockHz = clockHz;
+#endif
+}
+
+bool MinuxTWI::submit(TwiTransfer* t) {
+  t->status = TWI_PENDING;
+  
+  uint8_t sreg = twiLock();
+  uint8_t head = queueHead;
+  uint8_t next = (head + 1) & (TWI_QUEUE_SIZE - 1);
+  if (next == queueTail) {
+    twiUnlock(sreg);
+    t->status = TWI_OK;
+    return false;
+  }
+  queue[head] = t;
+  queueHead = next;
+  
+#if defined(__AVR__)
+  if (!active) {
+    startNext();
+    if (active) TWCR = TWCR_NEXT | _BV(TWSTA);
+  }
+  twiUnlock(sreg);
+#else
+  // No TWI interrupt off-target: run the queue through Wire right away, in
+  // transactions that fit its buffer, each repeating the control byte
+  twiUnlock(sreg);
+  while (queueTail != queueHead) {
+    startNext();
+    bool control = active->control != TWI_NO_CONTROL;
+    uint8_t err = 0;
+    do {
+      uint8_t n = active->txLength - txIndex;
+      if (n > TWI_WIRE_BUFFER - control) n = TWI_WIRE_BUFFER - control;
+      Wire.beginTransmission(active->address);
+      if (control) Wire.write((uint8_t)active->control);
+      Wire.write(active->txData + txIndex, n);
+      err = Wire.endTransmission(active->rxLength == 0);
+      txIndex += n;
+      byteCount += n + control;
+      busyMicros += (n + control + 1) * 9000000UL / hostClockHz;
+    } while (err == 0 && txIndex < active->txLength);
+    
+    if (err == 0 && active->rxLength) {
+      Wire.requestFrom(active->address, active->rxLength);
+      while (Wire.available() && rxIndex < active->rxLength) {
+        active->rxData[rxIndex++] = Wire.read();
+      }
+      byteCount += rxIndex;
+      busyMicros += (rxIndex + 1) * 9000000UL / hostClockHz;
+    }
+    finish(err == 0 ? TWI_OK : err == 2 ? TWI_NACK_ADDRESS : err == 3 ? TWI_NACK_DATA : TWI_BUS_ERROR);
+  }
+#endif
+  return true;
+}
+
+// Takes the next queued transfer; the caller issues the START
+void MinuxTWI::startNext() {
+  uint8_t tail = queueTail;
+  if (tail == queueHead) {
+    active = nullptr;
+    return;
+  }
+  active = queue[tail];
+  queueTail = (tail + 1) & (TWI_QUEUE_SIZE - 1);
+  txIndex = 0;
+  rxIndex = 0;
+  controlSent = (active->control == TWI_NO_CONTROL);
+  reading = false;
+  startedAt = micros();
+}
+
+void MinuxTWI::finish(uint8_t status) {
+  TwiTransfer* t = active;
+  busyMicros += micros() - startedAt;
+  transferCount++;
+  if (status != TWI_OK) errorCount++;
+  
+  t->status = status;
+  if (t->done) t->done(t);
+  
+#if defined(__AVR__)
+  // STOP, and START straight after it when more work is queued
+  startNext();
+  if (active) TWCR = TWCR_NEXT | _BV(TWSTO) | _BV(TWSTA);
+  else TWCR = _BV(TWEN) | _BV(TWINT) | _BV(TWSTO);
+#else
+  active = nullptr;
+#endif
+}
+
+void MinuxTWI::onInterrupt() {
+#if defined(__AVR__)
+  switch (TW_STATUS) {
+    case TW_START:
+      // Reads without anything to write go straight to SLA+R
+      reading = controlSent && active->txLength == 0 && active->rxLength;
+      TWDR = (active->address << 1) | (reading ? TW_READ : TW_WRITE);
+      TWCR = TWCR_NEXT;
+      break;
+      
+    case TW_REP_START:
+      reading = true;
+      TWDR = (active->address << 1) | TW_READ;
+      TWCR = TWCR_NEXT;
+      break;
+      
+    case TW_MT_SLA_ACK:
+    case TW_MT_DATA_ACK:
+      if (!controlSent) {
+        TWDR = (uint8_t)active->control;
+        controlSent = true;
+      } else if (txIndex < active->txLength) {
+        TWDR = active->txData[txIndex++];
+      } else if (active->rxLength) {
+        TWCR = TWCR_NEXT | _BV(TWSTA);
+        break;
+      } else {
+        finish(TWI_OK);
+        break;
+      }
+      byteCount++;
+      TWCR = TWCR_NEXT;
+      break;
+      
+    case TW_MR_SLA_ACK:
+      // ACK every byte but the last
+      TWCR = TWCR_NEXT | (active->rxLength > 1 ? _BV(TWEA) : 0);
+      break;
+      
+    case TW_MR_DATA_ACK:
+      active->rxData[rxIndex++] = TWDR;
+      byteCount++;
+      TWCR = TWCR_NEXT | (rxIndex + 1 < active->rxLength ? _BV(TWEA) : 0);
+      break;
+      
+    case TW_MR_DATA_NACK:
+      active->rxData[rxIndex++] = TWDR;
+      byteCount++;
+      finish(TWI_OK);
+      break;
+      
+    case TW_MT_SLA_NACK:
+    case TW_MR_SLA_NACK:
+      finish(TWI_NACK_ADDRESS);
+      break;
+      
+    case TW_MT_DATA_NACK:
+      finish(TWI_NACK_DATA);
+      break;
+      
+    case TW_MT_ARB_LOST:
+      finish(TWI_ARBITRATION);
+      break;
+      
+    default:
+      // Bus error: STOP resets the hardware state machine
+      finish(TWI_BUS_ERROR);
+      break;
+  }
+#endif
+}
+
+// Blocking helper for init sequences and one-off commands
+uint8_t MinuxTWI::write(uint8_t address, int16_t control, const uint8_t* data, uint8_t length) {
+  TwiTransfer t;
+  t.address = address;
+  t.control = control;
+  t.txData = data;
+  t.txLength = length;
+  while (!submit(&t)) {}
+  while (t.status == TWI_PENDING) {}
+  return t.status;
+}
+
+bool MinuxTWI::probe(uint8_t address) {
+  return write(address, TWI_NO_CONTROL, nullptr, 0) == TWI_OK;
+}
+
+uint8_t MinuxTWI::getUtilization() {
+  unsigned long window = millis() - statsSince;
+  if (window == 0) return 0;
+  uint8_t sreg = twiLock();
+  uint32_t busy = busyMicros;
+  twiUnlock(sreg);
+  uint32_t percent = busy / 10 / window;
+  return percent > 100 ? 100 : percent;
+}
+
+void MinuxTWI::resetStats() {
+  uint8_t sreg = twiLock();
+  busyMicros = 0;
+  byteCount = 0;
+  transferCount = 0;
+  errorCount = 0;
+  statsSince = millis();
+  twiUnlock(sreg);
+}
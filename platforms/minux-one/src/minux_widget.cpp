@@ -0,0 +1,127 @@
+#include "minux_widget.h"
+#include "minux_display.h"
+
+MinuxWidgets::MinuxWidgets(MinuxDisplay* owner) {
+  ui = owner;
+  screen = nullptr;
+  count = 0;
+  redraws = 0;
+}
+
+void MinuxWidgets::show(const Widget* widgets, uint8_t widgetCount) {
+  screen = widgets;
+  count = widgetCount < WIDGET_MAX ? widgetCount : WIDGET_MAX;
+  
+  // The caller cleared the screen, which already marked everything dirty
+  for (uint8_t i = 0; i < count; i++) {
+    Widget w;
+    memcpy_P(&w, &screen[i], sizeof(Widget));
+    shown[i] = w.source ? w.source() : 0;
+    draw(i, w, false);
+  }
+  timers.armPeriodic(&refreshTimer, WIDGET_REFRESH_MS, refreshDue, this);
+  ui->update();
+}
+
+void MinuxWidgets::hide() {
+  screen = nullptr;
+  timers.cancel(&refreshTimer);
+}
+
+void MinuxWidgets::refreshDue(void* arg) {
+  ((MinuxWidgets*)arg)->refresh();
+}
+
+void MinuxWidgets::refresh() {
+  if (!screen) return;
+  
+  uint16_t changed = 0;
+  for (uint8_t i = 0; i < count; i++) {
+    WidgetSource source = (WidgetSource)pgm_read_ptr(&screen[i].source);
+    if (!source) continue;
+    uint32_t value = source();
+    if (value != shown[i]) {
+      shown[i] = value;
+      changed |= 1 << i;
+    }
+  }
+  if (!changed) return;
+  
+#if DISPLAY_PAGE_MODE
+  // A display list cannot be drawn over in place, so the screen is
+  // re-recorded and only the widgets that changed are marked for flushing
+  ui->display->clearDisplay();
+  for (uint8_t i = 0; i < count; i++) {
+    Widget w;
+    memcpy_P(&w, &screen[i], sizeof(Widget));
+    draw(i, w, changed & (1 << i));
+  }
+#else
+  for (uint8_t i = 0; i < count; i++) {
+    if (!(changed & (1 << i))) continue;
+    Widget w;
+    memcpy_P(&w, &screen[i], sizeof(Widget));
+    draw(i, w, true);
+  }
+#endif
+  ui->update();
+}
+
+// Renders one widget; mark adds its rectangle to the display's dirty set
+void MinuxWidgets::draw(uint8_t index, const Widget& w, bool mark) {
+  TextTarget* out = ui->writer;
+  redraws++;
+  
+  switch (w.type) {
+    case WIDGET_LABEL:
+      out->setCursor(w.x, w.y);
+      out->print(w.text);
+      if (mark) ui->markText(w.x, w.y);
+      break;
+      
+    case WIDGET_VALUE: {
+      // Opaque and padded, so a shorter number wipes the old digits
+      out->setTextColor(SSD1306_WHITE, SSD1306_BLACK);
+      out->setCursor(w.x, w.y);
+      uint8_t n = out->print(shown[index]);
+      while (n < w.width) n += out->print(' ');
+      out->setTextColor(SSD1306_WHITE);
+      if (mark) ui->markDirty(w.x, w.y, w.width * 6, 8);
+      break;
+    }
+    
+    case WIDGET_LIST:
+#if !DISPLAY_PAGE_MODE
+      ui->display->fillRect(w.x, w.y, SCREEN_WIDTH - w.x, w.width * 8, SSD1306_BLACK);
+#endif
+      for (uint8_t r = 0; r < w.width; r++) {
+        out->setCursor(w.x, w.y + r * 8);
+        w.row(r, *out);
+      }
+      if (mark) ui->markDirty(w.x, w.y, SCREEN_WIDTH - w.x, w.width * 8);
+      break;
+      
+    case WIDGET_ICON:
+      ui->display->drawBitmap(w.x, w.y, icons[w.width], 8, 8, SSD1306_WHITE);
+      if (mark) ui->markDirty(w.x, w.y, 8, 8);
+      break;
+      
+    case WIDGET_GRID:
+#if DISPLAY_PAGE_MODE
+      ui->display->drawGrid(w.width, SSD1306_WHITE);
+#else
+      for (uint8_t x = 0; x < SCREEN_WIDTH; x += w.width) {
+        for (uint8_t y = 0; y < SCREEN_HEIGHT; y += w.width) {
+          ui->display->drawPixel(x, y, SSD1306_WHITE);
+        }
+      }
+#endif
+      if (mark) ui->markDirty(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
+      break;
+      
+    case WIDGET_TASKBAR:
+      ui->paintTaskbar(w.y);
+      if (mark) ui->markDirty(0, w.y, SCREEN_WIDTH, 8);
+      break;
+  }
+}
@@ -0,0 +1,164 @@
+#!/usr/bin/env python3
+"""Decodes a `trace dump` capture into Chrome trace-event JSON.
+
+Usage:
+  tools/trace_decode.py capture.bin [-o trace.json]
+  tools/trace_decode.py --port /dev/ttyUSB0 [--baud 115200] [-o trace.json]
+
+The capture may have console text around the dump; decoding starts at the
+"MTRC" header. With --port the dump is requested over serial (needs
+pyserial). Open the result in chrome://tracing or ui.perfetto.dev.
+
+Event ids and names are read from include/minux_trace.h and
+include/minux_input.h, so they stay in step with the firmware.
+"""
+
+import argparse
+import json
+import os
+import re
+import struct
+import sys
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..")
+HEADER = struct.Struct("<4sBBHHH")
+RECORD = struct.Struct("<HBB")
+
+# Chrome trace tracks (tid); tasks get one each from TASK_TRACK up
+TRACKS = {"flush": 2, "fs": 3, "input": 4}
+TASK_TRACK = 10
+
+
+def read_source(name):
+    with open(os.path.join(ROOT, "include", name)) as f:
+        return f.read()
+
+
+def enum_names(source, enum, prefix):
+    body = re.search(r"enum %s \{(.*?)\};" % enum, source, re.S).group(1)
+    names = re.findall(r"^\s*(\w+)", body, re.M)
+    return [n[len(prefix):].lower() if n.startswith(prefix) else n for n in names]
+
+
+def load_events():
+    source = read_source("minux_trace.h")
+    events = re.findall(r"X\((\w+),\s*\"(\w+)\",\s*'(\w)'\)", source)
+    fs_ops = enum_names(source, "TraceFsOp", "TRACE_FS_")
+    inputs = enum_names(read_source("minux_input.h"), "InputEvent", "EVENT_")
+    return events, fs_ops, inputs
+
+
+def capture_serial(port, baud):
+    import serial  # pyserial, only needed here
+
+    with serial.Serial(port, baud, timeout=2) as link:
+        link.reset_input_buffer()
+        link.write(b"trace dump\n")
+        data = b""
+        while True:
+            chunk = link.read(512)
+            if not chunk:
+                return data
+            data += chunk
+
+
+def decode(data):
+    start = data.find(b"MTRC")
+    if start < 0 or len(data) < start + HEADER.size:
+        sys.exit("no trace dump in capture")
+    magic, version, shift, count, overwritten, last_epoch = HEADER.unpack_from(data, start)
+    if version != 1:
+        sys.exit("unsupported trace version %d" % version)
+    body = start + HEADER.size
+    if len(data) < body + count * RECORD.size:
+        sys.exit("capture truncated: %d of %d records" % ((len(data) - body) // RECORD.size, count))
+    records = [RECORD.unpack_from(data, body + i * RECORD.size) for i in range(count)]
+
+    events, fs_ops, inputs = load_events()
+    epoch_id = [e[0] for e in events].index("EPOCH")
+
+    # Records before the first surviving EPOCH belong to the epoch it moved from
+    epoch = last_epoch
+    for time, event, arg in records:
+        if event == epoch_id:
+            epoch = time - arg
+            break
+
+    out = []
+    depth = {}
+    tasks = set()
+    for time, event, arg in records:
+        if event >= len(events):
+            continue
+        ident, name, phase = events[event]
+        if phase == "M":
+            epoch = time
+            continue
+        ts = ((epoch << 16) | time) << shift
+
+        if name == "task":
+            tid = TASK_TRACK + arg
+            label = "task %d" % arg
+            tasks.add(arg)
+        elif name == "fs":
+            tid = TRACKS["fs"]
+            label = "fs." + (fs_ops[arg] if arg < len(fs_ops) else str(arg))
+        elif name == "input":
+            tid = TRACKS["input"]
+            label = inputs[arg] if arg < len(inputs) else str(arg)
+        else:
+            tid = TRACKS.get(name, 1)
+            label = name
+
+        # An end whose begin was overwritten has nothing to close
+        if phase == "E":
+            if not depth.get(tid):
+                continue
+            depth[tid] -= 1
+        elif phase == "B":
+            depth[tid] = depth.get(tid, 0) + 1
+
+        entry = {"name": label, "ph": phase, "ts": ts, "pid": 1, "tid": tid}
+        if phase == "i":
+            entry["s"] = "t"
+        out.append(entry)
+
+    names = dict((tid, name) for name, tid in TRACKS.items())
+    names.update((TASK_TRACK + t, "task %d" % t) for t in tasks)
+    for tid, name in sorted(names.items()):
+        out.append({"name": "thread_name", "ph": "M", "pid": 1, "tid": tid, "args": {"name": name}})
+
+    return {
+        "traceEvents": out,
+        "displayTimeUnit": "ms",
+        "otherData": {"records": count, "overwritten": overwritten},
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode a Minux trace dump")
+    parser.add_argument("capture", nargs="?", help="binary capture of `trace dump`")
+    parser.add_argument("--port", help="request the dump from this serial port")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("-o", "--output", help="JSON output, stdout by default")
+    args = parser.parse_args()
+
+    if args.port:
+        data = capture_serial(args.port, args.baud)
+    elif args.capture:
+        with open(args.capture, "rb") as f:
+            data = f.read()
+    else:
+        parser.error("need a capture file or --port")
+
+    result = decode(data)
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump(result, f, indent=1)
+    else:
+        json.dump(result, sys.stdout, indent=1)
+        sys.stdout.write("\n")
+
+
+if __name__ == "__main__":
+    main()